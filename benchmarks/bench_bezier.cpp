@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "system/bezierSolver.hpp"
+
+constexpr std::size_t const CURVES_NUM = 64;
+constexpr std::size_t const TEMPS_NUM = 256;
+
+namespace {
+
+auto randomCurves() -> std::vector<sys::ControlPoints> {
+    std::mt19937 rng(42);  // NOLINT
+    std::uniform_real_distribution<double> dist(0.0, 100.0);
+    std::vector<sys::ControlPoints> curves;
+
+    for (std::size_t i = 0; i < CURVES_NUM; i++) {
+        std::array<double, 4> xs{0.0, dist(rng), dist(rng), 100.0};
+        std::sort(xs.begin(), xs.end());
+        curves.push_back({std::make_pair(xs[0], dist(rng)),
+                          std::make_pair(xs[1], dist(rng)),
+                          std::make_pair(xs[2], dist(rng)),
+                          std::make_pair(xs[3], dist(rng))});
+    }
+    return curves;
+}
+
+auto randomTemps() -> std::vector<double> {
+    std::mt19937 rng(7);  // NOLINT
+    std::uniform_real_distribution<double> dist(0.0, 100.0);
+    std::vector<double> temps(TEMPS_NUM);
+    std::generate(temps.begin(), temps.end(), [&] { return dist(rng); });
+    return temps;
+}
+
+}  // namespace
+
+BENCHMARK(BezierBisection) {
+    auto curves = randomCurves();
+    auto temps = randomTemps();
+    std::size_t i = 0;
+
+    while (state.keepRunning()) {
+        bench::doNotOptimize(sys::BezierSolver::bisect(
+            curves[i % CURVES_NUM], temps[i % TEMPS_NUM]));
+        i++;
+    }
+}
+
+BENCHMARK(BezierNewtonSeeded) {
+    auto curves = randomCurves();
+    auto temps = randomTemps();
+    std::vector<sys::BezierSolver> solvers(curves.begin(), curves.end());
+    std::size_t i = 0;
+
+    while (state.keepRunning()) {
+        bench::doNotOptimize(
+            solvers[i % CURVES_NUM].speedForTemp(temps[i % TEMPS_NUM]));
+        i++;
+    }
+}
@@ -0,0 +1,131 @@
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "core/colorKernels.hpp"
+#include "core/commands/rainbowSpinCommand.hpp"
+#include "core/commands/staticColorCommand.hpp"
+#include "core/tripleBuffer.hpp"
+#include "system/colorBuffer.hpp"
+
+// Two dozen fans of 54 LEDs
+constexpr std::size_t const COLOR_LEDS_NUM = 24 * 54;
+// Six fully populated controllers
+constexpr std::size_t const COLOR_CONTROLLERS_NUM = 6;
+constexpr std::size_t const COLOR_FANS_NUM = 5;
+constexpr std::size_t const COLOR_FAN_LEDS = 54;
+
+namespace {
+
+auto gradient() -> std::vector<sys::LedColor> {
+    std::vector<sys::LedColor> leds(COLOR_LEDS_NUM);
+    for (std::size_t i = 0; i < leds.size(); i++) {
+        leds[i] = {static_cast<uint8_t>(i), static_cast<uint8_t>(i * 3),
+                   static_cast<uint8_t>(i * 7)};
+    }
+    return leds;
+}
+
+void blend(bench::State& state, core::ColorKernels const& kernels) {
+    auto from = gradient();
+    std::vector<sys::LedColor> to(COLOR_LEDS_NUM, {0, 0, 255});  // NOLINT
+    std::vector<sys::LedColor> out(COLOR_LEDS_NUM);
+    uint16_t weight = 0;
+
+    while (state.keepRunning()) {
+        kernels.blend(from, to, weight, out);
+        bench::doNotOptimize(out.front());
+        weight = (weight + 1) % core::BLEND_ONE;
+    }
+}
+
+void gamma(bench::State& state, core::ColorKernels const& kernels) {
+    auto leds = gradient();
+    auto source = leds;
+
+    while (state.keepRunning()) {
+        kernels.gamma(leds);
+        bench::doNotOptimize(leds.front());
+        leds = source;
+    }
+}
+
+void hsv(bench::State& state, core::ColorKernels const& kernels) {
+    std::vector<uint16_t> hues(COLOR_LEDS_NUM);
+    std::vector<sys::LedColor> out(COLOR_LEDS_NUM);
+    uint16_t first = 0;
+
+    while (state.keepRunning()) {
+        for (std::size_t i = 0; i < hues.size(); i++) {
+            hues[i] = static_cast<uint16_t>(first + i * 97);  // NOLINT
+        }
+        kernels.hsvToGrb(hues, 255, 255, out);  // NOLINT
+        bench::doNotOptimize(out.front());
+        first += 331;  // NOLINT
+    }
+}
+
+// One benchmark per kernel and instruction set this CPU runs
+bool const kernels_registered = [] {
+    std::pair<char const*, core::KernelIsa> const isas[] = {  // NOLINT
+        {"Scalar", core::KernelIsa::SCALAR},
+        {"Sse2", core::KernelIsa::SSE2},
+        {"Avx2", core::KernelIsa::AVX2}};
+    for (auto const& [suffix, isa] : isas) {
+        if (!core::kernelsSupported(isa)) {
+            continue;
+        }
+        auto const& kernels = core::colorKernels(isa);
+        auto& registry = bench::Registry::get();
+        registry.add(std::string("ColorBlend") + suffix,
+                     [&kernels](bench::State& s) { blend(s, kernels); });
+        registry.add(std::string("ColorGamma") + suffix,
+                     [&kernels](bench::State& s) { gamma(s, kernels); });
+        registry.add(std::string("ColorHsv") + suffix,
+                     [&kernels](bench::State& s) { hsv(s, kernels); });
+    }
+    return true;
+}();
+
+}  // namespace
+
+// A per-LED frame of the spin at 60 fps on the best kernels
+BENCHMARK(EffectFrameSpin) {
+    core::RainbowSpinCommand spin(std::chrono::seconds(2));
+    sys::ColorBuffer frame(COLOR_CONTROLLERS_NUM, COLOR_FANS_NUM,
+                           COLOR_FAN_LEDS);
+
+    while (state.keepRunning()) {
+        spin.render(std::chrono::milliseconds(16), frame);  // NOLINT
+        bench::doNotOptimize(frame(0, 0, 0));
+    }
+}
+
+// A single color effect filling the same frame
+BENCHMARK(EffectFrameFill) {
+    core::StaticColorCommand color(255, 0, 0, std::chrono::hours(24));  // NOLINT
+    sys::ColorBuffer frame(COLOR_CONTROLLERS_NUM, COLOR_FANS_NUM,
+                           COLOR_FAN_LEDS);
+
+    while (state.keepRunning()) {
+        color.render(std::chrono::milliseconds(16), frame);  // NOLINT
+        bench::doNotOptimize(frame(0, 0, 0));
+    }
+}
+
+// The frame on its way from the effects thread to the RGB thread
+BENCHMARK(EffectFrameHandoff) {
+    sys::ColorBuffer frame(COLOR_CONTROLLERS_NUM, COLOR_FANS_NUM,
+                           COLOR_FAN_LEDS);
+    core::TripleBuffer<sys::ColorBuffer> frames(frame);
+
+    while (state.keepRunning()) {
+        frames.back() = frame;
+        frames.publish();
+        frames.update();
+        bench::doNotOptimize(frames.front()(0, 0, 0));
+    }
+}
@@ -0,0 +1,62 @@
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <string>
+
+#include "benchmark.hpp"
+#include "system/systemBuilder.hpp"
+
+constexpr std::size_t const CONFIG_CONTROLLERS_NUM = 2;
+constexpr std::size_t const CONFIG_FANS_NUM = 5;
+constexpr std::size_t const CONFIG_POINTS_NUM = 21;
+
+namespace {
+
+// A saved config for CONFIG_CONTROLLERS_NUM full controllers, as the GUI
+// writes it
+struct FakeConfigFile {
+    FakeConfigFile()
+        : path(std::filesystem::temp_directory_path() /
+               ("bench_config_" + std::to_string(::getpid()) + ".toml")) {
+        std::ofstream out(path);
+        out << std::fixed << std::setprecision(1) << "saved = [\n";
+        for (std::size_t c = 0; c < CONFIG_CONTROLLERS_NUM; c++) {
+            out << "  [\n";
+            for (std::size_t f = 0; f < CONFIG_FANS_NUM; f++) {
+                out << "    { 'Control points' = [ { x = 0.0, y = 0.0 }, "
+                       "{ x = 40.0, y = 60.0 }, { x = 60.0, y = 40.0 }, "
+                       "{ x = 100.0, y = 100.0 } ], Monitoring = "
+                    << f % 2 << ", Speeds = [";
+                for (std::size_t p = 0; p < CONFIG_POINTS_NUM; p++) {
+                    out << (p == 0 ? "" : ", ") << 30.0 + p * 3.0;  // NOLINT
+                }
+                out << "], Temps = [";
+                for (std::size_t p = 0; p < CONFIG_POINTS_NUM; p++) {
+                    out << (p == 0 ? "" : ", ") << p * 5.0;  // NOLINT
+                }
+                out << "] },\n";
+            }
+            out << "  ],\n";
+        }
+        out << "]\n";
+    }
+    ~FakeConfigFile() { std::filesystem::remove(path); }
+    FakeConfigFile(FakeConfigFile const&) = delete;
+    FakeConfigFile& operator=(FakeConfigFile const&) = delete;
+
+    std::filesystem::path path;
+};
+
+}  // namespace
+
+BENCHMARK(SystemBuilderBuildFromFile) {
+    FakeConfigFile file;
+    std::string path = file.path.string();
+
+    while (state.keepRunning()) {
+        bench::doNotOptimize(
+            sys::SystemBuilder().buildFromFile(path, CONFIG_CONTROLLERS_NUM));
+    }
+}
@@ -0,0 +1,60 @@
+#include <random>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "system/controllerData.hpp"
+
+constexpr std::size_t const CURVE_TEMPS_NUM = 256;
+
+namespace {
+
+// Temperatures as the sensors report them, tenths of a degree
+auto sensorTemps() -> std::vector<float> {
+    std::mt19937 rng(7);  // NOLINT
+    std::uniform_int_distribution<int> dist(200, 950);
+    std::vector<float> temps(CURVE_TEMPS_NUM);
+    for (auto& t : temps) {
+        t = static_cast<float>(dist(rng)) / 10.0F;  // NOLINT
+    }
+    return temps;
+}
+
+}  // namespace
+
+BENCHMARK(FanSpeedDataGetSpeed) {
+    auto temps = sensorTemps();
+    sys::FanSpeedData data({0, 30, 50, 70, 90, 100},  // NOLINT
+                           {20, 30, 45, 70, 90, 100});
+    std::size_t i = 0;
+
+    while (state.keepRunning()) {
+        bench::doNotOptimize(data.getSpeedForTemp(temps[i % CURVE_TEMPS_NUM]));
+        i++;
+    }
+}
+
+BENCHMARK(FanBezierDataGetSpeed) {
+    auto temps = sensorTemps();
+    sys::FanBezierData data({std::make_pair(0.0, 0.0),  // NOLINT
+                             std::make_pair(40.0, 60.0),
+                             std::make_pair(60.0, 40.0),
+                             std::make_pair(100.0, 100.0)});
+    std::size_t i = 0;
+
+    while (state.keepRunning()) {
+        bench::doNotOptimize(data.getSpeedForTemp(temps[i % CURVE_TEMPS_NUM]));
+        i++;
+    }
+}
+
+// The first call after an edit in the GUI, which rebuilds the lookup table
+BENCHMARK(FanSpeedDataRebuild) {
+    std::vector<double> temps{0, 30, 50, 70, 90, 100};    // NOLINT
+    std::vector<double> speeds{20, 30, 45, 70, 90, 100};  // NOLINT
+    sys::FanSpeedData data;
+
+    while (state.keepRunning()) {
+        data.updateData(temps, speeds);
+        bench::doNotOptimize(data.getSpeedForTemp(55.5F));  // NOLINT
+    }
+}
@@ -0,0 +1,193 @@
+#include <array>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "core/commands/compositeCommand.hpp"
+#include "core/commands/fadeCommand.hpp"
+#include "core/commands/fadeInCommand.hpp"
+#include "core/commands/fadeOutComand.hpp"
+#include "core/commands/rainbowColorCommand.hpp"
+#include "core/commands/rainbowColorFadeCommand.hpp"
+#include "core/commands/staticColorCommand.hpp"
+#include "core/effect.hpp"
+#include "core/effectsEngine.hpp"
+#include "core/valueEffectsEngine.hpp"
+
+// One RGB frame of the effects thread
+constexpr std::chrono::milliseconds const EFFECT_STEP =
+    std::chrono::milliseconds(1);
+// Long enough that no effect finishes while it is measured
+constexpr std::chrono::hours const EFFECT_DURATION = std::chrono::hours(24);
+// Every LED of four fully populated controllers running its own effect
+constexpr std::size_t const EFFECT_LEDS_NUM = 4 * 5 * 54;
+constexpr std::size_t const EFFECT_KINDS_NUM = 5;
+
+namespace {
+
+// The same mix of effects in both designs, a composite nests another one
+auto makeCommand(std::size_t kind) -> std::unique_ptr<core::EffectCommand> {
+    switch (kind) {
+        case 0:
+            return std::make_unique<core::StaticColorCommand>(
+                255, 0, 0, EFFECT_DURATION);  // NOLINT
+        case 1:
+            return std::make_unique<core::FadeCommand>(
+                std::array<uint8_t, 3>{255, 0, 0},  // NOLINT
+                std::array<uint8_t, 3>{0, 0, 255},  // NOLINT
+                EFFECT_DURATION);
+        case 2:
+            return std::make_unique<core::RainbowColorCommand>(
+                std::chrono::milliseconds(200));  // NOLINT
+        case 3:
+            return std::make_unique<core::RainbowColorFadeCommand>(
+                std::chrono::milliseconds(200));  // NOLINT
+        default: {
+            auto inner = std::make_unique<core::CompositeCommand>();
+            inner->addCommand(std::make_unique<core::RainbowColorCommand>(
+                std::chrono::milliseconds(200)));  // NOLINT
+            auto composite = std::make_unique<core::CompositeCommand>();
+            composite->addCommand(std::make_unique<core::StaticColorCommand>(
+                0, 255, 0, std::chrono::milliseconds(100)));  // NOLINT
+            composite->addCommand(std::move(inner));
+            return composite;
+        }
+    }
+}
+
+auto makeEffect(std::size_t kind) -> core::Effect {
+    switch (kind) {
+        case 0:
+            return core::StaticEffect({255, 0, 0},  // NOLINT
+                                      EFFECT_DURATION);
+        case 1:
+            return core::FadeEffect({255, 0, 0}, {0, 0, 255},  // NOLINT
+                                    EFFECT_DURATION);
+        case 2:
+            return core::RainbowEffect(std::chrono::milliseconds(200));
+        case 3:
+            return core::RainbowFadeEffect(std::chrono::milliseconds(200));
+        default: {
+            core::CompositeEffect inner;
+            inner.addEffect(
+                core::RainbowEffect(std::chrono::milliseconds(200)));
+            core::CompositeEffect composite;
+            composite.addEffect(core::StaticEffect(
+                {0, 255, 0}, std::chrono::milliseconds(100)));  // NOLINT
+            composite.addEffect(std::move(inner));
+            return composite;
+        }
+    }
+}
+
+void runEffect(bench::State& state,
+               std::unique_ptr<core::EffectCommand> effect) {
+    core::EffectsEngine engine;
+    engine.addEffect(std::move(effect));
+    engine.setActiveEffect(0);
+
+    while (state.keepRunning()) {
+        bench::doNotOptimize(engine.update(EFFECT_STEP));
+    }
+}
+
+}  // namespace
+
+BENCHMARK(EffectStaticColor) {
+    runEffect(state, std::make_unique<core::StaticColorCommand>(
+                         255, 0, 0, EFFECT_DURATION));  // NOLINT
+}
+
+BENCHMARK(EffectFade) {
+    runEffect(state, std::make_unique<core::FadeCommand>(
+                         std::array<uint8_t, 3>{255, 0, 0},  // NOLINT
+                         std::array<uint8_t, 3>{0, 0, 255},  // NOLINT
+                         EFFECT_DURATION));
+}
+
+BENCHMARK(EffectFadeIn) {
+    runEffect(state, std::make_unique<core::FadeInCommand>(
+                         std::array<uint8_t, 3>{0, 255, 0},  // NOLINT
+                         EFFECT_DURATION));
+}
+
+BENCHMARK(EffectFadeOut) {
+    runEffect(state, std::make_unique<core::FadeOutCommand>(
+                         std::array<uint8_t, 3>{0, 255, 0},  // NOLINT
+                         EFFECT_DURATION));
+}
+
+BENCHMARK(EffectRainbowColor) {
+    runEffect(state, std::make_unique<core::RainbowColorCommand>(
+                         std::chrono::seconds(2)));
+}
+
+BENCHMARK(EffectRainbowColorFade) {
+    runEffect(state, std::make_unique<core::RainbowColorFadeCommand>(
+                         std::chrono::seconds(2)));
+}
+
+BENCHMARK(EffectComposite) {
+    auto composite = std::make_unique<core::CompositeCommand>();
+    composite->addCommand(std::make_unique<core::StaticColorCommand>(
+        255, 0, 0, EFFECT_DURATION));  // NOLINT
+    composite->addCommand(std::make_unique<core::StaticColorCommand>(
+        0, 255, 0, EFFECT_DURATION));  // NOLINT
+    runEffect(state, std::move(composite));
+}
+
+// A color or duration change from the GUI replaces the active effect
+BENCHMARK(EffectReconfigure) {
+    core::EffectsEngine engine;
+    engine.addEffect(std::make_unique<core::RainbowColorFadeCommand>(
+        std::chrono::seconds(2)));
+    engine.setActiveEffect(0);
+
+    while (state.keepRunning()) {
+        engine.updateActiveEffect({0, 0, 255}, std::chrono::seconds(2));
+        bench::doNotOptimize(engine.update(EFFECT_STEP));
+    }
+}
+
+// One frame for EFFECT_LEDS_NUM LEDs, each with its own effect: a vector of
+// pointers to commands against one contiguous vector of variants
+BENCHMARK(EffectFrameVirtual) {
+    std::vector<std::unique_ptr<core::EffectCommand>> effects;
+    for (std::size_t i = 0; i < EFFECT_LEDS_NUM; i++) {
+        effects.push_back(makeCommand(i % EFFECT_KINDS_NUM));
+    }
+    std::vector<std::array<uint8_t, 3>> frame(EFFECT_LEDS_NUM);
+
+    while (state.keepRunning()) {
+        for (std::size_t i = 0; i < EFFECT_LEDS_NUM; i++) {
+            frame[i] = effects[i]->execute(EFFECT_STEP);
+        }
+        bench::doNotOptimize(frame.data());
+    }
+}
+
+BENCHMARK(EffectFrameVariant) {
+    std::vector<core::Effect> effects;
+    for (std::size_t i = 0; i < EFFECT_LEDS_NUM; i++) {
+        effects.push_back(makeEffect(i % EFFECT_KINDS_NUM));
+    }
+    std::vector<std::array<uint8_t, 3>> frame(EFFECT_LEDS_NUM);
+
+    while (state.keepRunning()) {
+        for (std::size_t i = 0; i < EFFECT_LEDS_NUM; i++) {
+            frame[i] = effects[i].execute(EFFECT_STEP);
+        }
+        bench::doNotOptimize(frame.data());
+    }
+}
+
+BENCHMARK(EffectEngineVariantRainbowFade) {
+    core::ValueEffectsEngine engine;
+    engine.addEffect(core::RainbowFadeEffect(std::chrono::seconds(2)));
+    engine.setActiveEffect(0);
+
+    while (state.keepRunning()) {
+        bench::doNotOptimize(engine.update(EFFECT_STEP));
+    }
+}
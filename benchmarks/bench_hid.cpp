@@ -0,0 +1,63 @@
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "benchmark.hpp"
+#include "system/controllers/ttRiingQuadController.hpp"
+#include "system/hidapi.hpp"
+
+namespace {
+
+// Accepts every report without touching a device, so sendRequest() is
+// measured down to the point where hid_write would be called
+class NullHidApi : public sys::HidApi {
+   public:
+    NullHidApi() : HidApi(NoInit{}) {}
+
+   protected:
+    hid_device* openDevicePath(char const* /*path*/) override {
+        return reinterpret_cast<hid_device*>(&report);  // NOLINT
+    }
+    void closeDevice(hid_device* /*dev*/) override {}
+    int writeReport(hid_device* /*dev*/, unsigned char const* data,
+                    std::size_t length) override {
+        report = data[3];  // NOLINT
+        return static_cast<int>(length);
+    }
+
+   private:
+    unsigned char report = 0;
+};
+
+}  // namespace
+
+BENCHMARK(HidSendSpeedRequest) {
+    NullHidApi hidapi;
+    auto dev = hidapi.makeDevice<THERMALTAKE_VENDOR_ID>("bench");
+    unsigned char fan = 0;
+
+    while (state.keepRunning()) {
+        hidapi.sendRequest<TT_RIING_QUAD_PACKET_SIZE>(
+            dev, sys::PROTOCOL_START_BYTE, sys::PROTOCOL_SET,
+            sys::PROTOCOL_FAN, static_cast<unsigned char>(fan % 5 + 1),
+            sys::PROTOCOL_FAN_MODE_FIXED, static_cast<unsigned char>(fan));
+        fan++;
+    }
+}
+
+BENCHMARK(HidSendColorRequest) {
+    NullHidApi hidapi;
+    auto dev = hidapi.makeDevice<THERMALTAKE_VENDOR_ID>("bench");
+    // The LEDs of one fan, passed as the span the controller sends
+    std::array<sys::LedColor, TT_RIING_QUAD_NUM_LEDS> colors{};
+    unsigned char fan = 0;
+
+    while (state.keepRunning()) {
+        colors[0][0] = fan;
+        hidapi.sendRequest<TT_RIING_QUAD_PACKET_SIZE>(
+            dev, sys::PROTOCOL_START_BYTE, sys::PROTOCOL_SET,
+            sys::PROTOCOL_LIGHT, static_cast<unsigned char>(fan % 5 + 1),
+            sys::PROTOCOL_PER_LED, std::span<sys::LedColor const>(colors));
+        fan++;
+    }
+}
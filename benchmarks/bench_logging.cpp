@@ -0,0 +1,128 @@
+#include <array>
+#include <cmath>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "core/effectsEngine.hpp"
+#include "core/fanController.hpp"
+#include "core/logger.hpp"
+#include "system/controllerData.hpp"
+#include "system/deviceController.hpp"
+
+constexpr std::size_t const FANS_NUM = 5;
+constexpr std::size_t const NULL_DEVICE_LEDS = 54;
+constexpr float const TICK_TEMP = 55.5F;
+
+namespace {
+
+// Swallows every command so only the tick itself is measured
+class NullDevice : public sys::DeviceController {
+   public:
+    sys::ColorBuffer makeColorBuffer() override {
+        return {1, FANS_NUM, NULL_DEVICE_LEDS};
+    }
+    std::size_t controllersNum() override { return 1; }
+    std::size_t channelsNum() override { return FANS_NUM; }
+    void queueFanSpeed(std::size_t /*controller_idx*/, std::size_t fan_idx,
+                       uint value) override {
+        bench::doNotOptimize(fan_idx + value);
+    }
+    void queueFanStatus(std::size_t /*controller_idx*/,
+                        std::size_t /*fan_idx*/) override {}
+    bool queueRGB(std::size_t /*controller_idx*/, std::size_t /*fan_idx*/,
+                  std::span<sys::LedColor const> /*colors*/) override {
+        return true;
+    }
+    uint64_t colorDrops(std::size_t /*controller_idx*/,
+                        std::size_t /*fan_idx*/) override {
+        return 0;
+    }
+    void flush(std::size_t /*controller_idx*/) override {}
+    std::size_t queueDepth(std::size_t /*controller_idx*/) override {
+        return 0;
+    }
+    void setStatusHandler(StatusHandler /*handler*/) override {}
+};
+
+auto makeSystem() -> std::shared_ptr<sys::System> {
+    auto system = std::make_shared<sys::System>();
+    sys::Controller controller;
+    controller.setIdx(0);
+    for (std::size_t i = 0; i < FANS_NUM; i++) {
+        sys::Fan fan;
+        fan.setIdx(i);
+        fan.addData(sys::FanSpeedData({0, 30, 50, 70, 90, 100},  // NOLINT
+                                      {20, 30, 45, 70, 90, 100}));
+        controller.addFan(fan);
+    }
+    system->addController(controller);
+    return system;
+}
+
+}  // namespace
+
+// updateFans() without any log statement, the reference for the two below
+BENCHMARK(FanTickBare) {
+    auto system = makeSystem();
+    std::shared_ptr<sys::DeviceController> device =
+        std::make_shared<NullDevice>();
+
+    while (state.keepRunning()) {
+        for (auto&& c : system->getControllers()) {
+            for (auto&& f : c.getFans()) {
+                if (f.getMonitoringMode() !=
+                    sys::MonitoringMode::MONITORING_CPU) {
+                    continue;
+                }
+                double s = f.getData().getSpeedForTemp(TICK_TEMP);
+                device->queueFanSpeed(c.getIdx(), f.getIdx() + 1,
+                                      static_cast<uint>(s));
+            }
+            device->flush(c.getIdx());
+        }
+    }
+}
+
+BENCHMARK(FanTickLoggingDisabled) {
+    core::Logger::log.setModuleLevel(core::LogModule::CORE,
+                                     core::LogLevel::ERROR);
+    core::FanController fc(makeSystem(), std::make_shared<NullDevice>(),
+                           std::make_unique<core::EffectsEngine>(), false);
+
+    while (state.keepRunning()) {
+        fc.updateCPUfans(TICK_TEMP);
+    }
+    core::Logger::log.setModuleLevel(core::LogModule::CORE,
+                                     core::COMPILED_LOG_LEVEL);
+}
+
+// The tick as it was before LOG_INFO: the message was formatted on every
+// call and only then handed to a logger that discarded it
+BENCHMARK(FanTickEagerFormat) {
+    auto system = makeSystem();
+    std::shared_ptr<sys::DeviceController> device =
+        std::make_shared<NullDevice>();
+
+    while (state.keepRunning()) {
+        std::ostringstream log_str;
+        for (auto&& c : system->getControllers()) {
+            for (auto&& f : c.getFans()) {
+                if (f.getMonitoringMode() !=
+                    sys::MonitoringMode::MONITORING_CPU) {
+                    continue;
+                }
+                double s = f.getData().getSpeedForTemp(TICK_TEMP);
+                device->queueFanSpeed(c.getIdx(), f.getIdx() + 1,
+                                      static_cast<uint>(s));
+                log_str << "Mode " << false << " Controller " << c.getIdx()
+                        << " Fan " << f.getIdx() << " set speed " << s
+                        << " on temp " << TICK_TEMP << '\n';
+            }
+            device->flush(c.getIdx());
+        }
+        bench::doNotOptimize(log_str.str());
+    }
+}
@@ -0,0 +1,66 @@
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "benchmark.hpp"
+#include "core/effectsEngine.hpp"
+#include "core/fanController.hpp"
+#include "system/controllerData.hpp"
+#include "system/controllers/simulatedRiingQuad.hpp"
+#include "system/controllers/ttRiingQuadController.hpp"
+
+constexpr std::size_t const PIPELINE_CONTROLLERS_NUM = 2;
+
+namespace {
+
+// A device that answers at once, so the tick is measured through the real
+// controller, its worker thread and the HID layer without USB latency
+auto instantProfile() -> sys::SimulationProfile {
+    sys::SimulationProfile profile;
+    profile.write_latency = std::chrono::microseconds(0);
+    profile.response_latency = std::chrono::microseconds(0);
+    profile.latency_jitter = std::chrono::microseconds(0);
+    return profile;
+}
+
+auto makePipelineSystem() -> std::shared_ptr<sys::System> {
+    auto system = std::make_shared<sys::System>();
+    for (std::size_t c = 0; c < PIPELINE_CONTROLLERS_NUM; c++) {
+        sys::Controller controller;
+        controller.setIdx(c);
+        for (std::size_t i = 0; i < TT_RIING_QUAD_NUM_CHANNELS; i++) {
+            sys::Fan fan;
+            fan.setIdx(i);
+            fan.addData(sys::FanSpeedData({0, 30, 50, 70, 90, 100},  // NOLINT
+                                          {20, 30, 45, 70, 90, 100}));
+            controller.addFan(fan);
+        }
+        system->addController(controller);
+    }
+    return system;
+}
+
+}  // namespace
+
+// From the temperature reading to the last response of the tick: curve
+// lookups, queueing, the worker batch and one write/read per fan
+BENCHMARK(FanTickSimulatedDevice) {
+    auto device = std::make_shared<sys::TTRiingQuadController>(
+        std::make_unique<sys::SimulatedHidApi>(PIPELINE_CONTROLLERS_NUM,
+                                               instantProfile()));
+    core::FanController fc(makePipelineSystem(), device,
+                           std::make_unique<core::EffectsEngine>(), false);
+    std::size_t expected = 0;
+    bool hot = false;
+
+    while (state.keepRunning()) {
+        fc.updateCPUfans(hot ? 70.0F : 40.0F);  // NOLINT
+        hot = !hot;
+        expected += TT_RIING_QUAD_NUM_CHANNELS;
+        for (std::size_t c = 0; c < PIPELINE_CONTROLLERS_NUM; c++) {
+            while (device->roundTrip(c).count() < expected) {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
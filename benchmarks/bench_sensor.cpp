@@ -0,0 +1,51 @@
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "benchmark.hpp"
+#include "system/sensorReader.hpp"
+
+namespace {
+
+// Regular file standing in for a hwmon tempN_input attribute
+struct FakeSensorFile {
+    FakeSensorFile()
+        : path(std::filesystem::temp_directory_path() /
+               ("bench_sensor_" + std::to_string(::getpid()))) {
+        std::ofstream out(path);
+        out << "45000\n";
+    }
+    ~FakeSensorFile() { std::filesystem::remove(path); }
+    FakeSensorFile(FakeSensorFile const&) = delete;
+    FakeSensorFile& operator=(FakeSensorFile const&) = delete;
+
+    std::filesystem::path path;
+};
+
+}  // namespace
+
+BENCHMARK(SensorReadIfstream) {
+    FakeSensorFile file;
+    std::ifstream in(file.path);
+
+    while (state.keepRunning()) {
+        in.clear();
+        in.seekg(0, std::ios::beg);
+        int value = 0;
+        in >> value;
+        bench::doNotOptimize(value);
+    }
+}
+
+BENCHMARK(SensorReadPread) {
+    FakeSensorFile file;
+    sys::SensorReader reader(file.path);
+
+    while (state.keepRunning()) {
+        long value = 0;
+        reader.readInt(value);
+        bench::doNotOptimize(value);
+    }
+}
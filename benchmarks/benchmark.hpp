@@ -0,0 +1,107 @@
+#ifndef __BENCHMARK_HPP__
+#define __BENCHMARK_HPP__
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+constexpr std::chrono::milliseconds const MIN_BENCH_TIME =
+    std::chrono::milliseconds(200);
+
+// Passed to every benchmark body. The body runs its measured code while
+// keepRunning() returns true, the runner grows the iteration count until
+// the run takes at least MIN_BENCH_TIME.
+class State {
+   public:
+    explicit State(std::size_t iterations) : remaining(iterations) {}
+
+    bool keepRunning() {
+        if (remaining == 0) {
+            return false;
+        }
+        remaining--;
+        return true;
+    }
+
+   private:
+    std::size_t remaining;
+};
+
+struct Result {
+    std::string name;
+    std::size_t iterations;
+    double ns_per_op;
+};
+
+class Registry {
+   public:
+    using Body = std::function<void(State&)>;
+
+    static Registry& get() {
+        static Registry registry;
+        return registry;
+    }
+
+    void add(std::string name, Body body) {
+        benchmarks.emplace_back(std::move(name), std::move(body));
+    }
+
+    std::vector<Result> runAll(std::string const& filter) const {
+        std::vector<Result> results;
+        for (auto const& [name, body] : benchmarks) {
+            if (!filter.empty() && name.find(filter) == std::string::npos) {
+                continue;
+            }
+            results.push_back(run(name, body));
+        }
+        return results;
+    }
+
+   private:
+    static Result run(std::string const& name, Body const& body) {
+        using Clock = std::chrono::steady_clock;
+        std::size_t iterations = 1;
+        for (;;) {
+            State state(iterations);
+            auto start = Clock::now();
+            body(state);
+            auto elapsed = Clock::now() - start;
+
+            if (elapsed >= MIN_BENCH_TIME) {
+                double ns = std::chrono::duration<double, std::nano>(elapsed)
+                                .count();
+                return {name, iterations,
+                        ns / static_cast<double>(iterations)};
+            }
+            iterations *= 2;
+        }
+    }
+
+    std::vector<std::pair<std::string, Body>> benchmarks;
+};
+
+struct Registrar {
+    Registrar(std::string name, Registry::Body body) {
+        Registry::get().add(std::move(name), std::move(body));
+    }
+};
+
+// Keeps the compiler from dropping a computed value
+template <typename T>
+inline void doNotOptimize(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}  // namespace bench
+
+#define BENCHMARK(name)                                                \
+    static void name(bench::State& state);                             \
+    static bench::Registrar const name##_registrar(#name, name);       \
+    static void name(bench::State& state)
+
+#endif  // !__BENCHMARK_HPP__
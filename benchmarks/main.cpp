@@ -0,0 +1,81 @@
+#include <array>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark.hpp"
+
+// Generated on every build by revision.cmake
+#if __has_include("benchRevision.hpp")
+#include "benchRevision.hpp"
+#endif
+#ifndef BENCH_REVISION
+#define BENCH_REVISION "unknown"
+#endif
+
+namespace {
+
+// One object per run, so results of several commits can be compared by
+// name. Names are C++ identifiers and never need escaping.
+auto writeJson(std::string const& path,
+               std::vector<bench::Result> const& results) -> bool {
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> out(
+        std::fopen(path.c_str(), "w"), std::fclose);
+    if (!out) {
+        return false;
+    }
+
+    std::time_t now = std::time(nullptr);
+    std::tm utc{};
+    gmtime_r(&now, &utc);
+    std::array<char, 32> date{};  // NOLINT
+    std::strftime(date.data(), date.size(), "%FT%TZ", &utc);
+
+    std::fprintf(out.get(),
+                 "{\n  \"revision\": \"%s\",\n  \"date\": \"%s\",\n"
+                 "  \"benchmarks\": [\n",
+                 BENCH_REVISION, date.data());
+    for (std::size_t i = 0; i < results.size(); i++) {
+        auto const& r = results[i];
+        std::fprintf(out.get(),
+                     "    {\"name\": \"%s\", \"iterations\": %zu, "
+                     "\"ns_per_op\": %.2f}%s\n",
+                     r.name.c_str(), r.iterations, r.ns_per_op,
+                     i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out.get(), "  ]\n}\n");
+    return std::ferror(out.get()) == 0;
+}
+
+}  // namespace
+
+// runBenchmarks [filter] [--json <file>]
+auto main(int argc, char** argv) -> int {
+    std::string filter;
+    std::string json_path;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];  // NOLINT
+        if (arg == "--json" && i + 1 < argc) {
+            json_path = argv[++i];  // NOLINT
+        } else {
+            filter = arg;
+        }
+    }
+
+    std::printf("%-40s %14s %14s\n", "Benchmark", "Iterations", "ns/op");
+    auto results = bench::Registry::get().runAll(filter);
+    for (auto const& r : results) {
+        std::printf("%-40s %14zu %14.2f\n", r.name.c_str(), r.iterations,
+                    r.ns_per_op);
+    }
+
+    if (!json_path.empty() && !writeJson(json_path, results)) {
+        std::fprintf(stderr, "Cannot write %s\n", json_path.c_str());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,37 @@
+# revision.cmake: пишет ревизию в заголовок при каждой сборке.
+# cmake -DSOURCE_DIR=<repo> -DOUTPUT=<header> -P revision.cmake
+
+set(BENCH_REVISION "unknown")
+find_package(Git QUIET)
+if(GIT_FOUND)
+    execute_process(
+        COMMAND ${GIT_EXECUTABLE} rev-parse --short HEAD
+        WORKING_DIRECTORY ${SOURCE_DIR}
+        OUTPUT_VARIABLE REVISION
+        OUTPUT_STRIP_TRAILING_WHITESPACE
+        ERROR_QUIET
+    )
+    # Незакоммиченные изменения тоже меняют результаты
+    execute_process(
+        COMMAND ${GIT_EXECUTABLE} status --porcelain --untracked-files=no
+        WORKING_DIRECTORY ${SOURCE_DIR}
+        OUTPUT_VARIABLE CHANGES
+        ERROR_QUIET
+    )
+    if(REVISION)
+        set(BENCH_REVISION "${REVISION}")
+        if(CHANGES)
+            set(BENCH_REVISION "${REVISION}-dirty")
+        endif()
+    endif()
+endif()
+
+set(CONTENT "#define BENCH_REVISION \"${BENCH_REVISION}\"\n")
+# Заголовок перезаписывается только при смене ревизии, иначе main.cpp
+# пересобирался бы каждый раз
+if(EXISTS ${OUTPUT})
+    file(READ ${OUTPUT} OLD_CONTENT)
+endif()
+if(NOT "${CONTENT}" STREQUAL "${OLD_CONTENT}")
+    file(WRITE ${OUTPUT} "${CONTENT}")
+endif()
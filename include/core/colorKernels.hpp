@@ -0,0 +1,50 @@
+#ifndef __COLOR_KERNELS_HPP__
+#define __COLOR_KERNELS_HPP__
+
+#include <cstdint>
+#include <span>
+
+#include "system/colorBuffer.hpp"
+
+namespace core {
+
+// Blend weights are fixed point, BLEND_ONE is all of the second color
+constexpr uint16_t const BLEND_ONE = 256;
+// Hues are fixed point too, HUE_TURN is the full circle
+constexpr uint32_t const HUE_TURN = 65536;
+
+// Instruction sets the kernels are built for. SSE2 and AVX2 only exist on
+// x86-64, elsewhere every kernel runs the scalar code.
+enum class KernelIsa : uint8_t { SCALAR, SSE2, AVX2 };
+
+// Color math over whole LED arrays. Every implementation gives bit for bit
+// the result of the scalar one, the LED count is that of the shortest span.
+struct ColorKernels {
+    KernelIsa isa;
+    // out = (from * (BLEND_ONE - weight) + to * weight) / BLEND_ONE, weight
+    // up to BLEND_ONE
+    void (*blend)(std::span<sys::LedColor const> from,
+                  std::span<sys::LedColor const> to, uint16_t weight,
+                  std::span<sys::LedColor> out);
+    // Gamma 2 in place, x * (x + 1) / 256: dark levels get darker so fades
+    // look even to the eye, 0 and 255 stay
+    void (*gamma)(std::span<sys::LedColor> leds);
+    // HSV to device order, one hue per LED, same saturation and value
+    void (*hsvToGrb)(std::span<uint16_t const> hues, uint8_t sat, uint8_t val,
+                     std::span<sys::LedColor> out);
+};
+
+bool kernelsSupported(KernelIsa isa);
+// The kernels of one instruction set, which must be supported
+ColorKernels const& colorKernels(KernelIsa isa);
+// The fastest kernels of this CPU, picked on the first call
+ColorKernels const& colorKernels();
+
+// The scalar kernels for a single color
+sys::LedColor blendColor(sys::LedColor const& from, sys::LedColor const& to,
+                         uint16_t weight);
+sys::LedColor hsvToGrb(uint16_t hue, uint8_t sat, uint8_t val);
+
+}  // namespace core
+
+#endif  // !__COLOR_KERNELS_HPP__
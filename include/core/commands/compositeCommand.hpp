@@ -18,13 +18,14 @@ class CompositeCommand : public EffectCommand {
 
     std::array<uint8_t, 3> execute(
         std::chrono::steady_clock::duration interval) override;
+    void render(std::chrono::steady_clock::duration interval,
+                sys::ColorBuffer& frame) override;
     bool isFinished() const override;
 
     std::unique_ptr<EffectCommand> clone() override;
-    std::unique_ptr<EffectCommand> makeNew(
-        EffectParams const& params) override {
-        return clone();
-    }
+    void reset() override;
+    // The parts keep their own parameters
+    void configure(EffectParams const& /*params*/) override {}
 
    private:
     std::vector<std::unique_ptr<EffectCommand>> effects;
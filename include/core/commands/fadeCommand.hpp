@@ -27,7 +27,9 @@ class FadeCommand : public EffectCommand {
     bool isFinished() const override { return finished; }
 
     std::unique_ptr<EffectCommand> clone() override;
-    std::unique_ptr<EffectCommand> makeNew(EffectParams const& params) override;
+    void reset() override;
+    // Start and end colors are what the fade is, only the duration changes
+    void configure(EffectParams const& params) override;
 
    private:
     Color start_color;
@@ -18,11 +18,6 @@ class FadeOutCommand : public FadeCommand {
     std::unique_ptr<EffectCommand> clone() override {
         return std::make_unique<FadeOutCommand>(*this);
     }
-
-    std::unique_ptr<EffectCommand> makeNew(
-        EffectParams const& params) override {
-        return clone();
-    }
 };
 
 }  // namespace core
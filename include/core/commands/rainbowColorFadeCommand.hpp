@@ -7,6 +7,7 @@
 #include <memory>
 #include <vector>
 
+#include "core/commands/fadeCommand.hpp"
 #include "core/effectCommand.hpp"
 
 namespace core {
@@ -34,15 +35,15 @@ class RainbowColorFadeCommand : public EffectCommand {
     bool isFinished() const override { return false; }
 
     std::unique_ptr<EffectCommand> clone() override;
-    std::unique_ptr<EffectCommand> makeNew(
-        EffectParams const& params) override;
+    void reset() override;
+    void configure(EffectParams const& params) override;
 
    private:
     void buildSequense();
 
     std::chrono::steady_clock::duration fade_duration;
-    std::vector<std::unique_ptr<EffectCommand>> sequence;
-    std::vector<std::unique_ptr<EffectCommand>> prototype;
+    // Held by value and rewound in place when a fade ends
+    std::vector<FadeCommand> sequence;
     std::vector<Color> rainbow_colors;
     std::size_t current_command_idx{0};
 };
@@ -0,0 +1,48 @@
+#ifndef __RAINBOW_SPIN_COMMAND_HPP__
+#define __RAINBOW_SPIN_COMMAND_HPP__
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "core/effectCommand.hpp"
+#include "system/colorBuffer.hpp"
+
+namespace core {
+
+// The whole hue circle laid around the ring of every fan, turning once per
+// period. Needs per-LED frames, execute() alone gives the first LED.
+class RainbowSpinCommand : public EffectCommand {
+    using Color = std::array<uint8_t, 3>;
+    using Duration = std::chrono::steady_clock::duration;
+
+   public:
+    explicit RainbowSpinCommand(Duration period) : period(period) {}
+
+    Color execute(Duration interval) override;
+    void render(Duration interval, sys::ColorBuffer& frame) override;
+
+    bool isFinished() const override { return false; }
+
+    std::unique_ptr<EffectCommand> clone() override;
+    void reset() override { phase = 0.0; }
+    void configure(EffectParams const& params) override;
+
+   private:
+    // Hue of the first LED in turns, 0.0 to 1.0
+    double advance(Duration interval);
+
+    Duration period;
+    double phase = 0.0;
+    // Hues of one ring, rendered into the first fan and copied to the rest
+    std::vector<uint16_t> hues;
+};
+
+// Full saturation and value, hue in turns
+sys::LedColor hueToGrb(double hue);
+
+}  // namespace core
+
+#endif  // !__RAINBOW_SPIN_COMMAND_HPP__
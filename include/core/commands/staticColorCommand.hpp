@@ -26,7 +26,10 @@ class StaticColorCommand : public EffectCommand {
     bool isFinished() const override { return elapsed >= duration; }
 
     std::unique_ptr<EffectCommand> clone() override;
-    std::unique_ptr<EffectCommand> makeNew(EffectParams const& params) override;
+    void reset() override {
+        elapsed = std::chrono::steady_clock::duration::zero();
+    }
+    void configure(EffectParams const& params) override;
 
     static std::unique_ptr<EffectCommand> makeStaticColorCommand(
         uint8_t r, uint8_t g, uint8_t b,
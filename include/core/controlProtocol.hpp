@@ -0,0 +1,44 @@
+#ifndef __CONTROL_PROTOCOL_HPP__
+#define __CONTROL_PROTOCOL_HPP__
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace core {
+
+// Requests are single-line flat JSON objects. Values are null, booleans,
+// numbers, strings or arrays of numbers, which covers every command.
+using JsonValue = std::variant<std::monostate, bool, double, std::string,
+                               std::vector<double>>;
+
+class JsonObject {
+   public:
+    bool contains(std::string const& key) const {
+        return fields.contains(key);
+    }
+    // Typed accessors throw std::runtime_error naming the key
+    double number(std::string const& key) const;
+    double number(std::string const& key, double fallback) const;
+    bool boolean(std::string const& key, bool fallback) const;
+    std::string const& string(std::string const& key) const;
+    std::vector<double> const& numbers(std::string const& key) const;
+
+    void set(std::string key, JsonValue value) {
+        fields.insert_or_assign(std::move(key), std::move(value));
+    }
+
+   private:
+    std::unordered_map<std::string, JsonValue> fields;
+};
+
+JsonObject parseJsonObject(std::string_view text);
+
+// Quotes and escapes a string for a JSON response
+std::string jsonString(std::string_view text);
+
+}  // namespace core
+#endif  // !__CONTROL_PROTOCOL_HPP__
@@ -0,0 +1,108 @@
+#ifndef __CONTROL_SERVER_HPP__
+#define __CONTROL_SERVER_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "core/controlProtocol.hpp"
+#include "core/mediator.hpp"
+#include "core/observer.hpp"
+#include "system/fanTelemetry.hpp"
+
+constexpr std::chrono::milliseconds const DEFAULT_STREAM_PERIOD =
+    std::chrono::seconds(1);
+constexpr std::chrono::milliseconds const MIN_STREAM_PERIOD =
+    std::chrono::milliseconds(100);
+constexpr std::size_t const CONTROL_MAX_CLIENTS = 32;
+constexpr std::size_t const CONTROL_MAX_LINE = 4096;
+// A subscriber that does not read skips frames instead of growing this
+constexpr std::size_t const CONTROL_MAX_PENDING_OUTPUT = 64 * 1024;
+
+namespace core {
+
+// Line-delimited JSON over a Unix socket. Every request is answered with
+// {"ok":true} or {"ok":false,"error":...}; subscribers additionally get
+// {"event":"telemetry",...} lines at their own period.
+//
+//   {"cmd":"color","controller":0,"fan":1,"r":1,"g":0,"b":0,"all":false}
+//   {"cmd":"effect","effect":0,"duration":2,"r":1,"g":1,"b":1}
+//   {"cmd":"curve","controller":0,"fan":1,"temps":[..],"speeds":[..]}
+//   {"cmd":"bezier","controller":0,"fan":1,"points":[x0,y0,..,x3,y3]}
+//     temps strictly increasing, speeds and y in 0-100
+//   {"cmd":"mode","controller":0,"fan":1,"mode":"gpu"}
+//   {"cmd":"telemetry"}
+//   {"cmd":"subscribe","period_ms":500}  {"cmd":"unsubscribe"}
+//
+// Commands go through the mediator like the GUI ones. Everything runs on
+// one server thread, the control thread only stores temperatures into
+// atomics through temperatureObserver(). on_curves_changed runs on the server
+// thread after every curve or mode change.
+class ControlServer {
+   public:
+    ControlServer(ControlServer const&) = delete;
+    ControlServer(ControlServer&&) = delete;
+    ControlServer& operator=(ControlServer const&) = delete;
+    ControlServer& operator=(ControlServer&&) = delete;
+    ControlServer(std::string socket_path, std::shared_ptr<Mediator> mediator,
+                  std::shared_ptr<sys::FanTelemetry const> telemetry,
+                  std::function<void()> on_curves_changed = nullptr);
+    ~ControlServer();
+
+    std::shared_ptr<Observer> temperatureObserver();
+    std::size_t clientsNum() const { return clients_num.load(); }
+    std::string const& socketPath() const { return socket_path; }
+
+    // $XDG_RUNTIME_DIR/tt_riing_quad_fan_control.sock, or /tmp per user
+    static std::string defaultSocketPath();
+
+   private:
+    struct Client {
+        explicit Client(int fd) : fd(fd) {}
+
+        int fd;
+        std::string in;
+        std::string out;
+        bool subscribed = false;
+        std::chrono::milliseconds period = DEFAULT_STREAM_PERIOD;
+        std::chrono::steady_clock::time_point next_frame;
+    };
+
+    // Shared with the observer, which may outlive the server in Monitoring
+    struct Temperatures {
+        std::atomic<float> cpu = 0;
+        std::atomic<float> gpu = 0;
+    };
+    class TemperatureObserver;
+
+    void serve(std::stop_token const& stop);
+    void acceptClients();
+    bool readClient(Client& client);
+    bool writeClient(Client& client);
+    void streamTelemetry(std::chrono::steady_clock::time_point now);
+    std::string handleLine(Client& client, std::string_view line);
+    std::string execute(Client& client, JsonObject const& request);
+    std::string telemetryLine() const;
+    int pollTimeout(std::chrono::steady_clock::time_point now) const;
+
+    std::string socket_path;
+    std::shared_ptr<Mediator> mediator;
+    std::shared_ptr<sys::FanTelemetry const> telemetry;
+    std::function<void()> on_curves_changed;
+    int listen_fd = -1;
+    int wake_fd = -1;
+    std::vector<Client> clients;
+    std::atomic<std::size_t> clients_num = 0;
+    std::shared_ptr<Temperatures> temperatures;
+    std::jthread thread;
+};
+
+}  // namespace core
+#endif  // !__CONTROL_SERVER_HPP__
@@ -0,0 +1,175 @@
+#ifndef __EFFECT_HPP__
+#define __EFFECT_HPP__
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "core/effectCommand.hpp"
+
+namespace core {
+
+// Value type counterparts of the EffectCommand hierarchy. They play exactly
+// like the commands of the same name, but a set of them lives in one
+// contiguous vector and is dispatched by std::visit instead of a vtable.
+using EffectColor = std::array<uint8_t, 3>;
+using EffectDuration = std::chrono::steady_clock::duration;
+
+constexpr std::size_t const RAINBOW_COLORS_NUM = 6;
+constexpr std::array<EffectColor, RAINBOW_COLORS_NUM> const RAINBOW_COLORS{
+    EffectColor{MAX_CHANNEL_VALUE, MIN_CHANNEL_VALUE, MIN_CHANNEL_VALUE},
+    EffectColor{MAX_CHANNEL_VALUE, MAX_CHANNEL_VALUE, MIN_CHANNEL_VALUE},
+    EffectColor{MIN_CHANNEL_VALUE, MAX_CHANNEL_VALUE, MIN_CHANNEL_VALUE},
+    EffectColor{MIN_CHANNEL_VALUE, MAX_CHANNEL_VALUE, MAX_CHANNEL_VALUE},
+    EffectColor{MIN_CHANNEL_VALUE, MIN_CHANNEL_VALUE, MAX_CHANNEL_VALUE},
+    EffectColor{MAX_CHANNEL_VALUE, MIN_CHANNEL_VALUE, MAX_CHANNEL_VALUE},
+};
+
+class StaticEffect {
+   public:
+    StaticEffect(EffectColor color, EffectDuration duration)
+        : color(color), duration(duration) {}
+
+    EffectColor execute(EffectDuration interval) {
+        elapsed += interval;
+        return color;
+    }
+    bool isFinished() const { return elapsed >= duration; }
+    void reset() { elapsed = EffectDuration::zero(); }
+    void configure(EffectParams const& params);
+
+   private:
+    EffectColor color;
+    EffectDuration duration;
+    EffectDuration elapsed{};
+};
+
+class FadeEffect {
+   public:
+    FadeEffect(EffectColor start, EffectColor end, EffectDuration duration)
+        : start_color(start),
+          end_color(end),
+          current_color(start),
+          duration(duration) {}
+
+    EffectColor execute(EffectDuration interval);
+    bool isFinished() const { return finished; }
+    void reset();
+    // Start and end colors are what the fade is, only the duration changes
+    void configure(EffectParams const& params);
+
+   private:
+    EffectColor start_color;
+    EffectColor end_color;
+    EffectColor current_color;
+    EffectDuration duration;
+    EffectDuration elapsed{};
+    bool finished = false;
+};
+
+// Endless cycle through a fixed sequence of fades
+template <std::size_t N>
+class FadeCycle {
+   public:
+    EffectColor execute(EffectDuration interval) {
+        auto& fade = fades[current_idx];
+        auto result = fade.execute(interval);
+        if (fade.isFinished()) {
+            fade.reset();
+            current_idx = (current_idx + 1) % N;
+        }
+        return result;
+    }
+    bool isFinished() const { return false; }
+    void reset() {
+        for (auto& fade : fades) {
+            fade.reset();
+        }
+        current_idx = 0;
+    }
+    void configure(EffectParams const& params) {
+        for (auto& fade : fades) {
+            fade.configure(params);
+        }
+        current_idx = 0;
+    }
+
+   protected:
+    explicit FadeCycle(std::array<FadeEffect, N> fades)
+        : fades(std::move(fades)) {}
+
+   private:
+    std::array<FadeEffect, N> fades;
+    std::size_t current_idx = 0;
+};
+
+// Fades from one rainbow color straight into the next
+class RainbowEffect : public FadeCycle<RAINBOW_COLORS_NUM> {
+   public:
+    explicit RainbowEffect(EffectDuration fade_duration);
+};
+
+// Fades each rainbow color out to black and the next one in
+class RainbowFadeEffect : public FadeCycle<2 * RAINBOW_COLORS_NUM> {
+   public:
+    explicit RainbowFadeEffect(EffectDuration fade_duration);
+};
+
+class Effect;
+
+// Plays its parts one after the other. Parts are stored inline in one
+// vector, nested composites included.
+class CompositeEffect {
+   public:
+    CompositeEffect() = default;
+
+    void addEffect(Effect effect);
+
+    EffectColor execute(EffectDuration interval);
+    bool isFinished() const;
+    void reset();
+    // The parts keep their own parameters
+    void configure(EffectParams const& /*params*/) {}
+
+   private:
+    std::vector<Effect> parts;
+    std::size_t current_idx = 0;
+};
+
+class Effect {
+   public:
+    using Variant = std::variant<StaticEffect, FadeEffect, RainbowEffect,
+                                 RainbowFadeEffect, CompositeEffect>;
+
+    template <typename T>
+        requires std::is_constructible_v<Variant, T>
+    Effect(T effect)  // NOLINT: every alternative converts implicitly
+        : effect(std::move(effect)) {}
+
+    EffectColor execute(EffectDuration interval) {
+        return std::visit([interval](auto& e) { return e.execute(interval); },
+                          effect);
+    }
+    bool isFinished() const {
+        return std::visit([](auto const& e) { return e.isFinished(); },
+                          effect);
+    }
+    void reset() {
+        std::visit([](auto& e) { e.reset(); }, effect);
+    }
+    void configure(EffectParams const& params) {
+        std::visit([&params](auto& e) { e.configure(params); }, effect);
+    }
+
+   private:
+    Variant effect;
+};
+
+}  // namespace core
+
+#endif  // !__EFFECT_HPP__
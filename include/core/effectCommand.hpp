@@ -1,8 +1,12 @@
 #ifndef __EFFECT_COMMAND_HPP__
 #define __EFFECT_COMMAND_HPP__
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
+
+#include "system/colorBuffer.hpp"
+
 namespace core {
 
 struct EffectParams {
@@ -19,9 +23,18 @@ class EffectCommand {
     virtual std::array<uint8_t, 3> execute(
         std::chrono::steady_clock::duration) = 0;
     virtual bool isFinished() const = 0;
+    // Advances like execute() and colors every LED of the frame. Effects
+    // with one color for all LEDs keep this default.
+    virtual void render(std::chrono::steady_clock::duration interval,
+                        sys::ColorBuffer& frame) {
+        std::ranges::fill(frame.all(), execute(interval));
+    }
     virtual std::unique_ptr<EffectCommand> clone() = 0;
-    virtual std::unique_ptr<EffectCommand> makeNew(
-        EffectParams const& params) = 0;
+    // Both work in place and run on the effects thread only, FanController
+    // hands effect changes from other threads over to it between frames.
+    // They must not allocate.
+    virtual void reset() = 0;
+    virtual void configure(EffectParams const& params) = 0;
 };
 
 }  // namespace core
@@ -4,9 +4,11 @@
 #include <chrono>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "core/effectCommand.hpp"
+#include "system/colorBuffer.hpp"
 
 namespace core {
 
@@ -22,6 +24,9 @@ class EffectsEngine {
     void resetActiveEffect();
     std::array<uint8_t, 3> update(
         std::chrono::steady_clock::duration interval);
+    // Per-LED counterpart of update(), false if no effect is active
+    bool render(std::chrono::steady_clock::duration interval,
+                sys::ColorBuffer& frame);
     std::size_t getEffectCount() const;
 
    private:
@@ -2,20 +2,30 @@
 #define __FAN_CONTROLLER_HPP__
 
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <thread>
 #include <vector>
 
 #include "core/effectsEngine.hpp"
+#include "core/frameClock.hpp"
 #include "core/mediators/fanMediator.hpp"
 #include "core/mediator.hpp"
+#include "core/tripleBuffer.hpp"
 #include "system/controllerData.hpp"
 #include "system/deviceController.hpp"
+#include "system/telemetrySink.hpp"
 
 constexpr std::chrono::milliseconds const DEFAULT_INTERVAL =
     std::chrono::milliseconds(100);
+// Unchanged frames are still resent this often in case the firmware resets
+constexpr std::chrono::milliseconds const DEFAULT_RGB_KEEP_ALIVE =
+    std::chrono::seconds(5);
 
 namespace core {
 
@@ -35,9 +45,13 @@ class FanController {
           wrapper(wr),
           effectsEngine(std::move(ee)),
           run(run),
-          interval(interval) {
+          interval(interval),
+          effects_clock(interval),
+          frames(wr->makeColorBuffer()) {
         color_buffer = wr->makeColorBuffer();
-        tmp_color_buffer = wr->makeColorBuffer();
+        sent_hashes.assign(color_buffer.controllersNum(),
+                           std::vector<uint64_t>(color_buffer.fansNum(), 0));
+        seen_drops = sent_hashes;
         rgb_thread = std::thread(&FanController::rgbThreadLoop, this);
         effects_thread = std::thread(&FanController::effectsThreadLoop, this);
     }
@@ -56,8 +70,30 @@ class FanController {
     void updateGPUfans(float temp);
     void updateFanColor(std::size_t controller_idx, std::size_t fan_idx,
                         std::array<uint8_t, 3> const& color, bool to_all);
+    // Starts an effect from any thread. The effects thread switches to it
+    // before its next frame, the engine is never touched mid-render.
     void updateEffect(std::size_t effect_pos, std::size_t duration_s,
                       std::array<uint8_t, 3> const& color);
+    void setKeepAlive(std::chrono::milliseconds period) {
+        keep_alive.store(period);
+    }
+    std::size_t skippedFrames() const { return skipped_frames.load(); }
+    // Frames rendered by the effects thread since start
+    std::size_t effectFrames() const { return effect_frames.load(); }
+    // Pacing of the effects thread: lateness and missed frames
+    FrameClock const& effectsClock() const { return effects_clock; }
+    // Frames replaced by a newer one before the RGB thread sent them
+    std::size_t droppedFrames() const { return frames.overwritten(); }
+    void logEffectStats() const;
+    // Target speeds are published there. Set before observers are attached.
+    void setSink(std::shared_ptr<sys::TelemetrySink> s) { sink = std::move(s); }
+    // Copies the curves and modes of a freshly parsed config over the current
+    // ones, never while updateFans reads them
+    void loadSystem(sys::System const& new_system);
+    // Edits one fan under the same lock, std::out_of_range for a fan that
+    // does not exist
+    void editFan(std::size_t controller_idx, std::size_t fan_idx,
+                 std::function<void(sys::Fan&)> const& edit);
     void pointInfo() { dataUse = DataUse::POINT; }
     void bezierInfo() { dataUse = DataUse::BEZIER; }
 
@@ -66,22 +102,50 @@ class FanController {
     }
 
    private:
+    struct EffectRequest {
+        std::size_t effect_pos;
+        std::chrono::seconds duration;
+        std::array<uint8_t, 3> color;
+    };
+
     void rgbThreadLoop();
     void effectsThreadLoop();
+    void applyEffectRequest();
     void updateFans(sys::MonitoringMode mode, float temp);
 
     DataUse dataUse = DataUse::POINT;
-    std::vector<std::vector<std::array<uint8_t, 3>>> color_buffer;
-    std::vector<std::vector<std::array<uint8_t, 3>>> tmp_color_buffer;
+    // Colors set by hand. Copied into a frame after every edit, and takes
+    // the last frame of an effect once it stops.
+    sys::ColorBuffer color_buffer;
+    std::atomic<uint64_t> color_edits = 0;
+    std::vector<std::vector<uint64_t>> sent_hashes;
+    // colorDrops() of every fan when the RGB thread last looked
+    std::vector<std::vector<uint64_t>> seen_drops;
+    std::chrono::steady_clock::time_point last_refresh;
+    std::atomic<std::chrono::milliseconds> keep_alive = DEFAULT_RGB_KEEP_ALIVE;
+    std::atomic<std::size_t> skipped_frames = 0;
+    std::atomic<std::size_t> effect_frames = 0;
     std::shared_ptr<sys::System> system;
+    // Between updateFans on the monitoring thread and edits from others
+    std::mutex system_lock;
     std::shared_ptr<sys::DeviceController> wrapper;
     std::shared_ptr<Mediator> mediator;
+    std::shared_ptr<sys::TelemetrySink> sink;
     std::unique_ptr<EffectsEngine> effectsEngine;
     std::chrono::milliseconds interval;
+    FrameClock effects_clock;
+    // Frames on their way to the RGB thread. The effects thread is the only
+    // one publishing, it renders straight into the back buffer.
+    TripleBuffer<sys::ColorBuffer> frames;
     std::atomic<bool> run = true;
     std::thread rgb_thread;
     std::thread effects_thread;
-    std::mutex hid_lock;
+    // Only for color_buffer, held for an edit or a copy, never for a render
+    std::mutex color_lock;
+    // The newest effect asked for, taken by the effects thread between
+    // frames. A later request replaces one not taken yet.
+    std::optional<EffectRequest> effect_request;
+    std::mutex effect_lock;
 };
 
 };  // namespace core
@@ -0,0 +1,54 @@
+#ifndef __FRAME_CLOCK_HPP__
+#define __FRAME_CLOCK_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "system/latencyHistogram.hpp"
+
+namespace core {
+
+// Paces a render loop on absolute steady_clock deadlines, one period apart.
+// Time spent rendering, blocked on a mutex or not scheduled does not push
+// the following frames back. When a frame is so late that whole periods
+// passed, their deadlines are dropped instead of rendered back to back.
+// wait() belongs to the loop thread, the statistics may be read anywhere.
+class FrameClock {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    FrameClock(FrameClock const&) = delete;
+    FrameClock(FrameClock&&) = delete;
+    FrameClock& operator=(FrameClock const&) = delete;
+    FrameClock& operator=(FrameClock&&) = delete;
+    explicit FrameClock(Clock::duration period);
+    ~FrameClock() = default;
+
+    // Sleeps until the next deadline and returns the real time since the
+    // previous call, to advance the frame by
+    Clock::duration wait();
+
+    Clock::duration period() const { return frame_period; }
+    uint64_t frames() const { return frames_num.load(); }
+    // Deadlines passed without a frame
+    uint64_t missedFrames() const { return missed_num.load(); }
+    // How long after its deadline each frame woke up
+    std::shared_ptr<sys::LatencyHistogram const> lateness() const {
+        return lateness_histogram;
+    }
+
+   private:
+    Clock::duration frame_period;
+    Clock::time_point deadline;
+    Clock::time_point last_frame;
+    std::atomic<uint64_t> frames_num = 0;
+    std::atomic<uint64_t> missed_num = 0;
+    // Shared so an exporter keeps it readable without owning the loop
+    std::shared_ptr<sys::LatencyHistogram> lateness_histogram;
+};
+
+}  // namespace core
+
+#endif  // !__FRAME_CLOCK_HPP__
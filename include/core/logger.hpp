@@ -1,23 +1,63 @@
 #ifndef __LOGGER_HPP__
 #define __LOGGER_HPP__
 
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <type_traits>
+
+#include "core/ringBuffer.hpp"
 
 namespace core {
 
 enum class LogLevel { INFO, WARNING, ERROR };
 
+// What an async producer does when the ring is full
+enum class LogOverflowPolicy { DROP, BLOCK };
+
+// Lowest level compiled into the binary: 0 INFO, 1 WARNING, 2 ERROR.
+// Statements below it written through LOG_* disappear together with their
+// arguments.
+#ifndef LOG_MIN_LEVEL
 #ifdef ENABLE_INFO_LOGS
-constexpr bool INFO_LOGS_ENABLE = true;
+#define LOG_MIN_LEVEL 0
 #else
-constexpr bool INFO_LOGS_ENABLE = false;
+#define LOG_MIN_LEVEL 1
+#endif
 #endif
 
+constexpr LogLevel const COMPILED_LOG_LEVEL =
+    static_cast<LogLevel>(LOG_MIN_LEVEL);
+
+constexpr bool compiledIn(LogLevel level) {
+    return level >= COMPILED_LOG_LEVEL;
+}
+
+// Sources with their own runtime level
+enum class LogModule { CORE, HID, MONITORING, CONFIG, GUI, COUNT };
+
+constexpr std::size_t const LOG_RECORD_TEXT_SIZE = 240;
+constexpr std::size_t const DEFAULT_LOG_RING_SIZE = 1024;
+
+// One finished line as it travels from a producer to the writer thread
+struct LogRecord {
+    LogLevel level;
+    std::chrono::system_clock::time_point ts;
+    uint16_t len;
+    std::array<char, LOG_RECORD_TEXT_SIZE> text;
+};
+
 class Logger {
    public:
     Logger(Logger const&) = delete;
@@ -27,29 +67,36 @@ class Logger {
 
     static Logger log;
 
-    Logger& operator()(LogLevel level);
+    Logger& operator()(LogLevel level, LogModule module = LogModule::CORE);
     template <typename T>
     Logger& operator<<(T const& value) {
-        if constexpr (std::is_same_v<T, std::string_view>) {
-            logBuffer.write(value.data(), static_cast<std::streamsize>(value.size()));
-        } else if constexpr (std::is_arithmetic_v<T> ||
-                      std::is_convertible_v<T, std::string> ||
-                      std::is_invocable_v<decltype(std::declval<std::ostream&>()
-                                                   << std::declval<T>()),
-                                          std::ostream&, T>) {
-            std::scoped_lock lock(logMutex);
-
-            if (!shouldLog(currentLevel)) {
-                return *this;
-            }
-
-            logBuffer << value;
-            flush(value);
+        static_assert(
+            requires(std::ostream& os) { os << value; },
+            "Logger operator<< can only be used with types that support "
+            "ostream output.");
+
+        LineBuffer& l = line();
+        if (!l.active) {
+            return *this;
+        }
+
+        if constexpr (std::is_convertible_v<T const&, std::string_view>) {
+            l.text.append(std::string_view(value));
+        } else if constexpr (std::is_same_v<T, char> ||
+                             std::is_same_v<T, signed char> ||
+                             std::is_same_v<T, unsigned char>) {
+            l.text.push_back(static_cast<char>(value));
+        } else if constexpr (std::is_integral_v<T> &&
+                             !std::is_same_v<T, bool>) {
+            std::array<char, 24> buf{};  // NOLINT
+            auto [ptr, ec] =
+                std::to_chars(buf.data(), buf.data() + buf.size(), value);
+            l.text.append(buf.data(), ptr);
         } else {
-            static_assert(std::is_arithmetic_v<T> ||
-                              std::is_convertible_v<T, std::string>,
-                          "Logger operator<< can only be used with types that "
-                          "support ostream output.");
+            l.stream.str("");
+            l.stream.clear();
+            l.stream << value;
+            l.text.append(l.stream.view());
         }
 
         return *this;
@@ -63,45 +110,85 @@ class Logger {
         bool enable);
     void enableColorLogging(bool enable);
 
+    // Lines are handed to a background writer through a lock-free ring.
+    // The ring is allocated on the first call, later calls keep its size.
+    void enableAsync(std::size_t ring_size = DEFAULT_LOG_RING_SIZE,
+                     LogOverflowPolicy policy = LogOverflowPolicy::DROP);
+    // Stops the writer after everything queued so far has been written.
+    // Lines longer than a record always take the synchronous path.
+    void disableAsync();
+    bool isAsync() const { return async_enabled.load(); }
+    std::size_t droppedRecords() const { return dropped_records.load(); }
+
+    // Levels below the compiled-in one stay disabled whatever is set here
+    void setModuleLevel(LogModule module, LogLevel level) {
+        module_levels[static_cast<std::size_t>(module)].store(
+            level, std::memory_order_relaxed);
+    }
+    bool enabled(LogModule module, LogLevel level) const {
+        return compiledIn(level) &&
+               level >= module_levels[static_cast<std::size_t>(module)].load(
+                            std::memory_order_relaxed);
+    }
+
    private:
+    // Line under construction, one per thread so producers never contend
+    struct LineBuffer {
+        LogLevel level = LogLevel::INFO;
+        bool active = false;
+        std::chrono::system_clock::time_point ts;
+        std::string text;
+        std::ostringstream stream;
+    };
+
     Logger();
     ~Logger();
 
+    static LineBuffer& line();
+    void commit(LineBuffer& l);
+    bool push(LineBuffer const& l);
+    void writerLoop(std::stop_token const& stop);
+    void drain();
+    void drainLocked();
+    void writeLine(LogLevel level, std::chrono::system_clock::time_point ts,
+                   std::string_view text);
+    void flushOutputs();
+
     std::ofstream logFile;
     bool logToConsole = true;
     bool useColor = true;
     std::mutex logMutex;
 
-    LogLevel currentLevel = LogLevel::INFO;
-    std::ostringstream logBuffer;
+    std::unique_ptr<RingBuffer<LogRecord>> ring;
+    LogOverflowPolicy overflow_policy = LogOverflowPolicy::DROP;
+    std::atomic<bool> async_enabled = false;
+    std::atomic<std::size_t> dropped_records = 0;
+    std::atomic<uint32_t> pending = 0;
+    std::jthread writer;
 
-    template <typename T>
-    void flush(T const& value, bool force_new_line = false) {
-        std::string log_message = logBuffer.str();
+    std::array<std::atomic<LogLevel>, static_cast<std::size_t>(LogModule::COUNT)>
+        module_levels;
 
-        if (log_message.empty()) {
-            return;
-        }
+    std::time_t cached_second = 0;
+    std::string cached_timestamp;
 
-        if (logToConsole) {
-            std::cout << getColorCode(currentLevel) << value << resetColor();
-            if (force_new_line) {
-                std::cout.flush();
-            }
-        }
-
-        if (logFile.is_open()) {
-            logFile << log_message;
-            if (force_new_line) {
-                logFile.flush();
-            }
-        }
-    }
     std::string getColorCode(LogLevel level) const;
     std::string resetColor() const;
-    static std::string getTimestamp();
-    static bool shouldLog(LogLevel level);
+    std::string const& getTimestamp(std::chrono::system_clock::time_point ts);
 };
 
 }  // namespace core
+
+// Statement front end: a level that is not compiled in leaves an empty
+// branch, a module level below the threshold skips the arguments at runtime.
+//     LOG_INFO(core::LogModule::HID) << "Fan " << idx << std::endl;
+#define LOG_AT(level, module)                                  \
+    if constexpr (!::core::compiledIn(level)) {                \
+    } else if (!::core::Logger::log.enabled(module, level)) {  \
+    } else                                                     \
+        ::core::Logger::log(level, module)
+
+#define LOG_INFO(module) LOG_AT(::core::LogLevel::INFO, module)
+#define LOG_WARNING(module) LOG_AT(::core::LogLevel::WARNING, module)
+#define LOG_ERROR(module) LOG_AT(::core::LogLevel::ERROR, module)
 #endif  // __LOGGER_HPP__
@@ -25,11 +25,6 @@ struct DataMessage : public Message {
     std::variant<FanData, std::array<std::pair<double, double>, 4>> data;
 };
 
-struct StatsMessage : public Message {
-    std::size_t cur_speed;
-    std::size_t cur_rpm;
-};
-
 struct ColorMessage : public Message {
     float r;
     float g;
@@ -59,12 +54,14 @@ class FanMediator : public Mediator {
 
     void dispatch(EventMessageType event_type, std::shared_ptr<Message> msg);
 
-    void handleUpdateStats(std::shared_ptr<StatsMessage> msg);
-
     void handleUpdateColor(std::shared_ptr<ColorMessage> msg);
 
     void handleUpdateEffect(std::shared_ptr<ColorMessage> msg);
 
+    void handleUpdateGraph(std::shared_ptr<DataMessage> msg);
+
+    void handleUpdateMode(std::shared_ptr<ModeMessage> msg);
+
     std::shared_ptr<gui::GuiManager> guiManager;
     std::shared_ptr<core::FanController> fanController;
 };
@@ -3,6 +3,7 @@
 
 #include <memory>
 
+#include "core/mediator.hpp"
 #include "core/mediators/fanMediator.hpp"
 #include "core/visitor.hpp"
 #include "system/controllerData.hpp"
@@ -17,10 +18,12 @@ class PlotStrategy {
     PlotStrategy& operator=(PlotStrategy&&) = delete;
     virtual ~PlotStrategy() = default;
 
+    // Shows the curve of fan j on controller i. Edits are sent to the
+    // mediator, the fan controller applies them to the system.
     virtual void plot(
         std::size_t i, std::size_t j,
         std::variant<FanData, std::array<std::pair<double, double>, 4>> data,
-        std::shared_ptr<sys::System> system) = 0;
+        std::shared_ptr<Mediator> mediator) = 0;
     virtual void accept(PlotVisitor& visitor) = 0;
 
    protected:
@@ -0,0 +1,98 @@
+#ifndef __RING_BUFFER_HPP__
+#define __RING_BUFFER_HPP__
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+namespace core {
+
+constexpr std::size_t const CACHE_LINE_SIZE = 64;
+
+// Bounded lock-free queue (Vyukov). Any number of producers and consumers,
+// every slot is allocated once in the constructor.
+template <typename T>
+class RingBuffer {
+   public:
+    explicit RingBuffer(std::size_t capacity)
+        : cells(std::make_unique<Cell[]>(std::bit_ceil(capacity))),
+          mask(std::bit_ceil(capacity) - 1) {
+        for (std::size_t i = 0; i <= mask; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    RingBuffer(RingBuffer const&) = delete;
+    RingBuffer(RingBuffer&&) = delete;
+    RingBuffer& operator=(RingBuffer const&) = delete;
+    RingBuffer& operator=(RingBuffer&&) = delete;
+    ~RingBuffer() = default;
+
+    template <typename U>
+    bool tryPush(U&& value) {
+        Cell* cell = nullptr;
+        std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells[pos & mask];
+            std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) -
+                        static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::forward<U>(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& value) {
+        Cell* cell = nullptr;
+        std::size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells[pos & mask];
+            std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) -
+                        static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = std::move(cell->data);
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t capacity() const { return mask + 1; }
+
+   private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T data;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    std::size_t mask;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> enqueue_pos{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> dequeue_pos{0};
+};
+
+}  // namespace core
+
+#endif  // !__RING_BUFFER_HPP__
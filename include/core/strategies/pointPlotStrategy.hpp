@@ -12,7 +12,7 @@ class PointPlotStrategy : public PlotStrategy {
     void plot(
         std::size_t i, std::size_t j,
         std::variant<FanData, std::array<std::pair<double, double>, 4>> data,
-        std::shared_ptr<sys::System> system) override;
+        std::shared_ptr<Mediator> mediator) override;
 
     void accept(PlotVisitor& visitor) override { visitor.visit(*this); }
 };
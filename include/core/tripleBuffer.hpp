@@ -0,0 +1,72 @@
+#ifndef __TRIPLE_BUFFER_HPP__
+#define __TRIPLE_BUFFER_HPP__
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "core/ringBuffer.hpp"
+
+namespace core {
+
+// Lock-free handoff of whole values from one producer to one consumer.
+// The producer fills its back buffer and publishes it, the consumer takes
+// the newest published one. Neither side ever waits for the other. A value
+// published again before the consumer took it is overwritten and counted.
+template <typename T>
+class TripleBuffer {
+   public:
+    // All three buffers start as copies of initial
+    explicit TripleBuffer(T const& initial)
+        : buffers{initial, initial, initial} {}
+    TripleBuffer(TripleBuffer const&) = delete;
+    TripleBuffer(TripleBuffer&&) = delete;
+    TripleBuffer& operator=(TripleBuffer const&) = delete;
+    TripleBuffer& operator=(TripleBuffer&&) = delete;
+    ~TripleBuffer() = default;
+
+    // Producer side. The back buffer holds an old value, not the last one
+    // published.
+    T& back() { return buffers[back_idx]; }
+    void publish() {
+        uint8_t previous =
+            middle.exchange(back_idx | FRESH, std::memory_order_acq_rel);
+        back_idx = previous & INDEX;
+        if ((previous & FRESH) != 0) {
+            overwritten_num.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Consumer side. Returns false and keeps the current front when
+    // nothing was published since the last call.
+    bool update() {
+        if ((middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+        uint8_t previous = middle.exchange(front_idx, std::memory_order_acq_rel);
+        front_idx = previous & INDEX;
+        return true;
+    }
+    T const& front() const { return buffers[front_idx]; }
+
+    // Published values the consumer never saw
+    uint64_t overwritten() const {
+        return overwritten_num.load(std::memory_order_relaxed);
+    }
+
+   private:
+    static constexpr uint8_t const INDEX = 0x3;
+    static constexpr uint8_t const FRESH = 0x4;
+
+    std::array<T, 3> buffers;
+    // Index of the middle buffer, FRESH while it holds an unread value
+    alignas(CACHE_LINE_SIZE) std::atomic<uint8_t> middle{1};
+    alignas(CACHE_LINE_SIZE) uint8_t back_idx = 0;
+    alignas(CACHE_LINE_SIZE) uint8_t front_idx = 2;
+    std::atomic<uint64_t> overwritten_num = 0;
+};
+
+}  // namespace core
+
+#endif  // !__TRIPLE_BUFFER_HPP__
@@ -0,0 +1,34 @@
+#ifndef __VALUE_EFFECTS_ENGINE_HPP__
+#define __VALUE_EFFECTS_ENGINE_HPP__
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "core/effect.hpp"
+
+namespace core {
+
+// EffectsEngine over value type effects: the same interface, but effects
+// sit next to each other in one vector and update() is a std::visit
+class ValueEffectsEngine {
+   public:
+    void addEffect(Effect effect);
+    void setActiveEffect(std::size_t index);
+    void setActiveEffect(Effect effect);
+
+    void updateActiveEffect(EffectColor color, EffectDuration duration);
+    bool hasActiveEffect() const;
+    void resetActiveEffect();
+    EffectColor update(EffectDuration interval);
+    std::size_t getEffectCount() const;
+
+   private:
+    std::vector<Effect> effects;
+    std::optional<std::size_t> active_effect;
+};
+
+}  // namespace core
+
+#endif  // !__VALUE_EFFECTS_ENGINE_HPP__
@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "core/logger.hpp"
+#include "core/mediator.hpp"
 #include "core/mediators/fanMediator.hpp"
 #include "core/strategies/bezierCurvePlotStrategy.hpp"
 #include "core/strategies/pointPlotStrategy.hpp"
@@ -17,23 +18,23 @@ struct PlotDrawVisitor : public PlotVisitor {
     PlotDrawVisitor(std::size_t i, std::size_t j,
                     std::array<std::pair<double, double>, 4> bezier_data,
                     std::vector<double> temps, std::vector<double> speeds,
-                    std::shared_ptr<sys::System> system)
+                    std::shared_ptr<Mediator> mediator)
         : i(i),
           j(j),
           bezierData(std::move(bezier_data)),
           temps(std::move(temps)),
           speeds(std::move(speeds)),
-          system(std::move(system)) {}
+          mediator(std::move(mediator)) {}
 
     void visit(PointPlotStrategy& strategy) override {
-        core::Logger::log(LogLevel::INFO)
+        LOG_INFO(core::LogModule::GUI)
             << "Visit PointPlotStrategy" << std::endl;
-        strategy.plot(i, j, FanData{temps, speeds}, system);
+        strategy.plot(i, j, FanData{temps, speeds}, mediator);
     }
     void visit(BezierCurvePlotStrategy& strategy) override {
-        core::Logger::log(LogLevel::INFO)
+        LOG_INFO(core::LogModule::GUI)
             << "Visit BezierCurvePlotStrategy" << std::endl;
-        strategy.plot(i, j, bezierData, system);
+        strategy.plot(i, j, bezierData, mediator);
     }
 
    private:
@@ -41,7 +42,7 @@ struct PlotDrawVisitor : public PlotVisitor {
     std::array<std::pair<double, double>, 4> bezierData;
     std::vector<double> temps;
     std::vector<double> speeds;
-    std::shared_ptr<sys::System> system;
+    std::shared_ptr<Mediator> mediator;
 };
 
 }  // namespace core
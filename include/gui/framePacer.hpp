@@ -0,0 +1,70 @@
+#ifndef __FRAME_PACER_HPP__
+#define __FRAME_PACER_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace gui {
+
+constexpr std::chrono::seconds const CPU_REPORT_PERIOD =
+    std::chrono::seconds(60);
+
+// A hidden window only waits for events. A visible one redraws on input or
+// after markDirty(), at most max_fps times a second, and otherwise sleeps
+// up to idle_wait before checking the watched sources again. ImGui needs a
+// few more frames after input to settle hover and popup state.
+struct FramePolicy {
+    int max_fps = 60;
+    std::chrono::milliseconds hidden_wait = std::chrono::seconds(1);
+    std::chrono::milliseconds idle_wait = std::chrono::milliseconds(250);
+    int frames_after_input = 3;
+};
+
+class FramePacer {
+   public:
+    // Returns a counter that changes whenever the displayed data does
+    using GenerationSource = std::function<uint64_t()>;
+
+    FramePacer(FramePacer const&) = delete;
+    FramePacer(FramePacer&&) = delete;
+    FramePacer& operator=(FramePacer const&) = delete;
+    FramePacer& operator=(FramePacer&&) = delete;
+    explicit FramePacer(FramePolicy policy = {});
+    ~FramePacer() = default;
+
+    // Safe from any thread, wakes the main loop when it is waiting
+    void markDirty();
+    void watch(GenerationSource source);
+
+    // Blocks until the next frame is due and processes pending events.
+    // Returns false when there is nothing to draw.
+    bool waitForFrame(bool hidden);
+
+    // Whole-process CPU time over wall time of the last report period
+    double cpuUsage() const { return cpu_usage.load(); }
+    std::size_t renderedFrames() const { return rendered_frames; }
+
+   private:
+    bool sourcesChanged();
+    void sampleCpu();
+    bool frameDue();
+
+    FramePolicy policy;
+    std::atomic<bool> dirty = true;
+    int frames_left = 0;
+    std::vector<std::pair<GenerationSource, uint64_t>> sources;
+    std::chrono::steady_clock::time_point last_frame;
+
+    std::chrono::steady_clock::time_point report_start;
+    std::chrono::nanoseconds report_cpu_start{};
+    std::size_t report_frames = 0;
+    std::size_t rendered_frames = 0;
+    std::atomic<double> cpu_usage = 0.0;
+};
+
+}  // namespace gui
+#endif  // !__FRAME_PACER_HPP__
@@ -10,7 +10,9 @@
 #include "core/mediators/fanMediator.hpp"
 #include "core/mediator.hpp"
 #include "core/plotStrategy.hpp"
+#include "gui/framePacer.hpp"
 #include "imgui.h"
+#include "system/fanTelemetry.hpp"
 
 namespace gui {
 class GuiManager {
@@ -31,11 +33,18 @@ class GuiManager {
         size = std::move(w_size);
     }
 
-    void updateCPUCurrentTemp(float temp) { current_cpu_temp = temp; }
-    void updateGPUCurrentTemp(float temp) { current_gpu_temp = temp; }
+    void updateCPUCurrentTemp(float temp) {
+        updateTemp(current_cpu_temp, temp);
+    }
+    void updateGPUCurrentTemp(float temp) {
+        updateTemp(current_gpu_temp, temp);
+    }
 
-    void updateCurrentFanStats(std::size_t controller_idx, std::size_t fan_idx,
-                               std::size_t speed, std::size_t rpm);
+    void setFramePacer(std::shared_ptr<FramePacer> p) { pacer = std::move(p); }
+
+    void setTelemetry(std::shared_ptr<sys::FanTelemetry const> t) {
+        telemetry = std::move(t);
+    }
 
     template <typename... Args>
     void setCallbacks(Args&&... args) {
@@ -66,6 +75,7 @@ class GuiManager {
     void renderMonitoring();
 
     static void cleanup();
+    void updateTemp(float& current, float temp);
     void printPlot(std::size_t i, std::size_t j);
 
     template <typename Name, typename Callback, typename... Rest>
@@ -104,7 +114,8 @@ class GuiManager {
         fileDialogCallbacks;
     std::unordered_map<std::string, std::vector<GeneralCallback>>
         generalCallbacks;
-    std::unordered_map<std::size_t, std::pair<std::size_t, std::size_t>> stats;
+    std::shared_ptr<sys::FanTelemetry const> telemetry;
+    std::shared_ptr<FramePacer> pacer;
     std::shared_ptr<core::Mediator> mediator;
     std::shared_ptr<sys::System> system;
     std::unordered_map<std::size_t, int> fanMods;
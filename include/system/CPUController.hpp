@@ -1,7 +1,9 @@
 #ifndef __CPU_CONTROLLER__
 #define __CPU_CONTROLLER__
 
-#include <fstream>
+#include <string>
+
+#include "system/sensorReader.hpp"
 
 namespace sys {
 class ICPUController {
@@ -30,7 +32,7 @@ class CPUController : public ICPUController {
     std::string getCPUName() override;
 
    private:
-    std::ifstream cpu_file;
+    SensorReader cpu_file;
     std::string cpu_name;
 
     bool getCPUFile();
@@ -0,0 +1,39 @@
+#ifndef __BEZIER_SOLVER_HPP__
+#define __BEZIER_SOLVER_HPP__
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+constexpr std::size_t const BEZIER_SEED_SEGMENTS = 16;
+constexpr std::size_t const BEZIER_NEWTON_MAX_ITERATIONS = 8;
+constexpr double const BEZIER_NEWTON_EPSILON = 1e-6;
+
+namespace sys {
+
+using ControlPoints = std::array<std::pair<double, double>, 4>;
+
+// Temperature to speed on a cubic Bezier curve with monotonic x. x(t) = temp
+// is solved with Newton-Raphson seeded from a coarse table of x and kept
+// inside the seed bracket, so the cost is bounded by
+// BEZIER_NEWTON_MAX_ITERATIONS evaluations.
+class BezierSolver {
+   public:
+    explicit BezierSolver(ControlPoints const& control_points);
+
+    double speedForTemp(double temp) const;
+    std::pair<double, double> pointAt(double t) const;
+
+    // Reference solver, plain bisection on x(t)
+    static double bisect(ControlPoints const& control_points, double temp);
+
+   private:
+    double xAt(double t) const;
+    double dxAt(double t) const;
+
+    ControlPoints cp;
+    std::array<double, BEZIER_SEED_SEGMENTS + 1> seed_x;
+};
+
+}  // namespace sys
+#endif  // !__BEZIER_SOLVER_HPP__
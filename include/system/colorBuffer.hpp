@@ -0,0 +1,101 @@
+#ifndef __COLOR_BUFFER_HPP__
+#define __COLOR_BUFFER_HPP__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <vector>
+
+constexpr std::size_t const COLOR_BUFFER_ALIGNMENT = 64;
+
+namespace sys {
+
+// One LED in device byte order: green, red, blue
+using LedColor = std::array<uint8_t, 3>;
+
+// Hands out memory starting on a cache line, frames never share their first
+// line with whatever was allocated before them
+template <typename T>
+struct CacheAlignedAllocator {
+    using value_type = T;
+
+    CacheAlignedAllocator() = default;
+    template <typename U>
+    CacheAlignedAllocator(CacheAlignedAllocator<U> const& /*other*/) {}  // NOLINT
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(
+            n * sizeof(T), std::align_val_t(COLOR_BUFFER_ALIGNMENT)));
+    }
+    void deallocate(T* ptr, std::size_t /*n*/) {
+        ::operator delete(ptr, std::align_val_t(COLOR_BUFFER_ALIGNMENT));
+    }
+
+    template <typename U>
+    bool operator==(CacheAlignedAllocator<U> const& /*other*/) const {
+        return true;
+    }
+};
+
+// A full frame in one block: controller after controller, fan after fan,
+// LED after LED. Fans are numbered from 0 here. Copying onto a frame of the
+// same shape reuses its storage.
+class ColorBuffer {
+   public:
+    ColorBuffer() = default;
+    ColorBuffer(std::size_t controllers_num, std::size_t fans_num,
+                std::size_t leds_num, LedColor fill = {})
+        : controllers_num(controllers_num),
+          fans_num(fans_num),
+          leds_num(leds_num),
+          colors(controllers_num * fans_num * leds_num, fill) {}
+
+    std::size_t controllersNum() const { return controllers_num; }
+    std::size_t fansNum() const { return fans_num; }
+    // LEDs on one fan
+    std::size_t ledsNum() const { return leds_num; }
+
+    LedColor& operator()(std::size_t controller_idx, std::size_t fan_idx,
+                         std::size_t led_idx) {
+        return colors[index(controller_idx, fan_idx) + led_idx];
+    }
+    LedColor const& operator()(std::size_t controller_idx, std::size_t fan_idx,
+                               std::size_t led_idx) const {
+        return colors[index(controller_idx, fan_idx) + led_idx];
+    }
+
+    std::span<LedColor> fan(std::size_t controller_idx, std::size_t fan_idx) {
+        return std::span<LedColor>(colors).subspan(
+            index(controller_idx, fan_idx), leds_num);
+    }
+    std::span<LedColor const> fan(std::size_t controller_idx,
+                                  std::size_t fan_idx) const {
+        return std::span<LedColor const>(colors).subspan(
+            index(controller_idx, fan_idx), leds_num);
+    }
+    std::span<LedColor> controller(std::size_t controller_idx) {
+        return std::span<LedColor>(colors).subspan(index(controller_idx, 0),
+                                                   fans_num * leds_num);
+    }
+    std::span<LedColor const> controller(std::size_t controller_idx) const {
+        return std::span<LedColor const>(colors).subspan(
+            index(controller_idx, 0), fans_num * leds_num);
+    }
+    std::span<LedColor> all() { return colors; }
+    std::span<LedColor const> all() const { return colors; }
+
+   private:
+    std::size_t index(std::size_t controller_idx, std::size_t fan_idx) const {
+        return (controller_idx * fans_num + fan_idx) * leds_num;
+    }
+
+    std::size_t controllers_num = 0;
+    std::size_t fans_num = 0;
+    std::size_t leds_num = 0;
+    std::vector<LedColor, CacheAlignedAllocator<LedColor>> colors;
+};
+
+}  // namespace sys
+#endif  // !__COLOR_BUFFER_HPP__
@@ -2,11 +2,72 @@
 #define __CONTROLLER_DATA_HPP__
 
 #include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
+// Curves are compiled into a lookup table over 0.0-100.0 C with 0.1 C step
+constexpr double const LUT_MAX_TEMP = 100.0;
+constexpr std::size_t const LUT_STEPS_PER_DEGREE = 10;
+constexpr std::size_t const LUT_SIZE =
+    static_cast<std::size_t>(LUT_MAX_TEMP) * LUT_STEPS_PER_DEGREE + 1;
+
 namespace sys {
 enum class MonitoringMode { MONITORING_CPU = 0, MONITORING_GPU };
+
+// Dense temperature to speed table, rebuilt only after the curve changed.
+// Edits bump a generation counter and a build remembers the one it started
+// from, so an edit that lands while a build runs is never lost.
+class SpeedLut {
+   public:
+    SpeedLut() = default;
+    ~SpeedLut() = default;
+    SpeedLut(SpeedLut const& other)
+        : table(other.table),
+          generation(other.generation.load()),
+          built(other.built) {}
+    SpeedLut& operator=(SpeedLut const& other) {
+        table = other.table;
+        generation.store(other.generation.load());
+        built = other.built;
+        return *this;
+    }
+    SpeedLut(SpeedLut&& other) noexcept
+        : table(std::move(other.table)),
+          generation(other.generation.load()),
+          built(other.built) {}
+    SpeedLut& operator=(SpeedLut&& other) noexcept {
+        table = std::move(other.table);
+        generation.store(other.generation.load());
+        built = other.built;
+        return *this;
+    }
+
+    template <typename Curve>
+    void build(Curve&& curve) {
+        uint64_t started = generation.load(std::memory_order_acquire);
+        table.resize(LUT_SIZE);
+        for (std::size_t i = 0; i < LUT_SIZE; i++) {
+            table[i] = curve(static_cast<double>(i) /
+                             static_cast<double>(LUT_STEPS_PER_DEGREE));
+        }
+        built = started;
+    }
+    double lookup(double temp) const;
+    void invalidate() { generation.fetch_add(1, std::memory_order_release); }
+    bool isDirty() const {
+        return built != generation.load(std::memory_order_acquire);
+    }
+
+   private:
+    std::vector<double> table;
+    std::atomic<uint64_t> generation = 1;
+    // The generation the table was built from
+    uint64_t built = 0;
+};
+
 class FanSpeedData {
    public:
     FanSpeedData();
@@ -16,16 +77,25 @@ class FanSpeedData {
     FanSpeedData& operator=(FanSpeedData&& d) noexcept {
         speeds = std::move(d.speeds);
         temps = std::move(d.temps);
+        lut = std::move(d.lut);
         return *this;
     }
     FanSpeedData(std::vector<double> temps, std::vector<double> speeds)
         : temps(std::move(temps)), speeds(std::move(speeds)) {}
     FanSpeedData(FanSpeedData && d) noexcept
-        : speeds(std::move(d.speeds)), temps(std::move(d.temps)) {}
+        : speeds(std::move(d.speeds)),
+          temps(std::move(d.temps)),
+          lut(std::move(d.lut)) {}
     void addSpeed(float s);
-    void setSpeeds(std::vector<double>&& s) { speeds = std::move(s); }
+    void setSpeeds(std::vector<double>&& s) {
+        speeds = std::move(s);
+        lut.invalidate();
+    }
     void addTemp(float t);
-    void setTemps(std::vector<double>&& t) { temps = std::move(t); }
+    void setTemps(std::vector<double>&& t) {
+        temps = std::move(t);
+        lut.invalidate();
+    }
     void updateData(std::vector<double> t, std::vector<double> s);
     std::vector<double>* getTData();
     std::vector<double>* getSData();
@@ -34,11 +104,15 @@ class FanSpeedData {
     void resetData() {
         temps.clear();
         speeds.clear();
+        lut.invalidate();
     }
 
    private:
+    double interpolate(double temp) const;
+
     std::vector<double> temps;
     std::vector<double> speeds;
+    SpeedLut lut;
 };
 
 class FanBezierData {
@@ -49,24 +123,24 @@ class FanBezierData {
     FanBezierData& operator=(FanBezierData const&) = default;
     FanBezierData& operator=(FanBezierData&& bd) noexcept {
         controlPoints = std::move(bd.controlPoints);
+        lut = std::move(bd.lut);
         return *this;
     }
     explicit FanBezierData(
         std::array<std::pair<double, double>, 4> control_points)
         : controlPoints(std::move(control_points)) {}
     FanBezierData(FanBezierData && bd) noexcept
-        : controlPoints(std::move(bd.controlPoints)) {}
+        : controlPoints(std::move(bd.controlPoints)), lut(std::move(bd.lut)) {}
     void addControlPoint(std::pair<double, double> const& cp);
-    auto getData() -> std::array<std::pair<double, double>, 4>&;
+    auto getData() const -> std::array<std::pair<double, double>, 4> const&;
     void setData(std::array<std::pair<double, double>, 4> const& data);
     double getSpeedForTemp(float const& temp);
     int getIdx() { return idx; }
 
    private:
-    std::pair<double, double> computeBezierAtT(double t);
-
     int idx = 0;
     std::array<std::pair<double, double>, 4> controlPoints;
+    SpeedLut lut;
 };
 
 class Fan {
@@ -0,0 +1,141 @@
+#ifndef __SIMULATED_RIING_QUAD_HPP__
+#define __SIMULATED_RIING_QUAD_HPP__
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "system/controllers/ttRiingQuadController.hpp"
+#include "system/hidapi.hpp"
+
+// hidraw keeps this many input reports per device and drops the oldest
+constexpr std::size_t const SIM_REPORT_QUEUE = 64;
+constexpr std::size_t const SIM_RESPONSE_SIZE = 8;
+
+namespace sys {
+
+// How a simulated controller behaves. The defaults are in the range of a
+// real Riing Quad on a full speed USB port.
+struct SimulationProfile {
+    // hid_write blocks this long, the device then needs response_latency
+    // per command, one command after the other
+    std::chrono::microseconds write_latency = std::chrono::microseconds(1000);
+    std::chrono::microseconds response_latency =
+        std::chrono::microseconds(2000);
+    std::chrono::microseconds latency_jitter = std::chrono::microseconds(200);
+    // RPM follows the set speed like a first order lag
+    std::chrono::milliseconds spin_time_constant =
+        std::chrono::milliseconds(1500);
+    std::size_t max_rpm = 1500;
+    // Chance per command of a PROTOCOL_FAIL answer, of no answer at all
+    // (the read times out) and of hid_write failing
+    double protocol_fail_rate = 0.0;
+    double drop_rate = 0.0;
+    double io_error_rate = 0.0;
+    uint32_t seed = 1;
+};
+
+// One controller speaking the 0x32 (set) / 0x33 (get) / 0xFE (init)
+// protocol. Thread safe like a hidraw node: one thread writes and reads,
+// tests may inspect the state from another.
+class SimulatedRiingQuad {
+   public:
+    SimulatedRiingQuad(SimulatedRiingQuad const&) = delete;
+    SimulatedRiingQuad(SimulatedRiingQuad&&) = delete;
+    SimulatedRiingQuad& operator=(SimulatedRiingQuad const&) = delete;
+    SimulatedRiingQuad& operator=(SimulatedRiingQuad&&) = delete;
+    explicit SimulatedRiingQuad(SimulationProfile const& profile);
+    ~SimulatedRiingQuad() = default;
+
+    // Same contract as hid_write / hid_read_timeout
+    int write(unsigned char const* data, std::size_t length);
+    int read(unsigned char* data, std::size_t length, int timeout_ms);
+
+    // Fans are numbered from 0 here, the protocol numbers them from 1
+    std::size_t rpm(std::size_t fan_idx);
+    uint8_t speed(std::size_t fan_idx);
+    // First LED of the fan and all of them, in GRB order
+    std::array<uint8_t, 3> color(std::size_t fan_idx);
+    std::array<LedColor, TT_RIING_QUAD_NUM_LEDS> leds(std::size_t fan_idx);
+    bool initialized();
+    std::size_t commands();
+
+   private:
+    using Clock = std::chrono::steady_clock;
+    using Response = std::array<unsigned char, SIM_RESPONSE_SIZE>;
+
+    struct Fan {
+        uint8_t speed = 0;
+        double rpm = 0;
+        std::array<LedColor, TT_RIING_QUAD_NUM_LEDS> leds{};
+    };
+    struct Report {
+        Clock::time_point ready;
+        Response data;
+    };
+
+    Response execute(std::span<unsigned char const> packet);
+    void spin(Clock::time_point now);
+    bool chance(double rate);
+
+    SimulationProfile profile;
+    std::mutex lock;
+    std::condition_variable arrived;
+    std::deque<Report> reports;
+    std::array<Fan, TT_RIING_QUAD_NUM_CHANNELS> fans{};
+    Clock::time_point busy_until;
+    Clock::time_point last_spin;
+    std::mt19937 rng;
+    std::size_t executed = 0;
+    bool init_done = false;
+};
+
+// HidApi backend that enumerates and opens simulated controllers instead of
+// hidraw nodes, so TTRiingQuadController runs unchanged without hardware
+class SimulatedHidApi : public HidApi {
+   public:
+    SimulatedHidApi(SimulatedHidApi const&) = delete;
+    SimulatedHidApi(SimulatedHidApi&&) = delete;
+    SimulatedHidApi& operator=(SimulatedHidApi const&) = delete;
+    SimulatedHidApi& operator=(SimulatedHidApi&&) = delete;
+    explicit SimulatedHidApi(std::size_t controllers_num,
+                             SimulationProfile const& profile = {});
+    ~SimulatedHidApi() override = default;
+
+    // Shared so tests can keep watching it once the backend has been moved
+    // into the controller
+    std::shared_ptr<SimulatedRiingQuad> device(std::size_t idx) const {
+        return devices[idx];
+    }
+
+   protected:
+    hid_device* openDevice(uint16_t vendor_id, uint16_t product_id,
+                           wchar_t const* serial_number) override;
+    hid_device* openDevicePath(char const* path) override;
+    void closeDevice(hid_device* dev) override;
+    int writeReport(hid_device* dev, unsigned char const* data,
+                    std::size_t length) override;
+    int readReport(hid_device* dev, unsigned char* data, std::size_t length,
+                   int timeout_ms) override;
+    std::vector<HidDeviceInfo> enumerateDevices(uint16_t vendor_id) override;
+    int deviceString(hid_device* dev, HidString kind, wchar_t* out,
+                     std::size_t length) override;
+    wchar_t const* deviceError(hid_device* dev) override;
+
+   private:
+    static SimulatedRiingQuad* simulated(hid_device* dev);
+
+    std::vector<std::shared_ptr<SimulatedRiingQuad>> devices;
+};
+
+}  // namespace sys
+#endif  // !__SIMULATED_RIING_QUAD_HPP__
@@ -1,15 +1,25 @@
 #ifndef __TT_RIING_QUAD_CONTROLLER__
 #define __TT_RIING_QUAD_CONTROLLER__
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <thread>
 #include <vector>
 
+#include "core/ringBuffer.hpp"
 #include "hidapi.h"
-#include "system/hidapi.hpp"
 #include "system/deviceController.hpp"
+#include "system/hidCommandQueue.hpp"
+#include "system/hidapi.hpp"
+#include "system/latencyHistogram.hpp"
 
 constexpr uint16_t const THERMALTAKE_VENDOR_ID = 0x264A;
 constexpr uint16_t const TT_RIING_QUAD_START_PRODUCT_ID = 0x232B;
@@ -20,6 +30,21 @@ constexpr std::size_t const TT_RIING_QUAD_NUM_CHANNELS = 5;
 constexpr std::size_t const TT_RIING_QUAD_PACKET_SIZE = 193;
 constexpr std::size_t const TT_RIING_QUAD_TIMEOUT = 250;
 constexpr std::size_t const TT_RIING_QUAD_TIMEOUT_GET = 700;
+// hidraw keeps up to 64 input reports per device
+constexpr std::size_t const TT_RIING_QUAD_REPORT_QUEUE = 64;
+// Commands written before their answers are read, well below the queue
+constexpr std::size_t const TT_RIING_QUAD_MAX_IN_FLIGHT = 32;
+// Once answers got out of step, reads this short find the queue empty
+constexpr std::size_t const TT_RIING_QUAD_DRAIN_TIMEOUT = 20;
+constexpr std::size_t const TT_RIING_QUAD_NUM_LEDS = 54;
+static_assert(TT_RIING_QUAD_NUM_LEDS <= HID_COMMAND_MAX_LEDS);
+// Submission slots per device, a few ticks worth of speed and color commands
+constexpr std::size_t const TT_RIING_QUAD_SUBMIT_CAPACITY = 256;
+
+constexpr std::chrono::milliseconds const TT_RIING_QUAD_SPEED_DEADLINE =
+    std::chrono::milliseconds(1000);
+constexpr std::chrono::milliseconds const TT_RIING_QUAD_COLOR_DEADLINE =
+    std::chrono::milliseconds(200);
 
 constexpr float const COLOR_MULTIPLIER = 255.0F;
 
@@ -52,7 +77,13 @@ enum ProtocolReturnValue : unsigned char {
     PROTOCOL_FAIL = 0xFE
 };
 
-enum ProtocolBytes : unsigned char { PROTOCOL_STATUS_BYTE = 0x02 };
+// Responses echo the type, target and port of their command
+enum ProtocolBytes : unsigned char {
+    PROTOCOL_TYPE_BYTE = 0x00,
+    PROTOCOL_TARGET_BYTE = 0x01,
+    PROTOCOL_STATUS_BYTE = 0x02,
+    PROTOCOL_PORT_BYTE = 0x03
+};
 
 enum ProtocolGetBytes : unsigned char {
     PROTOCOL_SPEED = 0x04,
@@ -74,30 +105,107 @@ class TTRiingQuadController : public DeviceController {
 #ifdef ENABLE_INFO_LOGS
         showControllersInfo();
 #endif  // ENABLE_INFO_LOGS
+        startWorkers();
+    }
+    ~TTRiingQuadController() override {
+        stopWorkers();
+        logHidStats();
     }
-    ~TTRiingQuadController() override {}
-
-    std::pair<std::size_t, std::size_t> sentToFan(std::size_t controller_idx,
-                                                  std::size_t fan_idx,
-                                                  uint value) override;
-
-    void setRGB(std::size_t controller_idx, std::size_t fan_idx,
-                std::array<uint8_t, 3>& colors) override;
 
-    std::vector<std::vector<std::array<uint8_t, 3>>> makeColorBuffer() override;
+    ColorBuffer makeColorBuffer() override;
+
+    void queueFanSpeed(std::size_t controller_idx, std::size_t fan_idx,
+                       uint value) override;
+    void queueFanStatus(std::size_t controller_idx,
+                        std::size_t fan_idx) override;
+    bool queueRGB(std::size_t controller_idx, std::size_t fan_idx,
+                  std::span<LedColor const> colors) override;
+    uint64_t colorDrops(std::size_t controller_idx,
+                        std::size_t fan_idx) override;
+    void flush(std::size_t controller_idx) override;
+    std::size_t queueDepth(std::size_t controller_idx) override;
+    void setStatusHandler(StatusHandler handler) override;
+
+    void setDeadlines(std::chrono::milliseconds speed,
+                      std::chrono::milliseconds color);
+    std::chrono::milliseconds speedDeadline() const { return speed_deadline; }
+    std::chrono::milliseconds colorDeadline() const { return color_deadline; }
+    std::size_t droppedColors(std::size_t controller_idx) const {
+        return workers[controller_idx]->dropped_colors.load();
+    }
+    std::size_t lateSpeeds(std::size_t controller_idx) const {
+        return workers[controller_idx]->late_speeds.load();
+    }
+    // Time from writing a command to reading its response, waiting behind
+    // the commands written before it in the same window included
+    LatencyHistogram const& roundTrip(std::size_t controller_idx) const {
+        return workers[controller_idx]->round_trip;
+    }
+    // Per-operation latencies, timeouts and failures of the device
+    HidStats const& hidStats(std::size_t controller_idx) const {
+        return hidapi_wrapper->stats(controller_idx);
+    }
+    void logHidStats() const { hidapi_wrapper->logStats(); }
 
-    std::size_t controllersNum() { return devices.size(); }
+    std::size_t controllersNum() override { return devices.size(); }
+    std::size_t channelsNum() override { return TT_RIING_QUAD_NUM_CHANNELS; }
 
    private:
     using device =
         std::unique_ptr<hid_device, std::function<void(hid_device*)>>;
+
+    // What came back for a command. UNMATCHED is no answer in time or the
+    // answer to another command, the reads after it are out of step.
+    enum class Answer : uint8_t { SUCCESS, FAILED, UNMATCHED };
+
+    // Everything one device needs to run on its own thread. Only the worker
+    // touches the device and the coalescing queue, other threads just push
+    // into the lock-free submission ring and bump the wake counter.
+    struct DeviceWorker {
+        explicit DeviceWorker(std::size_t idx)
+            : idx(idx), submissions(TT_RIING_QUAD_SUBMIT_CAPACITY) {}
+
+        std::size_t idx;
+        core::RingBuffer<HidCommand> submissions;
+        HidCommandQueue pending;
+        std::vector<HidCommand> batch;
+        std::vector<FanStatus> statuses;
+        std::array<std::chrono::steady_clock::time_point,
+                   TT_RIING_QUAD_MAX_IN_FLIGHT>
+            sent_at{};
+        LatencyHistogram round_trip;
+        std::atomic<std::size_t> depth = 0;
+        std::atomic<std::size_t> dropped_colors = 0;
+        // Per channel, fans are numbered from 1
+        std::array<std::atomic<uint64_t>, TT_RIING_QUAD_NUM_CHANNELS>
+            fan_color_drops{};
+        std::atomic<std::size_t> late_speeds = 0;
+        std::atomic<uint32_t> wakeups = 0;
+        std::jthread thread;
+    };
+
     void initControllers();
     void showControllersInfo();
+    void startWorkers();
+    void stopWorkers();
+    void workerLoop(std::stop_token const& stop, DeviceWorker& worker);
+    void processBatch(DeviceWorker& worker);
+    bool submit(std::size_t controller_idx, HidCommand const& cmd);
     void sendInit(device& dev);
+    void writeCommand(device& dev, HidCommand const& cmd);
+    Answer readCommandResponse(std::size_t controller_idx,
+                               HidCommand const& cmd,
+                               std::vector<FanStatus>& statuses);
+    void discardResponses(std::size_t controller_idx);
     unsigned int convertChannel(float val);
 
     std::unique_ptr<HidApi> hidapi_wrapper;
     std::vector<device> devices;
+    std::vector<std::unique_ptr<DeviceWorker>> workers;
+    std::mutex handler_lock;
+    StatusHandler status_handler;
+    std::chrono::milliseconds speed_deadline = TT_RIING_QUAD_SPEED_DEADLINE;
+    std::chrono::milliseconds color_deadline = TT_RIING_QUAD_COLOR_DEADLINE;
 };
 
 }  // namespace sys
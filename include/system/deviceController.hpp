@@ -6,11 +6,21 @@
 
 #include <cstdint>
 #include <cstring>
+#include <functional>
+#include <span>
 #include <utility>
 #include <vector>
 
+#include "system/colorBuffer.hpp"
+
 namespace sys {
 
+struct FanStatus {
+    std::size_t fan_idx;
+    std::size_t speed;
+    std::size_t rpm;
+};
+
 class DeviceController {
    public:
     DeviceController(DeviceController const&) = default;
@@ -18,10 +28,34 @@ class DeviceController {
     DeviceController& operator=(DeviceController const&) = default;
     DeviceController& operator=(DeviceController&&) = delete;
     virtual ~DeviceController() = default;
-    virtual std::pair<std::size_t, std::size_t> sentToFan(std::size_t controller_idx, std::size_t fan_idx,
-                           uint value) = 0;
-    virtual void setRGB(std::size_t controller_idx, std::size_t fan_idx, std::array<uint8_t, 3>& colors) = 0;
-    virtual std::vector<std::vector<std::array<uint8_t, 3>>> makeColorBuffer() = 0;
+    using StatusHandler =
+        std::function<void(std::size_t controller_idx, FanStatus const&)>;
+
+    // A frame shaped for every LED of every fan of every controller
+    virtual ColorBuffer makeColorBuffer() = 0;
+
+    virtual std::size_t controllersNum() = 0;
+    virtual std::size_t channelsNum() = 0;
+
+    // Commands are only submitted here, nothing reaches the device until
+    // flush() wakes the I/O worker of the controller. Fan statuses requested
+    // with queueFanStatus() are delivered through the status handler on the
+    // worker thread.
+    virtual void queueFanSpeed(std::size_t controller_idx, std::size_t fan_idx,
+                               uint value) = 0;
+    virtual void queueFanStatus(std::size_t controller_idx,
+                                std::size_t fan_idx) = 0;
+    // One color per LED of the fan, ColorBuffer::fan() of a frame from
+    // makeColorBuffer(). False when the frame was dropped right away.
+    virtual bool queueRGB(std::size_t controller_idx, std::size_t fan_idx,
+                          std::span<LedColor const> colors) = 0;
+    // Bumped whenever an accepted frame of the fan is dropped later on, e.g.
+    // past its deadline, so the caller knows to send it again
+    virtual uint64_t colorDrops(std::size_t controller_idx,
+                                std::size_t fan_idx) = 0;
+    virtual void flush(std::size_t controller_idx) = 0;
+    virtual std::size_t queueDepth(std::size_t controller_idx) = 0;
+    virtual void setStatusHandler(StatusHandler handler) = 0;
 
    protected:
     DeviceController() = default;
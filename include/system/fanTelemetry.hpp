@@ -0,0 +1,49 @@
+#ifndef __FAN_TELEMETRY_HPP__
+#define __FAN_TELEMETRY_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace sys {
+
+struct FanSample {
+    std::size_t speed;
+    std::size_t rpm;
+    bool valid;
+};
+
+// Latest speed and RPM of every fan. Each fan is one packed 64-bit atomic,
+// so the poller can publish and any thread can read without locking.
+class FanTelemetry {
+   public:
+    FanTelemetry(FanTelemetry const&) = delete;
+    FanTelemetry(FanTelemetry&&) = delete;
+    FanTelemetry& operator=(FanTelemetry const&) = delete;
+    FanTelemetry& operator=(FanTelemetry&&) = delete;
+    FanTelemetry(std::size_t controllers_num, std::size_t channels_num);
+    ~FanTelemetry() = default;
+
+    void store(std::size_t controller_idx, std::size_t fan_idx,
+               std::size_t speed, std::size_t rpm);
+    FanSample load(std::size_t controller_idx, std::size_t fan_idx) const;
+
+    // Bumped whenever a store changes a sample, readers compare it to skip
+    // work when nothing moved
+    uint64_t generation() const {
+        return generation_counter.load(std::memory_order_acquire);
+    }
+
+    std::size_t controllersNum() const { return controllers_num; }
+    std::size_t channelsNum() const { return channels_num; }
+
+   private:
+    std::size_t controllers_num;
+    std::size_t channels_num;
+    std::unique_ptr<std::atomic<uint64_t>[]> slots;
+    std::atomic<uint64_t> generation_counter = 0;
+};
+
+}  // namespace sys
+#endif  // !__FAN_TELEMETRY_HPP__
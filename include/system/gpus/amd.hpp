@@ -1,9 +1,10 @@
 #ifndef __AMD_HPP__
 #define __AMD_HPP__
 
-#include <fstream>
+#include <string>
 
 #include "system/gpu.hpp"
+#include "system/sensorReader.hpp"
 
 namespace sys {
 
@@ -22,7 +23,7 @@ class AMD : public GPU {
    private:
     void findGPUTempFile(std::string const& card);
     bool calculateGPUName();
-    std::ifstream gpu_temp_file;
+    SensorReader gpu_temp_file;
 };
 
 }  // namespace sys
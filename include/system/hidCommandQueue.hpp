@@ -0,0 +1,68 @@
+#ifndef __HID_COMMAND_QUEUE_HPP__
+#define __HID_COMMAND_QUEUE_HPP__
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "system/colorBuffer.hpp"
+
+// Room for the per-LED colors of one fan, a Riing Quad fan has 54 LEDs
+constexpr std::size_t const HID_COMMAND_MAX_LEDS = 54;
+
+namespace sys {
+
+using FanLedColors = std::array<LedColor, HID_COMMAND_MAX_LEDS>;
+
+enum class HidCommandType { SPEED, STATUS, RGB };
+
+struct HidCommand {
+    HidCommandType type;
+    std::size_t fan_idx;
+    unsigned int speed;
+    FanLedColors colors;
+    std::chrono::steady_clock::time_point deadline;
+};
+
+// Pending commands of one controller for the current tick. Commands for the
+// same fan are coalesced (the newest wins), speed writes are always batched
+// before status reads and color frames, and a color frame that missed its
+// deadline is dropped because a fresher one is already on the way.
+class HidCommandQueue {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    void pushSpeed(std::size_t fan_idx, unsigned int speed,
+                   Clock::time_point deadline);
+    void pushStatus(std::size_t fan_idx, Clock::time_point deadline);
+    void pushColor(std::size_t fan_idx, FanLedColors const& colors,
+                   Clock::time_point deadline);
+    void takeBatch(Clock::time_point now, std::vector<HidCommand>& batch);
+
+    std::size_t depth() const {
+        return speedDepth() + statusDepth() + colorDepth();
+    }
+    std::size_t speedDepth() const { return speeds.size(); }
+    std::size_t statusDepth() const { return statuses.size(); }
+    std::size_t colorDepth() const { return colors.size(); }
+    std::size_t droppedColors() const { return dropped_colors; }
+    // Fans whose color frame the last takeBatch() dropped
+    std::vector<std::size_t> const& droppedFans() const { return dropped_fans; }
+    std::size_t lateSpeeds() const { return late_speeds; }
+
+   private:
+    static void coalesce(std::vector<HidCommand>& pending,
+                         HidCommand const& cmd);
+
+    std::vector<HidCommand> speeds;
+    std::vector<HidCommand> statuses;
+    std::vector<HidCommand> colors;
+    std::vector<std::size_t> dropped_fans;
+    std::size_t dropped_colors = 0;
+    std::size_t late_speeds = 0;
+};
+
+}  // namespace sys
+#endif  // !__HID_COMMAND_QUEUE_HPP__
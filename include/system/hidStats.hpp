@@ -0,0 +1,27 @@
+#ifndef __HID_STATS_HPP__
+#define __HID_STATS_HPP__
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "system/latencyHistogram.hpp"
+
+namespace sys {
+
+// What one HID device costs us. Updated with relaxed atomics from the thread
+// doing the I/O, readable from anywhere.
+struct HidStats {
+    LatencyHistogram write;  // hid_write
+    LatencyHistogram read;   // hid_read / hid_read_timeout
+    std::atomic<uint64_t> timeouts = 0;
+    std::atomic<uint64_t> protocol_failures = 0;
+    std::atomic<uint64_t> io_errors = 0;
+};
+
+// One line for the log, e.g.
+// "write p50 64us p99 128us n=10 | read p50 .. | timeouts 0 | ..."
+std::string summarize(HidStats const& stats);
+
+}  // namespace sys
+#endif  // !__HID_STATS_HPP__
@@ -3,17 +3,28 @@
 
 #include <stdint.h>
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <codecvt>
+#include <cstring>
 #include <functional>
 #include <generator>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
+#include <vector>
 
 #include "core/logger.hpp"
 #include "hidapi.h"
+#include "system/hidStats.hpp"
 
 constexpr std::size_t const MAX_STR = 256;
+// Devices beyond this still work, they are just not measured
+constexpr std::size_t const HID_MAX_DEVICES = 16;
 
 template <typename T>
 struct IsStdArrayOfUchar : std::false_type {};
@@ -24,14 +35,33 @@ struct IsStdArrayOfUchar<std::array<unsigned char, N>> : std::true_type {};
 template <typename T>
 inline constexpr bool IS_STD_ARRAY_OF_UCHAR_V = IsStdArrayOfUchar<T>::value;
 
+template <typename T>
+struct IsSpan : std::false_type {};
+
+template <typename T, std::size_t Extent>
+struct IsSpan<std::span<T, Extent>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool IS_SPAN_V = IsSpan<T>::value;
+
 template <typename T>
 inline constexpr bool ALWAYS_FALSE_V = false;
 
 namespace sys {
 
+struct HidDeviceInfo {
+    std::string path;
+    uint16_t product_id;
+};
+
+enum class HidString { MANUFACTURER, PRODUCT };
+
+// Packet assembly, statistics and error handling on top of hidapi. The raw
+// device calls are virtual so a simulated backend can stand in for the
+// library, see SimulatedHidApi.
 class HidApi {
    public:
-    HidApi() {
+    HidApi() : initialized(true) {
         int ret = hid_init();
 
         if (ret != 0) {
@@ -39,28 +69,28 @@ class HidApi {
         }
     }
 
-    ~HidApi() { hid_exit(); }
+    virtual ~HidApi() {
+        if (initialized) {
+            hid_exit();
+        }
+    }
 
     template <uint16_t vendorId>
     std::unique_ptr<hid_device, std::function<void(hid_device*)>> makeDevice(
         uint16_t pid, std::wstring_view serial_number = {}) {
         auto empty = serial_number.empty();
-        auto deleter = [](hid_device* dev) {
-            if (dev != nullptr) {
-                hid_close(dev);
-            }
-        };
         std::unique_ptr<hid_device, std::function<void(hid_device*)>> dev(
-            hid_open(vendorId, pid, empty ? NULL : serial_number.data()),
-            deleter);
+            openDevice(vendorId, pid, empty ? NULL : serial_number.data()),
+            deleter());
 
         if (dev.get() == NULL) {
             throw std::runtime_error(
-                constructError("Failed hid_open: ", hid_error(NULL)));
+                constructError("Failed hid_open: ", deviceError(NULL)));
         }
 
-        core::Logger::log(core::LogLevel::INFO)
+        LOG_INFO(core::LogModule::HID)
             << "Maked device with product_id " << pid << std::endl;
+        registerDevice(dev.get(), "pid " + std::to_string(pid));
 
         return dev;
     }
@@ -68,21 +98,17 @@ class HidApi {
     template <uint16_t vendorId>
     std::unique_ptr<hid_device, std::function<void(hid_device*)>> makeDevice(
         char const* path) {
-        auto deleter = [](hid_device* dev) {
-            if (dev != nullptr) {
-                hid_close(dev);
-            }
-        };
         std::unique_ptr<hid_device, std::function<void(hid_device*)>> dev(
-            hid_open_path(path), deleter);
+            openDevicePath(path), deleter());
 
         if (dev.get() == NULL) {
             throw std::runtime_error(
-                constructError("Failed hid_open_path: ", hid_error(NULL)));
+                constructError("Failed hid_open_path: ", deviceError(NULL)));
         }
 
-        core::Logger::log(core::LogLevel::INFO)
+        LOG_INFO(core::LogModule::HID)
             << "Maked device with path " << path << std::endl;
+        registerDevice(dev.get(), path);
 
         return dev;
     }
@@ -100,10 +126,21 @@ class HidApi {
             for (auto b : value) {
                 buf[offset++] = b;
             }
+        } else if constexpr (IS_SPAN_V<CleanU>) {
+            // Raw bytes of the elements, e.g. the LED colors of a fan
+            static_assert(
+                std::is_trivially_copyable_v<typename CleanU::element_type>,
+                "Spans in appendBytes must hold plain bytes");
+            if (offset + value.size_bytes() > buf.size()) {
+                throw std::runtime_error(
+                    "Too many bytes for the given packet_size");
+            }
+            std::memcpy(buf.data() + offset, value.data(), value.size_bytes());
+            offset += value.size_bytes();
         } else {
             static_assert(ALWAYS_FALSE_V<U>,
-                          "Unsupported type in appendBytes (must be integral "
-                          "or array<unsigned char, N>)");
+                          "Unsupported type in appendBytes (must be integral, "
+                          "array<unsigned char, N> or span)");
         }
     }
 
@@ -126,12 +163,18 @@ class HidApi {
             throw std::runtime_error(
                 "Too many bytes for the given packet_size");
         }
-        int ret = 0;
-
-        ret = hid_write(dev.get(), usb_buf.data(), packet_size);
+        HidStats* stats = statsFor(dev.get());
+        auto start = std::chrono::steady_clock::now();
+        int ret = writeReport(dev.get(), usb_buf.data(), packet_size);
+        if (stats != nullptr) {
+            stats->write.record(std::chrono::steady_clock::now() - start);
+        }
         if (ret == -1) {
+            if (stats != nullptr) {
+                stats->io_errors.fetch_add(1, std::memory_order_relaxed);
+            }
             throw std::runtime_error(
-                constructError("Failed hid_write: ", hid_error(dev.get())));
+                constructError("Failed hid_write: ", deviceError(dev.get())));
         }
     }
 
@@ -141,30 +184,81 @@ class HidApi {
         std::array<unsigned char, packet_size> response{0};
         int ret = 0;
 
-        if (timeout == 0) {
-            ret = hid_read(dev.get(), response.data(), packet_size);
-        } else {
-            ret = hid_read_timeout(dev.get(), response.data(), packet_size,
-                                   timeout);
+        HidStats* stats = statsFor(dev.get());
+        auto start = std::chrono::steady_clock::now();
+        // hidapi blocks on -1
+        ret = readReport(dev.get(), response.data(), packet_size,
+                         timeout == 0 ? -1 : static_cast<int>(timeout));
+        if (stats != nullptr) {
+            stats->read.record(std::chrono::steady_clock::now() - start);
+            // Nothing arrived in time, the caller gets an all zero response
+            if (ret == 0 && timeout != 0) {
+                stats->timeouts.fetch_add(1, std::memory_order_relaxed);
+            }
         }
         if (ret == -1) {
+            if (stats != nullptr) {
+                stats->io_errors.fetch_add(1, std::memory_order_relaxed);
+            }
             throw std::runtime_error(constructError("Failed hid_read_timeout: ",
-                                                    hid_error(dev.get())));
+                                                    deviceError(dev.get())));
         }
 
         return response;
     }
 
+    // Reads and drops input reports until none arrives within timeout, at
+    // most max_reports of them, e.g. answers to commands the caller gave up
+    // on. Not counted in the statistics. Returns how many were dropped.
+    template <std::size_t packet_size, std::size_t timeout>
+    std::size_t discardResponses(
+        std::unique_ptr<hid_device, std::function<void(hid_device*)>>& dev,
+        std::size_t max_reports) {
+        std::array<unsigned char, packet_size> response{0};
+        std::size_t discarded = 0;
+        while (discarded < max_reports &&
+               readReport(dev.get(), response.data(), packet_size,
+                          static_cast<int>(timeout)) > 0) {
+            discarded++;
+        }
+        return discarded;
+    }
+
+    // Protocols know which status byte means failure, HidApi does not
+    void recordProtocolFailure(
+        std::unique_ptr<hid_device, std::function<void(hid_device*)>>& dev) {
+        if (HidStats* stats = statsFor(dev.get())) {
+            stats->protocol_failures.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Devices are numbered in the order makeDevice opened them
+    std::size_t measuredDevices() const {
+        return measured_num.load(std::memory_order_acquire);
+    }
+    HidStats const& stats(std::size_t device_idx) const {
+        return device_stats[device_idx];
+    }
+    std::string const& deviceLabel(std::size_t device_idx) const {
+        return device_labels[device_idx];
+    }
+
+    void logStats() const {
+        for (std::size_t i = 0; i < measuredDevices(); i++) {
+            LOG_INFO(core::LogModule::HID)
+                << "HID device " << i << " (" << device_labels[i]
+                << "): " << summarize(device_stats[i]) << std::endl;
+        }
+    }
+
     template <uint16_t vendorId, std::size_t N>
     std::generator<uint16_t> getHidEnumerationGeneratorPids(std::array<uint16_t, N> const PRODUCT_IDS) {
         auto devs = getHidEnumeration<vendorId>();
-        hid_device_info* tmp = devs.get();
 
-        while (tmp != nullptr) {
-            if (std::find(PRODUCT_IDS.begin(), PRODUCT_IDS.end(), tmp->product_id) != PRODUCT_IDS.end()) {
-                co_yield tmp->product_id;
+        for (auto const& info : devs) {
+            if (std::find(PRODUCT_IDS.begin(), PRODUCT_IDS.end(), info.product_id) != PRODUCT_IDS.end()) {
+                co_yield info.product_id;
             }
-            tmp = tmp->next;
         }
     }
 
@@ -172,13 +266,11 @@ class HidApi {
     std::generator<char const*> getHidEnumerationGeneratorPaths(
         std::array<uint16_t, N> const PRODUCT_IDS) {
         auto devs = getHidEnumeration<vendorId>();
-        hid_device_info* tmp = devs.get();
 
-        while (tmp != nullptr) {
-            if (std::find(PRODUCT_IDS.begin(), PRODUCT_IDS.end(), tmp->product_id) != PRODUCT_IDS.end()) {
-                co_yield tmp->path;
+        for (auto const& info : devs) {
+            if (std::find(PRODUCT_IDS.begin(), PRODUCT_IDS.end(), info.product_id) != PRODUCT_IDS.end()) {
+                co_yield info.path.c_str();
             }
-            tmp = tmp->next;
         }
     }
     template <std::size_t NUM_CHANNELS>
@@ -187,32 +279,104 @@ class HidApi {
         std::array<wchar_t, MAX_STR> name_string{};
         int ret = 0;
 
-        ret =
-            hid_get_manufacturer_string(dev.get(), name_string.data(), MAX_STR);
+        ret = deviceString(dev.get(), HidString::MANUFACTURER,
+                           name_string.data(), MAX_STR);
         if (ret == -1) {
             throw std::runtime_error(constructError(
-                "Failed hid_get_manufacturer_string: ", hid_error(dev.get())));
+                "Failed hid_get_manufacturer_string: ", deviceError(dev.get())));
         }
 
         std::wprintf(L"Name: %s\n", name_string.data());  // NOLINT
         std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> converter;
-        core::Logger::log(core::LogLevel::INFO)
+        LOG_INFO(core::LogModule::HID)
             << "Name: " << converter.to_bytes(name_string.data())
             << std::endl;  // NOLINT
 
-        ret = hid_get_product_string(dev.get(), name_string.data(), MAX_STR);
+        ret = deviceString(dev.get(), HidString::PRODUCT, name_string.data(),
+                           MAX_STR);
         if (ret == -1) {
             throw std::runtime_error(constructError(
-                "Failed hid_get_product_string: ", hid_error(dev.get())));
+                "Failed hid_get_product_string: ", deviceError(dev.get())));
         }
 
         std::wprintf(L"Prod Name: %s\n", name_string.data());  // NOLINT
-        core::Logger::log(core::LogLevel::INFO)
+        LOG_INFO(core::LogModule::HID)
             << "Prod Name: " << converter.to_bytes(name_string.data())
             << std::endl;  // NOLINT
     }
 
+   protected:
+    // For backends that do not talk to hidapi at all
+    struct NoInit {};
+    explicit HidApi(NoInit /*unused*/) {}
+
+    virtual hid_device* openDevice(uint16_t vendor_id, uint16_t product_id,
+                                   wchar_t const* serial_number) {
+        return hid_open(vendor_id, product_id, serial_number);
+    }
+    virtual hid_device* openDevicePath(char const* path) {
+        return hid_open_path(path);
+    }
+    virtual void closeDevice(hid_device* dev) { hid_close(dev); }
+    virtual int writeReport(hid_device* dev, unsigned char const* data,
+                            std::size_t length) {
+        return hid_write(dev, data, length);
+    }
+    // timeout_ms -1 blocks until a report arrives, 0 on timeout
+    virtual int readReport(hid_device* dev, unsigned char* data,
+                           std::size_t length, int timeout_ms) {
+        return hid_read_timeout(dev, data, length, timeout_ms);
+    }
+    virtual std::vector<HidDeviceInfo> enumerateDevices(uint16_t vendor_id) {
+        std::unique_ptr<hid_device_info, void (*)(hid_device_info*)> devs(
+            hid_enumerate(vendor_id, 0), hid_free_enumeration);
+        std::vector<HidDeviceInfo> result;
+        for (auto* tmp = devs.get(); tmp != nullptr; tmp = tmp->next) {
+            result.push_back({tmp->path, tmp->product_id});
+        }
+        return result;
+    }
+    virtual int deviceString(hid_device* dev, HidString kind, wchar_t* out,
+                             std::size_t length) {
+        return kind == HidString::MANUFACTURER
+                   ? hid_get_manufacturer_string(dev, out, length)
+                   : hid_get_product_string(dev, out, length);
+    }
+    virtual wchar_t const* deviceError(hid_device* dev) {
+        return hid_error(dev);
+    }
+
    private:
+    std::function<void(hid_device*)> deleter() {
+        return [this](hid_device* dev) {
+            if (dev != nullptr) {
+                closeDevice(dev);
+            }
+        };
+    }
+
+    void registerDevice(hid_device* dev, std::string label) {
+        std::lock_guard<std::mutex> lock(register_lock);
+        std::size_t idx = measured_num.load(std::memory_order_relaxed);
+        if (idx == HID_MAX_DEVICES) {
+            return;
+        }
+        device_labels[idx] = std::move(label);
+        measured_devices[idx].store(dev, std::memory_order_relaxed);
+        measured_num.store(idx + 1, std::memory_order_release);
+    }
+
+    // A short scan instead of a map keeps the I/O path free of locks
+    HidStats* statsFor(hid_device* dev) {
+        std::size_t n = measured_num.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < n; i++) {
+            if (measured_devices[i].load(std::memory_order_relaxed) == dev) {
+                return &device_stats[i];
+            }
+        }
+        return nullptr;
+    }
+
     HidApi(HidApi const&) = default;
     HidApi(HidApi&&) = delete;
     HidApi& operator=(HidApi const&) = default;
@@ -225,25 +389,26 @@ class HidApi {
         return err_msg;
     }
 
-    template <uint16_t vendorId, uint16_t productId = 0>
+    template <uint16_t vendorId>
     auto getHidEnumeration() {
-        auto deleter = [](hid_device_info* devs) {
-            if (devs != nullptr) {
-                hid_free_enumeration(devs);
-            }
-        };
-        std::unique_ptr<hid_device_info, decltype(deleter)> devs(
-            hid_enumerate(vendorId, productId), deleter);
+        auto devs = enumerateDevices(vendorId);
 
-        if (devs.get() == nullptr) {
+        if (devs.empty()) {
             throw std::runtime_error(
-                constructError("Failed hid_enumerate: ", hid_error(NULL)));
+                constructError("Failed hid_enumerate: ", deviceError(NULL)));
         }
 
-        core::Logger::log(core::LogLevel::INFO)
+        LOG_INFO(core::LogModule::HID)
             << "Get hid_enumerate" << std::endl;
         return devs;
     }
+
+    bool initialized = false;
+    std::mutex register_lock;
+    std::array<std::atomic<hid_device*>, HID_MAX_DEVICES> measured_devices{};
+    std::array<std::string, HID_MAX_DEVICES> device_labels;
+    std::array<HidStats, HID_MAX_DEVICES> device_stats;
+    std::atomic<std::size_t> measured_num = 0;
 };
 
 }  // namespace sys
@@ -0,0 +1,60 @@
+#ifndef __LATENCY_HISTOGRAM_HPP__
+#define __LATENCY_HISTOGRAM_HPP__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Every power of two of microseconds is split into this many linear buckets,
+// so a reported value is at most 25% above the real one
+constexpr std::size_t const HISTOGRAM_SUB_BUCKET_BITS = 2;
+constexpr std::size_t const HISTOGRAM_SUB_BUCKETS = 1U
+                                                    << HISTOGRAM_SUB_BUCKET_BITS;
+// 1 us up to 2^25 us (~33 s), anything longer lands in the last bucket
+constexpr std::size_t const HISTOGRAM_MAGNITUDES = 24;
+constexpr std::size_t const HISTOGRAM_BUCKETS =
+    HISTOGRAM_MAGNITUDES * HISTOGRAM_SUB_BUCKETS;
+
+namespace sys {
+
+// Log-linear latency histogram in the spirit of HdrHistogram. Recording is
+// a handful of relaxed atomic increments, so any thread may record while
+// others read; readers may see a sample in count() before its bucket.
+class LatencyHistogram {
+   public:
+    LatencyHistogram(LatencyHistogram const&) = delete;
+    LatencyHistogram(LatencyHistogram&&) = delete;
+    LatencyHistogram& operator=(LatencyHistogram const&) = delete;
+    LatencyHistogram& operator=(LatencyHistogram&&) = delete;
+    LatencyHistogram() = default;
+    ~LatencyHistogram() = default;
+
+    void record(std::chrono::nanoseconds latency);
+
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    std::chrono::nanoseconds sum() const {
+        return std::chrono::nanoseconds(sum_ns.load(std::memory_order_relaxed));
+    }
+    // Samples of at most bound, what an OpenMetrics le bucket counts. Exact
+    // when bound is a bucket limit, as every power of two of microseconds is,
+    // otherwise rounded down to the bucket below.
+    uint64_t countAtMost(std::chrono::microseconds bound) const;
+    // Upper bound of the bucket holding the q-th quantile, zero when empty
+    std::chrono::microseconds percentile(double q) const;
+
+    // Whole microseconds below bucketLimit(idx) and at or above the limit of
+    // the bucket before. record() files a sample under its duration rounded
+    // up minus one, so a bucket holds samples up to and including its limit.
+    static std::size_t bucketIndex(uint64_t micros);
+    static uint64_t bucketLimit(std::size_t idx);
+
+   private:
+    std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> buckets{};
+    std::atomic<uint64_t> total = 0;
+    std::atomic<uint64_t> sum_ns = 0;
+};
+
+}  // namespace sys
+#endif  // !__LATENCY_HISTOGRAM_HPP__
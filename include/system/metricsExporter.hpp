@@ -0,0 +1,122 @@
+#ifndef __METRICS_EXPORTER_HPP__
+#define __METRICS_EXPORTER_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "system/latencyHistogram.hpp"
+#include "system/telemetrySink.hpp"
+
+// Values are zero padded to a fixed width, so an update rewrites its bytes
+// in place and the rest of the page never moves
+constexpr std::size_t const METRICS_VALUE_WIDTH = 24;
+constexpr std::size_t const METRICS_MAX_REQUEST = 4096;
+constexpr std::chrono::milliseconds const METRICS_IO_TIMEOUT =
+    std::chrono::milliseconds(500);
+// Exported histogram buckets, 2^4 us (16 us) up to 2^20 us (~1 s)
+constexpr std::size_t const METRICS_FIRST_BUCKET_POW = 4;
+constexpr std::size_t const METRICS_LAST_BUCKET_POW = 20;
+constexpr char const* const METRICS_CONTENT_TYPE =
+    "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+namespace sys {
+
+using MetricSource = std::function<double()>;
+
+// Serves GET /metrics in OpenMetrics text format on 127.0.0.1. The page is
+// laid out once by start(); a scrape only reformats the values whose source
+// changed since the previous one and sends the buffer as it is.
+//
+// Temperatures, target speeds and fan readings come in as a TelemetrySink,
+// which only stores into atomics. Everything else is pulled from sources
+// registered before start().
+class MetricsExporter : public TelemetrySink {
+   public:
+    MetricsExporter(MetricsExporter const&) = delete;
+    MetricsExporter(MetricsExporter&&) = delete;
+    MetricsExporter& operator=(MetricsExporter const&) = delete;
+    MetricsExporter& operator=(MetricsExporter&&) = delete;
+    // Port 0 picks a free one, see port()
+    MetricsExporter(uint16_t port, std::size_t controllers_num,
+                    std::size_t channels_num);
+    ~MetricsExporter() override;
+
+    // labels are rendered as given, e.g. controller="0"
+    void addCounter(std::string const& name, std::string const& help,
+                    std::string const& labels, MetricSource source);
+    void addGauge(std::string const& name, std::string const& help,
+                  std::string const& labels, MetricSource source,
+                  int precision = 0);
+    void addHistogram(std::string const& name, std::string const& help,
+                      std::string const& labels,
+                      std::shared_ptr<LatencyHistogram const> histogram);
+    void start();
+
+    // The page a scrape would get right now
+    std::string render();
+    uint16_t port() const { return bound_port; }
+
+    void publishTemperatures(float cpu_temp, float gpu_temp) override;
+    void publishTarget(std::size_t controller_idx, std::size_t fan_idx,
+                       float speed) override;
+    void publishStatus(std::size_t controller_idx, std::size_t fan_idx,
+                       std::size_t speed, std::size_t rpm) override;
+
+   private:
+    struct Series {
+        std::string sample;  // name with labels
+        MetricSource source;
+        int precision;
+    };
+    struct Family {
+        std::string name;
+        std::string type;
+        std::string help;
+        std::vector<Series> series;
+    };
+    struct Slot {
+        std::size_t offset;
+        MetricSource source;
+        int precision;
+        double value;
+    };
+
+    Family& family(std::string const& name, std::string const& type,
+                   std::string const& help);
+    std::size_t fanSlot(std::size_t controller_idx, std::size_t fan_idx) const;
+    void layout();
+    void refresh();
+    void writeValue(Slot const& slot);
+    void serve(std::stop_token const& stop);
+    void answer(int fd);
+
+    std::size_t controllers_num;
+    std::size_t channels_num;
+    std::atomic<float> cpu_temp = 0;
+    std::atomic<float> gpu_temp = 0;
+    std::unique_ptr<std::atomic<float>[]> targets;
+    std::unique_ptr<std::atomic<uint32_t>[]> speeds;
+    std::unique_ptr<std::atomic<uint32_t>[]> rpms;
+
+    std::vector<Family> families;
+    std::mutex page_lock;
+    std::string page;
+    std::vector<Slot> slots;
+
+    int listen_fd = -1;
+    int wake_fd = -1;
+    uint16_t bound_port = 0;
+    std::jthread thread;
+};
+
+}  // namespace sys
+#endif  // !__METRICS_EXPORTER_HPP__
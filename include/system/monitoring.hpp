@@ -1,9 +1,13 @@
 #ifndef __MONITORING_HPP__
 #define __MONITORING_HPP__
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <thread>
 #include <vector>
@@ -11,9 +15,22 @@
 #include "core/observer.hpp"
 #include "system/CPUController.hpp"
 #include "system/GPUController.hpp"
+#include "system/telemetrySink.hpp"
 
 namespace sys {
 
+// Sampling is fast while the temperature moves faster than slope_threshold
+// (C per second) and backs off towards idle_interval while it is stable.
+// Observers are only notified when a reading leaves the deadband around the
+// last notified value, or when the last notification is older than max_age.
+struct SamplingPolicy {
+    std::chrono::milliseconds fast_interval = std::chrono::milliseconds(500);
+    std::chrono::milliseconds idle_interval = std::chrono::seconds(8);
+    float slope_threshold = 0.5F;
+    float deadband = 1.0F;
+    std::chrono::milliseconds max_age = std::chrono::seconds(60);
+};
+
 class Monitoring {
    public:
     Monitoring(Monitoring&&) = delete;
@@ -21,8 +38,12 @@ class Monitoring {
     Monitoring& operator=(Monitoring&&) = delete;
     Monitoring(std::unique_ptr<ICPUController> cpu_p,
                std::unique_ptr<IGPUController> gpu_p,
-               std::chrono::milliseconds interval = std::chrono::seconds(1))
-        : cpu(std::move(cpu_p)), gpu(std::move(gpu_p)), interval(interval) {
+               std::chrono::milliseconds interval = std::chrono::seconds(1),
+               SamplingPolicy policy = {})
+        : cpu(std::move(cpu_p)),
+          gpu(std::move(gpu_p)),
+          interval(interval),
+          policy(policy) {
         update();
         start();
     }
@@ -35,20 +56,46 @@ class Monitoring {
     void notifyTempChanged(float temp, core::EventType event);
     std::string getGpuName();
     std::string getCpuName();
+    // The next sample goes to the observers whatever the deadband says, for
+    // when curves, modes or the config changed. Takes a sample right away.
+    void refresh();
+    void setSamplingPolicy(SamplingPolicy const& p);
+    // Every sample is published there, not only the notified ones
+    void setSink(std::shared_ptr<TelemetrySink> s);
+    std::chrono::milliseconds currentInterval() const {
+        return current_interval.load();
+    }
 
    private:
     void start();
     void stop();
     void monitoringLoop();
     void update();
+    void notifyIfChanged(float temp, SamplingPolicy const& p,
+                         std::optional<float>& last_notified,
+                         std::chrono::steady_clock::time_point& notified_at,
+                         core::EventType event);
+    std::chrono::milliseconds nextInterval(float slope,
+                                           SamplingPolicy const& p) const;
 
-    int cpu_temp{};
-    int gpu_temp{};
+    float cpu_temp{};
+    float gpu_temp{};
+    std::optional<float> cpu_notified;
+    std::optional<float> gpu_notified;
+    std::chrono::steady_clock::time_point cpu_notified_at;
+    std::chrono::steady_clock::time_point gpu_notified_at;
+    std::chrono::steady_clock::time_point last_sample;
     std::string cpu_name;
     std::atomic<bool> running = true;
     std::thread monitoring_thread;
     std::mutex observer_lock;
+    std::mutex wait_lock;
+    std::condition_variable wake;
+    bool refresh_requested = false;
     std::chrono::milliseconds interval = std::chrono::seconds(1);
+    std::atomic<std::chrono::milliseconds> current_interval = interval;
+    SamplingPolicy policy;
+    std::shared_ptr<TelemetrySink> sink;
     std::vector<std::shared_ptr<core::Observer>> observers;
     std::unique_ptr<IGPUController> gpu;
     std::unique_ptr<ICPUController> cpu;
@@ -0,0 +1,34 @@
+#ifndef __SENSOR_READER_HPP__
+#define __SENSOR_READER_HPP__
+
+#include <cstddef>
+#include <string>
+
+constexpr std::size_t const SENSOR_READ_BUFFER_SIZE = 32;
+
+namespace sys {
+
+// Integer sysfs attribute kept open for its whole lifetime. Every read is a
+// single pread() at offset 0 into a stack buffer, so polling a sensor does
+// not allocate or seek.
+class SensorReader {
+   public:
+    SensorReader() = default;
+    explicit SensorReader(std::string const& path);
+    SensorReader(SensorReader const&) = delete;
+    SensorReader& operator=(SensorReader const&) = delete;
+    SensorReader(SensorReader&& other) noexcept;
+    SensorReader& operator=(SensorReader&& other) noexcept;
+    ~SensorReader();
+
+    bool open(std::string const& path);
+    void close();
+    bool isOpen() const { return fd >= 0; }
+    bool readInt(long& value) const;
+
+   private:
+    int fd = -1;
+};
+
+}  // namespace sys
+#endif  // !__SENSOR_READER_HPP__
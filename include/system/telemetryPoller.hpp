@@ -0,0 +1,50 @@
+#ifndef __TELEMETRY_POLLER_HPP__
+#define __TELEMETRY_POLLER_HPP__
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+
+#include "system/deviceController.hpp"
+#include "system/fanTelemetry.hpp"
+#include "system/telemetrySink.hpp"
+
+constexpr std::chrono::milliseconds const DEFAULT_TELEMETRY_INTERVAL =
+    std::chrono::seconds(1);
+
+namespace sys {
+
+// Reads speed and RPM of all fans at its own rate, independently of speed
+// writes, and publishes them into FanTelemetry
+class TelemetryPoller {
+   public:
+    TelemetryPoller(TelemetryPoller const&) = delete;
+    TelemetryPoller(TelemetryPoller&&) = delete;
+    TelemetryPoller& operator=(TelemetryPoller const&) = delete;
+    TelemetryPoller& operator=(TelemetryPoller&&) = delete;
+    TelemetryPoller(
+        std::shared_ptr<DeviceController> device,
+        std::shared_ptr<FanTelemetry> telemetry,
+        std::chrono::milliseconds interval = DEFAULT_TELEMETRY_INTERVAL,
+        std::shared_ptr<TelemetrySink> sink = nullptr);
+    ~TelemetryPoller();
+
+    void setInterval(std::chrono::milliseconds period);
+    std::shared_ptr<FanTelemetry> getTelemetry() const { return telemetry; }
+
+   private:
+    void pollLoop(std::stop_token const& stop);
+
+    std::shared_ptr<DeviceController> device;
+    std::shared_ptr<FanTelemetry> telemetry;
+    std::chrono::milliseconds interval;
+    std::mutex interval_lock;
+    std::condition_variable_any interval_cv;
+    std::jthread poll_thread;
+};
+
+}  // namespace sys
+#endif  // !__TELEMETRY_POLLER_HPP__
@@ -0,0 +1,122 @@
+#ifndef __TELEMETRY_SEGMENT_HPP__
+#define __TELEMETRY_SEGMENT_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "system/telemetrySink.hpp"
+
+namespace sys {
+
+constexpr char const* const DEFAULT_SHM_NAME = "/tt_riing_quad_fan_control";
+constexpr uint32_t const SHM_MAGIC = 0x46515454;  // "TTQF"
+constexpr uint32_t const SHM_VERSION = 1;
+constexpr std::size_t const SHM_MAX_CONTROLLERS = 8;
+constexpr std::size_t const SHM_MAX_CHANNELS = 5;
+constexpr std::size_t const SHM_CACHE_LINE = 64;
+
+// Fan slot c * SHM_MAX_CHANNELS + f. Speeds are percent, target_speed is
+// what the curve asked for, speed and rpm what the controller reported.
+struct SharedFan {
+    std::atomic<float> target_speed;
+    std::atomic<uint32_t> speed;
+    std::atomic<uint32_t> rpm;
+    std::atomic<uint32_t> valid;
+};
+
+// Layout of the segment in /dev/shm. The header fields never change after
+// creation, owner_pid is the process that created the segment. Everything
+// after sequence is guarded by it: the sequence is odd
+// while a write is in progress, readers copy the data and retry when the
+// sequence was odd or moved meanwhile.
+struct SharedTelemetry {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t controllers;
+    uint32_t channels;
+    uint32_t owner_pid;
+    alignas(SHM_CACHE_LINE) std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> updated_ns;  // CLOCK_MONOTONIC
+    std::atomic<float> cpu_temp;
+    std::atomic<float> gpu_temp;
+    SharedFan fans[SHM_MAX_CONTROLLERS * SHM_MAX_CHANNELS];  // NOLINT
+};
+
+static_assert(std::atomic<float>::is_always_lock_free &&
+                  std::atomic<uint64_t>::is_always_lock_free,
+              "Shared telemetry needs address-free atomics");
+
+struct FanSnapshot {
+    float target_speed;
+    uint32_t speed;
+    uint32_t rpm;
+    bool valid;
+};
+
+struct TelemetrySnapshot {
+    uint64_t sequence;
+    uint64_t updated_ns;
+    float cpu_temp;
+    float gpu_temp;
+    std::size_t controllers;
+    std::size_t channels;
+    std::vector<FanSnapshot> fans;  // controllers * channels
+};
+
+// Owner side: creates the segment, publishes into it and unlinks it again.
+// A segment of another running instance is never touched, creating one then
+// fails. One left behind by a process that died is replaced. Publishing
+// takes a process-local lock only to order writers from different threads,
+// readers in other processes never wait.
+class TelemetrySegment : public TelemetrySink {
+   public:
+    TelemetrySegment(TelemetrySegment const&) = delete;
+    TelemetrySegment(TelemetrySegment&&) = delete;
+    TelemetrySegment& operator=(TelemetrySegment const&) = delete;
+    TelemetrySegment& operator=(TelemetrySegment&&) = delete;
+    TelemetrySegment(std::size_t controllers_num, std::size_t channels_num,
+                     std::string name = DEFAULT_SHM_NAME);
+    ~TelemetrySegment() override;
+
+    void publishTemperatures(float cpu_temp, float gpu_temp) override;
+    void publishTarget(std::size_t controller_idx, std::size_t fan_idx,
+                       float speed) override;
+    void publishStatus(std::size_t controller_idx, std::size_t fan_idx,
+                       std::size_t speed, std::size_t rpm) override;
+
+    std::string const& getName() const { return name; }
+
+   private:
+    SharedFan* fan(std::size_t controller_idx, std::size_t fan_idx);
+    void beginWrite();
+    void endWrite();
+
+    std::string name;
+    SharedTelemetry* shared = nullptr;
+    std::mutex write_lock;
+};
+
+// Reader side, for tools and tests. Maps the segment read-only.
+class TelemetrySegmentReader {
+   public:
+    TelemetrySegmentReader(TelemetrySegmentReader const&) = delete;
+    TelemetrySegmentReader(TelemetrySegmentReader&&) = delete;
+    TelemetrySegmentReader& operator=(TelemetrySegmentReader const&) = delete;
+    TelemetrySegmentReader& operator=(TelemetrySegmentReader&&) = delete;
+    explicit TelemetrySegmentReader(std::string const& name = DEFAULT_SHM_NAME);
+    ~TelemetrySegmentReader();
+
+    // Empty when the writer kept the segment busy for too many attempts
+    std::optional<TelemetrySnapshot> read() const;
+
+   private:
+    SharedTelemetry const* shared = nullptr;
+};
+
+}  // namespace sys
+#endif  // !__TELEMETRY_SEGMENT_HPP__
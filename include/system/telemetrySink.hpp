@@ -0,0 +1,51 @@
+#ifndef __TELEMETRY_SINK_HPP__
+#define __TELEMETRY_SINK_HPP__
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace sys {
+
+// Receives every temperature sample, every target speed the curves ask for
+// and every speed/RPM reading the controller reports. Called from the
+// monitoring, control and device threads, implementations keep it cheap.
+class TelemetrySink {
+   public:
+    TelemetrySink() = default;
+    TelemetrySink(TelemetrySink const&) = delete;
+    TelemetrySink(TelemetrySink&&) = delete;
+    TelemetrySink& operator=(TelemetrySink const&) = delete;
+    TelemetrySink& operator=(TelemetrySink&&) = delete;
+    virtual ~TelemetrySink() = default;
+
+    virtual void publishTemperatures(float cpu_temp, float gpu_temp) = 0;
+    virtual void publishTarget(std::size_t controller_idx, std::size_t fan_idx,
+                               float speed) = 0;
+    virtual void publishStatus(std::size_t controller_idx, std::size_t fan_idx,
+                               std::size_t speed, std::size_t rpm) = 0;
+};
+
+// Hands every update to each of its sinks in order
+class TelemetryFanout : public TelemetrySink {
+   public:
+    explicit TelemetryFanout(std::vector<std::shared_ptr<TelemetrySink>> sinks)
+        : sinks(std::move(sinks)) {}
+
+    void publishTemperatures(float cpu_temp, float gpu_temp) override;
+    void publishTarget(std::size_t controller_idx, std::size_t fan_idx,
+                       float speed) override;
+    void publishStatus(std::size_t controller_idx, std::size_t fan_idx,
+                       std::size_t speed, std::size_t rpm) override;
+
+   private:
+    std::vector<std::shared_ptr<TelemetrySink>> sinks;
+};
+
+// nullptr for no sinks, the sink itself for one, a fanout otherwise
+std::shared_ptr<TelemetrySink> combineSinks(
+    std::vector<std::shared_ptr<TelemetrySink>> sinks);
+
+}  // namespace sys
+#endif  // !__TELEMETRY_SINK_HPP__
@@ -1,15 +1,27 @@
 #include <pthread.h>
+#include <signal.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <functional>
 #include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
 
 #include "core/commands/compositeCommand.hpp"
 #include "core/commands/rainbowColorCommand.hpp"
 #include "core/commands/rainbowColorFadeCommand.hpp"
+#include "core/commands/rainbowSpinCommand.hpp"
 #include "core/commands/staticColorCommand.hpp"
+#include "core/controlServer.hpp"
 #include "core/effectsEngine.hpp"
 #include "core/fanController.hpp"
 #include "core/logger.hpp"
@@ -19,6 +31,7 @@
 #include "core/observers/ui/uiObserver.hpp"
 #include "core/strategies/bezierCurvePlotStrategy.hpp"
 #include "core/strategies/pointPlotStrategy.hpp"
+#include "gui/framePacer.hpp"
 #include "gui/gtkTrayManager.hpp"
 #include "gui/ui.hpp"
 #include "gui/windowManager.hpp"
@@ -26,9 +39,15 @@
 #include "include/core/commands/staticColorCommand.hpp"
 #include "system/CPUController.hpp"
 #include "system/config.hpp"
+#include "system/controllers/simulatedRiingQuad.hpp"
 #include "system/controllers/ttRiingQuadController.hpp"
 #include "system/deviceController.hpp"
+#include "system/fanTelemetry.hpp"
+#include "system/metricsExporter.hpp"
 #include "system/monitoring.hpp"
+#include "system/telemetryPoller.hpp"
+#include "system/telemetrySegment.hpp"
+#include "system/telemetrySink.hpp"
 #include "system/vulkan.hpp"
 
 constexpr int WIDTH = 1280;
@@ -55,22 +74,292 @@ auto makeEngine() -> std::unique_ptr<core::EffectsEngine> {
         0, 255, 0, std::chrono::seconds(10)));
 
     engine->addEffect(std::move(composite_effect));
+
+    engine->addEffect(
+        std::make_unique<core::RainbowSpinCommand>(std::chrono::seconds(2)));
     engine->setActiveEffect(0);
 
     return engine;
 }
 
-auto main(int /*argc*/, char** /*argv*/) -> int {
-    core::Logger::log.enableColorLogging(true);
+struct Options {
+    bool headless = false;
+    bool control_socket = true;
+    bool shared_memory = true;
+    int metrics_port = -1;  // exporter off
+    std::size_t simulated_controllers = 0;  // real hardware
+    std::string config_path;
+    std::string socket_path;
+};
+
+auto parseOptions(int argc, char** argv) -> Options {
+    Options options;
+    std::span<char*> args(argv, argc);
+
+    for (std::size_t i = 1; i < args.size(); i++) {
+        std::string_view arg = args[i];
+        if (arg == "--headless") {
+            options.headless = true;
+        } else if (arg == "--config" && i + 1 < args.size()) {
+            options.config_path = args[++i];
+        } else if (arg == "--socket" && i + 1 < args.size()) {
+            options.socket_path = args[++i];
+        } else if (arg == "--no-socket") {
+            options.control_socket = false;
+        } else if (arg == "--no-shm") {
+            options.shared_memory = false;
+        } else if (arg == "--simulate" && i + 1 < args.size()) {
+            options.simulated_controllers = std::stoul(args[++i]);
+        } else if (arg == "--metrics-port" && i + 1 < args.size()) {
+            options.metrics_port = std::stoi(args[++i]);
+            if (options.metrics_port < 0 || options.metrics_port > UINT16_MAX) {
+                throw std::runtime_error("Invalid metrics port");
+            }
+        } else {
+            throw std::runtime_error(
+                "Unknown argument: " + std::string(arg) +
+                "\nUsage: tt_riing_quad_fan_control [--headless] "
+                "[--config <file>] [--socket <path> | --no-socket] "
+                "[--no-shm] [--metrics-port <port>] "
+                "[--simulate <controllers>]");
+        }
+    }
+    return options;
+}
+
+// --simulate swaps the USB controllers for simulated ones, so the whole
+// pipeline runs on machines without the hardware
+auto makeHidApi(Options const& options) -> std::unique_ptr<sys::HidApi> {
+    if (options.simulated_controllers == 0) {
+        return std::make_unique<sys::HidApi>();
+    }
+
+    LOG_WARNING(core::LogModule::HID)
+        << "Using " << options.simulated_controllers
+        << " simulated controllers" << std::endl;
+    return std::make_unique<sys::SimulatedHidApi>(
+        options.simulated_controllers);
+}
+
+// Runs without the socket when it can not be created, e.g. when another
+// instance owns it
+auto startControlServer(Options const& options,
+                        std::shared_ptr<core::Mediator> mediator,
+                        std::shared_ptr<sys::FanTelemetry const> telemetry,
+                        sys::Monitoring& mon)
+    -> std::unique_ptr<core::ControlServer> {
+    if (!options.control_socket) {
+        return nullptr;
+    }
 
+    try {
+        auto server = std::make_unique<core::ControlServer>(
+            options.socket_path.empty()
+                ? core::ControlServer::defaultSocketPath()
+                : options.socket_path,
+            std::move(mediator), std::move(telemetry),
+            // Edited curves apply now, not at the next temperature change
+            [&mon] { mon.refresh(); });
+        mon.addObserver(server->temperatureObserver());
+        return server;
+    } catch (std::exception const& e) {
+        core::Logger::log(core::LogLevel::ERROR)
+            << "Control socket disabled: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+// Temperatures, target speeds and fan readings for readers mapping
+// /dev/shm, publishing into it is a few stores per update
+auto openSegment(Options const& options,
+                 std::shared_ptr<sys::DeviceController> const& device)
+    -> std::shared_ptr<sys::TelemetrySegment> {
+    if (!options.shared_memory) {
+        return nullptr;
+    }
+
+    try {
+        return std::make_shared<sys::TelemetrySegment>(
+            device->controllersNum(), device->channelsNum());
+    } catch (std::exception const& e) {
+        core::Logger::log(core::LogLevel::ERROR)
+            << "Shared memory telemetry disabled: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+// OpenMetrics on 127.0.0.1 for Prometheus. Fan readings and temperatures
+// arrive through the telemetry sink, HID and effect counters are read on
+// every scrape.
+auto startExporter(Options const& options,
+                   std::shared_ptr<sys::TTRiingQuadController> const& device,
+                   std::shared_ptr<core::FanController> const& fc)
+    -> std::shared_ptr<sys::MetricsExporter> {
+    if (options.metrics_port < 0) {
+        return nullptr;
+    }
+
+    try {
+        auto exporter = std::make_shared<sys::MetricsExporter>(
+            static_cast<uint16_t>(options.metrics_port),
+            device->controllersNum(), device->channelsNum());
+        for (std::size_t c = 0;
+             c < std::min(device->controllersNum(), HID_MAX_DEVICES); c++) {
+            std::string labels = "controller=\"" + std::to_string(c) + "\"";
+            sys::HidStats const& stats = device->hidStats(c);
+            exporter->addHistogram(
+                "tt_hid_roundtrip_seconds",
+                "Time from writing a HID command to reading its response, "
+                "including the wait behind earlier commands in flight",
+                labels,
+                std::shared_ptr<sys::LatencyHistogram const>(
+                    device, &device->roundTrip(c)));
+            for (auto [op, histogram] : {std::pair{"write", &stats.write},
+                                         std::pair{"read", &stats.read}}) {
+                exporter->addHistogram(
+                    "tt_hid_op_seconds",
+                    "Duration of single hid_write and hid_read calls",
+                    labels + ",op=\"" + op + "\"",
+                    std::shared_ptr<sys::LatencyHistogram const>(device,
+                                                                 histogram));
+            }
+            auto counter = [&](std::string const& name, std::string const& help,
+                               std::atomic<uint64_t> const& value) {
+                exporter->addCounter(name, help, labels,
+                                     [device, v = &value] {
+                                         return static_cast<double>(v->load());
+                                     });
+            };
+            counter("tt_hid_timeouts", "Reads that ran into the HID timeout",
+                    stats.timeouts);
+            counter("tt_hid_protocol_failures",
+                    "Responses reporting a failure or answering another "
+                    "command",
+                    stats.protocol_failures);
+            counter("tt_hid_io_errors", "Failed hid_write and hid_read calls",
+                    stats.io_errors);
+        }
+        // The fan controller holds the exporter through its sink, a strong
+        // reference back would keep both alive
+        exporter->addCounter(
+            "tt_effect_frames", "Frames rendered by the effects engine", "",
+            [weak = std::weak_ptr<core::FanController>(fc)] {
+                auto p = weak.lock();
+                return p ? static_cast<double>(p->effectFrames()) : 0.0;
+            });
+        exporter->addCounter(
+            "tt_effect_missed_frames",
+            "Effect frame deadlines passed without a frame", "",
+            [weak = std::weak_ptr<core::FanController>(fc)] {
+                auto p = weak.lock();
+                return p ? static_cast<double>(p->effectsClock().missedFrames())
+                         : 0.0;
+            });
+        exporter->addCounter(
+            "tt_effect_dropped_frames",
+            "Effect frames replaced by a newer one before they were sent", "",
+            [weak = std::weak_ptr<core::FanController>(fc)] {
+                auto p = weak.lock();
+                return p ? static_cast<double>(p->droppedFrames()) : 0.0;
+            });
+        exporter->addHistogram(
+            "tt_effect_frame_lateness_seconds",
+            "How late effect frames start after their deadline", "",
+            fc->effectsClock().lateness());
+        exporter->start();
+        return exporter;
+    } catch (std::exception const& e) {
+        core::Logger::log(core::LogLevel::ERROR)
+            << "Metrics exporter disabled: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+// Only the control loop: Monitoring -> observers -> FanController.
+// SIGINT and SIGTERM stop it, SIGHUP reloads the config, SIGUSR1 logs
+// the HID statistics.
+auto runHeadless(Options const& options, sigset_t const& signals) -> int {
+    sys::Monitoring mon(std::make_unique<sys::CPUController>(),
+                        std::make_unique<sys::GPUController>(),
+                        std::chrono::seconds(2));
+
+    auto wrapper =
+        std::make_shared<sys::TTRiingQuadController>(makeHidApi(options));
+    sys::Config::getInstance().setControllerNum(wrapper->controllersNum());
+
+    auto system = sys::Config::getInstance().parseConfig(options.config_path);
+    sys::Config::getInstance().printConfig(system);
+
+    auto segment = openSegment(options, wrapper);
+    auto fc = std::make_shared<core::FanController>(system, wrapper,
+                                                    makeEngine());
+    auto exporter = startExporter(options, wrapper, fc);
+    auto sink = sys::combineSinks({segment, exporter});
+    fc->setSink(sink);
+    mon.setSink(sink);
+    mon.addObserver(std::make_shared<core::ObserverCPU>(fc));
+    mon.addObserver(std::make_shared<core::ObserverGPU>(fc));
+
+    // Fan readings are only polled when someone can see them
+    std::unique_ptr<sys::TelemetryPoller> poller;
+    std::unique_ptr<core::ControlServer> server;
+    if (options.control_socket || sink) {
+        auto telemetry = std::make_shared<sys::FanTelemetry>(
+            wrapper->controllersNum(), wrapper->channelsNum());
+        poller = std::make_unique<sys::TelemetryPoller>(
+            wrapper, telemetry, DEFAULT_TELEMETRY_INTERVAL, sink);
+        server = startControlServer(
+            options, std::make_shared<core::FanMediator>(nullptr, fc),
+            telemetry, mon);
+    }
+
+    LOG_INFO(core::LogModule::CORE)
+        << "Running headless, pid " << getpid() << std::endl;
+
+    for (;;) {
+        int sig = 0;
+        if (sigwait(&signals, &sig) != 0) {
+            throw std::runtime_error("sigwait failed");
+        }
+
+        if (sig == SIGUSR1) {
+            wrapper->logHidStats();
+            fc->logEffectStats();
+            continue;
+        }
+
+        if (sig != SIGHUP) {
+            LOG_INFO(core::LogModule::CORE)
+                << "Stopping on " << strsignal(sig) << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        try {
+            auto new_system =
+                sys::Config::getInstance().parseConfig(options.config_path);
+            sys::Config::getInstance().printConfig(new_system);
+            fc->loadSystem(*new_system);
+            // The temperatures did not move, without this the new curves
+            // would wait for the next change outside the deadband
+            mon.refresh();
+            LOG_INFO(core::LogModule::CONFIG) << "Config reloaded" << std::endl;
+        } catch (std::exception const& e) {
+            core::Logger::log(core::LogLevel::ERROR)
+                << "Failed reloading config: " << e.what() << std::endl;
+        }
+    }
+}
+
+auto runGui(Options const& options) -> int {
     try {
         // For other controllers support, need create detect controllers class
         // and work with it
         std::shared_ptr<sys::TTRiingQuadController> wrapper;
-        std::string path;
+        std::string path = options.config_path;
 
         auto win_manager =
             std::make_shared<gui::WindowManager>("Fan Control", WIDTH, HEIGHT);
+        auto pacer = std::make_shared<gui::FramePacer>();
 
         auto tray_manager = std::make_shared<gui::GTKTrayManager>();
 
@@ -79,26 +368,28 @@ auto main(int /*argc*/, char** /*argv*/) -> int {
                 bool window_hidden = win_manager->windowHided();
 
                 if (window_hidden) {
-                    core::Logger::log(core::LogLevel::INFO)
+                    LOG_INFO(core::LogModule::GUI)
                         << "Restoring window from tray" << std::endl;
                     win_manager->showWindow();
                 } else {
-                    core::Logger::log(core::LogLevel::INFO)
+                    LOG_INFO(core::LogModule::GUI)
                         << "Hiding window to tray" << std::endl;
                     win_manager->hideWindow();
                 }
 
                 window_hidden = !window_hidden;
+                pacer->markDirty();
             }),
             "onQuit", std::function<void()>([&]() {
-                core::Logger::log(core::LogLevel::INFO)
+                LOG_INFO(core::LogModule::GUI)
                     << "Quit requested from tray." << std::endl;
                 win_manager->closeWindow();
+                pacer->markDirty();
                 tray_manager->cleanup();
             }));
 
         win_manager->setOnCloseCallback([&]() {
-            core::Logger::log(core::LogLevel::INFO)
+            LOG_INFO(core::LogModule::GUI)
                 << "Window closed via close button." << std::endl;
             win_manager->hideWindow();
         });
@@ -108,9 +399,8 @@ auto main(int /*argc*/, char** /*argv*/) -> int {
                             std::make_unique<sys::GPUController>(),
                             std::chrono::seconds(2));
 
-        auto hidapi = std::make_unique<sys::HidApi>();
         wrapper =
-            std::make_shared<sys::TTRiingQuadController>(std::move(hidapi));
+            std::make_shared<sys::TTRiingQuadController>(makeHidApi(options));
         sys::Config::getInstance().setControllerNum(wrapper->controllersNum());
 
         system = sys::Config::getInstance().parseConfig(path);
@@ -119,6 +409,16 @@ auto main(int /*argc*/, char** /*argv*/) -> int {
         std::shared_ptr<core::FanController> const FC =
             std::make_shared<core::FanController>(system, wrapper,
                                                   std::move(makeEngine()));
+        auto segment = openSegment(options, wrapper);
+        auto exporter = startExporter(options, wrapper, FC);
+        auto sink = sys::combineSinks({segment, exporter});
+        FC->setSink(sink);
+        mon.setSink(sink);
+
+        auto telemetry = std::make_shared<sys::FanTelemetry>(
+            wrapper->controllersNum(), wrapper->channelsNum());
+        sys::TelemetryPoller poller(wrapper, telemetry,
+                                    DEFAULT_TELEMETRY_INTERVAL, sink);
 
         std::shared_ptr<core::ObserverCPU> const CPU_O =
             std::make_shared<core::ObserverCPU>(FC);
@@ -145,6 +445,9 @@ auto main(int /*argc*/, char** /*argv*/) -> int {
         mon.addObserver(UI_CPU_O);
         mon.addObserver(UI_GPU_O);
 
+        GUI->setTelemetry(telemetry);
+        GUI->setFramePacer(pacer);
+        pacer->watch([telemetry]() { return telemetry->generation(); });
         GUI->setGPUName(mon.getGpuName());
         GUI->setCPUName(mon.getCpuName());
 
@@ -153,6 +456,7 @@ auto main(int /*argc*/, char** /*argv*/) -> int {
 
         GUI->setMediator(mediator);
         FC->setMediator(mediator);
+        auto server = startControlServer(options, mediator, telemetry, mon);
 
         tray_manager->appendMenuItemsWithCallback(
             "Point curve", "onPointCurve", std::function<void()>([&FC, &GUI]() {
@@ -172,7 +476,7 @@ auto main(int /*argc*/, char** /*argv*/) -> int {
                 [&](std::string const& file_path) {
                     tray_manager->openFileDialog(
                         [&](std::string const& selected_file) {
-                            core::Logger::log(core::LogLevel::INFO)
+                            LOG_INFO(core::LogModule::GUI)
                                 << "File selected: " << selected_file
                                 << std::endl;
                             try {
@@ -181,7 +485,8 @@ auto main(int /*argc*/, char** /*argv*/) -> int {
                                         selected_file);
                                 sys::Config::getInstance().printConfig(
                                     new_system);
-                                *system = *new_system;
+                                FC->loadSystem(*new_system);
+                                mon.refresh();
                                 path = std::move(selected_file);
                             } catch (std::exception const& e) {
                                 core::Logger::log(core::LogLevel::ERROR)
@@ -189,7 +494,7 @@ auto main(int /*argc*/, char** /*argv*/) -> int {
                                     << std::endl;
                             }
                         });
-                    core::Logger::log(core::LogLevel::INFO)
+                    LOG_INFO(core::LogModule::GUI)
                         << "Opening file: " << file_path << std::endl;
                 }),
             "onSaveFile",
@@ -197,40 +502,41 @@ auto main(int /*argc*/, char** /*argv*/) -> int {
                 [&](std::string const& file_path) {
                     tray_manager->saveFileDialog(
                         [&](std::string const& saved_file) {
-                            core::Logger::log(core::LogLevel::INFO)
+                            LOG_INFO(core::LogModule::GUI)
                                 << "File selected: " << saved_file << std::endl;
                             sys::Config::getInstance().updateConf(system);
                             sys::Config::getInstance().writeToFile(saved_file);
                         });
-                    core::Logger::log(core::LogLevel::INFO)
+                    LOG_INFO(core::LogModule::GUI)
                         << "Saving file: " << file_path << std::endl;
                 }),
             "onApply", std::function<void()>([&]() {
-                core::Logger::log(core::LogLevel::INFO)
-                    << "Apply callback" << std::endl;
-                core::Logger::log(core::LogLevel::INFO)
+                LOG_INFO(core::LogModule::GUI) << "Apply callback" << std::endl;
+                LOG_INFO(core::LogModule::GUI)
                     << "Write to opened config" << std::endl;
                 sys::Config::getInstance().updateConf(system);
                 sys::Config::getInstance().writeToFile();
             }),
             "onPointPlot", std::function<void()>([&]() {
-                core::Logger::log(core::LogLevel::INFO)
+                LOG_INFO(core::LogModule::GUI)
                     << "Point Plot requested." << std::endl;
                 FC->pointInfo();
             }),
             "onBezierPlot", std::function<void()>([&]() {
-                core::Logger::log(core::LogLevel::INFO)
+                LOG_INFO(core::LogModule::GUI)
                     << "Point Plot requested." << std::endl;
                 FC->bezierInfo();
             }),
             "onQuit", std::function<void()>([&]() {
-                core::Logger::log(core::LogLevel::INFO)
+                LOG_INFO(core::LogModule::GUI)
                     << "Quit requested." << std::endl;
                 win_manager->closeWindow();
             }));
 
         while (!win_manager->shouldClose()) {
-            win_manager->pollEvents();
+            if (!pacer->waitForFrame(win_manager->windowHided())) {
+                continue;
+            }
             win_manager->createOrResize();
             GUI->setRenderSize(win_manager->getWindowSize());
             GUI->render();
@@ -243,3 +549,41 @@ auto main(int /*argc*/, char** /*argv*/) -> int {
 
     return 0;
 }
+
+auto main(int argc, char** argv) -> int {
+    Options options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (std::exception const& e) {
+        core::Logger::log(core::LogLevel::ERROR) << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!options.headless) {
+        core::Logger::log.enableColorLogging(true);
+        core::Logger::log.enableAsync();
+        return runGui(options);
+    }
+
+    // Blocked before any thread starts so every thread inherits the mask
+    // and the signals are only ever taken by sigwait()
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGHUP);
+    sigaddset(&signals, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    // The journal keeps its own timestamps but not ANSI colors
+    core::Logger::log.enableColorLogging(false);
+    core::Logger::log.enableAsync();
+
+    try {
+        return runHeadless(options, signals);
+    } catch (std::exception const& e) {
+        core::Logger::log(core::LogLevel::ERROR)
+            << "Error" << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
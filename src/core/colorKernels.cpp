@@ -0,0 +1,454 @@
+#include "core/colorKernels.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define COLOR_KERNELS_X86
+// Only the AVX2 kernels are built for AVX2, the rest of the program keeps
+// running on any x86-64 CPU
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace core {
+
+namespace {
+
+static_assert(sizeof(sys::LedColor) == 3,
+              "LED arrays are blended as plain bytes");
+
+constexpr unsigned const CHANNEL_MAX = 255;
+constexpr std::size_t const SECTORS_NUM = 6;
+
+// x / 255 for x up to 255 * 255, without a division
+constexpr auto div255(unsigned x) -> unsigned {
+    return (x + 1 + (x >> 8)) >> 8;  // NOLINT
+}
+
+auto bytes(std::span<sys::LedColor const> leds) -> uint8_t const* {
+    return reinterpret_cast<uint8_t const*>(leds.data());  // NOLINT
+}
+
+auto bytes(std::span<sys::LedColor> leds) -> uint8_t* {
+    return reinterpret_cast<uint8_t*>(leds.data());  // NOLINT
+}
+
+void blendBytes(uint8_t const* from, uint8_t const* to, uint16_t weight,
+                uint8_t* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; i++) {
+        out[i] = static_cast<uint8_t>(
+            (from[i] * (BLEND_ONE - weight) + to[i] * weight) >> 8);  // NOLINT
+    }
+}
+
+void gammaBytes(uint8_t* leds, std::size_t n) {
+    for (std::size_t i = 0; i < n; i++) {
+        leds[i] = static_cast<uint8_t>((leds[i] * (leds[i] + 1)) >> 8);  // NOLINT
+    }
+}
+
+}  // namespace
+
+auto blendColor(sys::LedColor const& from, sys::LedColor const& to,
+                uint16_t weight) -> sys::LedColor {
+    sys::LedColor out{};
+    blendBytes(from.data(), to.data(), weight, out.data(), out.size());
+    return out;
+}
+
+// The hue circle is cut into six sectors. Within a sector one channel is
+// at the value, one at the floor p and the third rises (t) or falls (q).
+auto hsvToGrb(uint16_t hue, uint8_t sat, uint8_t val) -> sys::LedColor {
+    unsigned h6 = hue * static_cast<unsigned>(SECTORS_NUM);
+    unsigned sector = h6 >> 16;          // NOLINT
+    unsigned f = (h6 >> 8) & CHANNEL_MAX;  // NOLINT
+    unsigned v = val;
+    unsigned p = div255(v * (CHANNEL_MAX - sat));
+    unsigned q = div255(v * (CHANNEL_MAX - div255(sat * f)));
+    unsigned t = div255(v * (CHANNEL_MAX - div255(sat * (CHANNEL_MAX - f))));
+
+    std::array<unsigned, SECTORS_NUM> g{t, v, v, q, p, p};
+    std::array<unsigned, SECTORS_NUM> r{v, q, p, p, t, v};
+    std::array<unsigned, SECTORS_NUM> b{p, p, t, v, v, q};
+    return {static_cast<uint8_t>(g[sector]), static_cast<uint8_t>(r[sector]),
+            static_cast<uint8_t>(b[sector])};
+}
+
+namespace {
+
+void blendScalar(std::span<sys::LedColor const> from,
+                 std::span<sys::LedColor const> to, uint16_t weight,
+                 std::span<sys::LedColor> out) {
+    std::size_t n = std::min({from.size(), to.size(), out.size()});
+    blendBytes(bytes(from), bytes(to), weight, bytes(out), n * 3);
+}
+
+void gammaScalar(std::span<sys::LedColor> leds) {
+    gammaBytes(bytes(leds), leds.size() * 3);
+}
+
+void hsvScalar(std::span<uint16_t const> hues, uint8_t sat, uint8_t val,
+               std::span<sys::LedColor> out) {
+    std::size_t n = std::min(hues.size(), out.size());
+    for (std::size_t i = 0; i < n; i++) {
+        out[i] = hsvToGrb(hues[i], sat, val);
+    }
+}
+
+#ifdef COLOR_KERNELS_X86
+
+constexpr std::size_t const SSE2_BYTES = 16;
+constexpr std::size_t const SSE2_HUES = 8;
+constexpr std::size_t const AVX2_BYTES = 32;
+constexpr std::size_t const AVX2_HUES = 16;
+
+// Byte shuffles turning 16 green, 16 red and 16 blue bytes into 48 bytes
+// of GRB: per output register, one mask for each plane, 0x80 clears
+using InterleaveMasks =
+    std::array<std::array<std::array<uint8_t, SSE2_BYTES>, 3>, 3>;
+
+constexpr auto interleaveMasks() -> InterleaveMasks {
+    InterleaveMasks masks{};
+    for (std::size_t reg = 0; reg < 3; reg++) {
+        for (std::size_t plane = 0; plane < 3; plane++) {
+            for (std::size_t i = 0; i < SSE2_BYTES; i++) {
+                std::size_t pos = reg * SSE2_BYTES + i;
+                masks[reg][plane][i] =
+                    pos % 3 == plane ? static_cast<uint8_t>(pos / 3) : 0x80;
+            }
+        }
+    }
+    return masks;
+}
+
+constexpr InterleaveMasks const INTERLEAVE_MASKS = interleaveMasks();
+
+template <typename T>
+auto vec(T* ptr) -> __m128i* {
+    return reinterpret_cast<__m128i*>(ptr);  // NOLINT
+}
+
+template <typename T>
+auto vec(T const* ptr) -> __m128i const* {
+    return reinterpret_cast<__m128i const*>(ptr);  // NOLINT
+}
+
+template <typename T>
+auto vec256(T* ptr) -> __m256i* {
+    return reinterpret_cast<__m256i*>(ptr);  // NOLINT
+}
+
+template <typename T>
+auto vec256(T const* ptr) -> __m256i const* {
+    return reinterpret_cast<__m256i const*>(ptr);  // NOLINT
+}
+
+// SSE2 is part of x86-64, these need no check
+
+void blendBytesSse2(uint8_t const* from, uint8_t const* to, uint16_t weight,
+                    uint8_t* out, std::size_t n) {
+    __m128i const zero = _mm_setzero_si128();
+    __m128i const wa = _mm_set1_epi16(static_cast<int16_t>(BLEND_ONE - weight));
+    __m128i const wb = _mm_set1_epi16(static_cast<int16_t>(weight));
+    std::size_t i = 0;
+    for (; i + SSE2_BYTES <= n; i += SSE2_BYTES) {
+        __m128i a = _mm_loadu_si128(vec(from + i));
+        __m128i b = _mm_loadu_si128(vec(to + i));
+        __m128i lo =
+            _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), wa),
+                          _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), wb));
+        __m128i hi =
+            _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), wa),
+                          _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), wb));
+        _mm_storeu_si128(vec(out + i),
+                         _mm_packus_epi16(_mm_srli_epi16(lo, 8),  // NOLINT
+                                          _mm_srli_epi16(hi, 8)));
+    }
+    blendBytes(from + i, to + i, weight, out + i, n - i);
+}
+
+void gammaBytesSse2(uint8_t* leds, std::size_t n) {
+    __m128i const zero = _mm_setzero_si128();
+    __m128i const one = _mm_set1_epi16(1);
+    std::size_t i = 0;
+    for (; i + SSE2_BYTES <= n; i += SSE2_BYTES) {
+        __m128i x = _mm_loadu_si128(vec(leds + i));
+        __m128i lo = _mm_unpacklo_epi8(x, zero);
+        __m128i hi = _mm_unpackhi_epi8(x, zero);
+        lo = _mm_srli_epi16(_mm_mullo_epi16(lo, _mm_add_epi16(lo, one)), 8);
+        hi = _mm_srli_epi16(_mm_mullo_epi16(hi, _mm_add_epi16(hi, one)), 8);
+        _mm_storeu_si128(vec(leds + i), _mm_packus_epi16(lo, hi));
+    }
+    gammaBytes(leds + i, n - i);
+}
+
+auto div255(__m128i x) -> __m128i {
+    return _mm_srli_epi16(
+        _mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)),
+                      _mm_srli_epi16(x, 8)),  // NOLINT
+        8);                                   // NOLINT
+}
+
+// Vector types lose their attributes in templates, plain arrays keep them
+using Sectors = __m128i[SECTORS_NUM];  // NOLINT
+
+auto pick(Sectors const& in, Sectors const& by_sector) -> __m128i {
+    __m128i out = _mm_setzero_si128();
+    for (std::size_t k = 0; k < SECTORS_NUM; k++) {
+        out = _mm_or_si128(out, _mm_and_si128(in[k], by_sector[k]));
+    }
+    return out;
+}
+
+// hsvToGrb() for eight hues in 16 bit lanes, green, red and blue come out
+// in 16 bit lanes too
+void hsvPlanes(__m128i hue, __m128i sat, __m128i v, __m128i& g, __m128i& r,
+               __m128i& b) {
+    __m128i const max = _mm_set1_epi16(CHANNEL_MAX);
+    __m128i const six = _mm_set1_epi16(SECTORS_NUM);
+    __m128i sector = _mm_mulhi_epu16(hue, six);
+    __m128i f = _mm_srli_epi16(_mm_mullo_epi16(hue, six), 8);  // NOLINT
+    __m128i p = div255(_mm_mullo_epi16(v, _mm_sub_epi16(max, sat)));
+    __m128i q = div255(_mm_mullo_epi16(
+        v, _mm_sub_epi16(max, div255(_mm_mullo_epi16(sat, f)))));
+    __m128i t = div255(_mm_mullo_epi16(
+        v, _mm_sub_epi16(
+               max, div255(_mm_mullo_epi16(sat, _mm_sub_epi16(max, f))))));
+
+    Sectors in;
+    for (std::size_t k = 0; k < SECTORS_NUM; k++) {
+        in[k] = _mm_cmpeq_epi16(sector,
+                                _mm_set1_epi16(static_cast<int16_t>(k)));
+    }
+    g = pick(in, {t, v, v, q, p, p});
+    r = pick(in, {v, q, p, p, t, v});
+    b = pick(in, {p, p, t, v, v, q});
+}
+
+void blendSse2(std::span<sys::LedColor const> from,
+               std::span<sys::LedColor const> to, uint16_t weight,
+               std::span<sys::LedColor> out) {
+    std::size_t n = std::min({from.size(), to.size(), out.size()});
+    blendBytesSse2(bytes(from), bytes(to), weight, bytes(out), n * 3);
+}
+
+void gammaSse2(std::span<sys::LedColor> leds) {
+    gammaBytesSse2(bytes(leds), leds.size() * 3);
+}
+
+// SSE2 has no byte shuffle, the planes are interleaved one LED at a time
+void hsvSse2(std::span<uint16_t const> hues, uint8_t sat, uint8_t val,
+             std::span<sys::LedColor> out) {
+    std::size_t n = std::min(hues.size(), out.size());
+    __m128i const zero = _mm_setzero_si128();
+    __m128i const vsat = _mm_set1_epi16(sat);
+    __m128i const vval = _mm_set1_epi16(val);
+    alignas(SSE2_BYTES) std::array<uint8_t, SSE2_BYTES> g{};
+    alignas(SSE2_BYTES) std::array<uint8_t, SSE2_BYTES> r{};
+    alignas(SSE2_BYTES) std::array<uint8_t, SSE2_BYTES> b{};
+    std::size_t i = 0;
+    for (; i + SSE2_HUES <= n; i += SSE2_HUES) {
+        __m128i vg;
+        __m128i vr;
+        __m128i vb;
+        hsvPlanes(_mm_loadu_si128(vec(hues.data() + i)), vsat, vval, vg, vr,
+                  vb);
+        _mm_store_si128(vec(g.data()), _mm_packus_epi16(vg, zero));
+        _mm_store_si128(vec(r.data()), _mm_packus_epi16(vr, zero));
+        _mm_store_si128(vec(b.data()), _mm_packus_epi16(vb, zero));
+        for (std::size_t j = 0; j < SSE2_HUES; j++) {
+            out[i + j] = {g[j], r[j], b[j]};
+        }
+    }
+    hsvScalar(hues.subspan(i, n - i), sat, val, out.subspan(i));
+}
+
+AVX2_TARGET void blendAvx2(std::span<sys::LedColor const> from,
+                           std::span<sys::LedColor const> to, uint16_t weight,
+                           std::span<sys::LedColor> out) {
+    std::size_t n = std::min({from.size(), to.size(), out.size()}) * 3;
+    uint8_t const* a = bytes(from);
+    uint8_t const* b = bytes(to);
+    uint8_t* o = bytes(out);
+    __m256i const zero = _mm256_setzero_si256();
+    __m256i const wa =
+        _mm256_set1_epi16(static_cast<int16_t>(BLEND_ONE - weight));
+    __m256i const wb = _mm256_set1_epi16(static_cast<int16_t>(weight));
+    std::size_t i = 0;
+    // Unpack and pack both work within 128 bit lanes, the bytes keep
+    // their order
+    for (; i + AVX2_BYTES <= n; i += AVX2_BYTES) {
+        __m256i va = _mm256_loadu_si256(vec256(a + i));
+        __m256i vb = _mm256_loadu_si256(vec256(b + i));
+        __m256i lo = _mm256_add_epi16(
+            _mm256_mullo_epi16(_mm256_unpacklo_epi8(va, zero), wa),
+            _mm256_mullo_epi16(_mm256_unpacklo_epi8(vb, zero), wb));
+        __m256i hi = _mm256_add_epi16(
+            _mm256_mullo_epi16(_mm256_unpackhi_epi8(va, zero), wa),
+            _mm256_mullo_epi16(_mm256_unpackhi_epi8(vb, zero), wb));
+        _mm256_storeu_si256(
+            vec256(o + i),
+            _mm256_packus_epi16(_mm256_srli_epi16(lo, 8),  // NOLINT
+                                _mm256_srli_epi16(hi, 8)));
+    }
+    blendBytesSse2(a + i, b + i, weight, o + i, n - i);
+}
+
+AVX2_TARGET void gammaAvx2(std::span<sys::LedColor> leds) {
+    std::size_t n = leds.size() * 3;
+    uint8_t* x = bytes(leds);
+    __m256i const zero = _mm256_setzero_si256();
+    __m256i const one = _mm256_set1_epi16(1);
+    std::size_t i = 0;
+    for (; i + AVX2_BYTES <= n; i += AVX2_BYTES) {
+        __m256i v = _mm256_loadu_si256(vec256(x + i));
+        __m256i lo = _mm256_unpacklo_epi8(v, zero);
+        __m256i hi = _mm256_unpackhi_epi8(v, zero);
+        lo = _mm256_srli_epi16(
+            _mm256_mullo_epi16(lo, _mm256_add_epi16(lo, one)), 8);  // NOLINT
+        hi = _mm256_srli_epi16(
+            _mm256_mullo_epi16(hi, _mm256_add_epi16(hi, one)), 8);  // NOLINT
+        _mm256_storeu_si256(vec256(x + i), _mm256_packus_epi16(lo, hi));
+    }
+    gammaBytesSse2(x + i, n - i);
+}
+
+AVX2_TARGET auto div255(__m256i x) -> __m256i {
+    return _mm256_srli_epi16(
+        _mm256_add_epi16(_mm256_add_epi16(x, _mm256_set1_epi16(1)),
+                         _mm256_srli_epi16(x, 8)),  // NOLINT
+        8);                                         // NOLINT
+}
+
+using Sectors256 = __m256i[SECTORS_NUM];  // NOLINT
+
+AVX2_TARGET auto pick(Sectors256 const& in, Sectors256 const& by_sector)
+    -> __m256i {
+    __m256i out = _mm256_setzero_si256();
+    for (std::size_t k = 0; k < SECTORS_NUM; k++) {
+        out = _mm256_or_si256(out, _mm256_and_si256(in[k], by_sector[k]));
+    }
+    return out;
+}
+
+// 16 bit lanes down to 16 bytes in order: the pack works per 128 bit lane,
+// the permute brings both halves together
+AVX2_TARGET auto narrow(__m256i x) -> __m128i {
+    __m256i packed = _mm256_packus_epi16(x, _mm256_setzero_si256());
+    return _mm256_castsi256_si128(
+        _mm256_permute4x64_epi64(packed, 0b11011000));  // NOLINT
+}
+
+AVX2_TARGET void hsvAvx2(std::span<uint16_t const> hues, uint8_t sat,
+                         uint8_t val, std::span<sys::LedColor> out) {
+    std::size_t n = std::min(hues.size(), out.size());
+    __m256i const max = _mm256_set1_epi16(CHANNEL_MAX);
+    __m256i const six = _mm256_set1_epi16(SECTORS_NUM);
+    __m256i const vsat = _mm256_set1_epi16(sat);
+    __m256i const v = _mm256_set1_epi16(val);
+    __m128i masks[3][3];  // NOLINT
+    for (std::size_t reg = 0; reg < 3; reg++) {
+        for (std::size_t plane = 0; plane < 3; plane++) {
+            masks[reg][plane] =
+                _mm_loadu_si128(vec(INTERLEAVE_MASKS[reg][plane].data()));
+        }
+    }
+
+    uint8_t* o = bytes(out);
+    std::size_t i = 0;
+    for (; i + AVX2_HUES <= n; i += AVX2_HUES) {
+        __m256i hue = _mm256_loadu_si256(vec256(hues.data() + i));
+        __m256i sector = _mm256_mulhi_epu16(hue, six);
+        __m256i f =
+            _mm256_srli_epi16(_mm256_mullo_epi16(hue, six), 8);  // NOLINT
+        __m256i p =
+            div255(_mm256_mullo_epi16(v, _mm256_sub_epi16(max, vsat)));
+        __m256i q = div255(_mm256_mullo_epi16(
+            v, _mm256_sub_epi16(max, div255(_mm256_mullo_epi16(vsat, f)))));
+        __m256i t = div255(_mm256_mullo_epi16(
+            v, _mm256_sub_epi16(max, div255(_mm256_mullo_epi16(
+                                         vsat, _mm256_sub_epi16(max, f))))));
+
+        Sectors256 in;
+        for (std::size_t k = 0; k < SECTORS_NUM; k++) {
+            in[k] = _mm256_cmpeq_epi16(
+                sector, _mm256_set1_epi16(static_cast<int16_t>(k)));
+        }
+        __m128i planes[3] = {narrow(pick(in, {t, v, v, q, p, p})),  // NOLINT
+                             narrow(pick(in, {v, q, p, p, t, v})),
+                             narrow(pick(in, {p, p, t, v, v, q}))};
+        for (std::size_t reg = 0; reg < 3; reg++) {
+            __m128i grb = _mm_setzero_si128();
+            for (std::size_t plane = 0; plane < 3; plane++) {
+                grb = _mm_or_si128(
+                    grb, _mm_shuffle_epi8(planes[plane], masks[reg][plane]));
+            }
+            _mm_storeu_si128(vec(o + i * 3 + reg * SSE2_BYTES), grb);
+        }
+    }
+    hsvSse2(hues.subspan(i, n - i), sat, val, out.subspan(i));
+}
+
+#endif  // COLOR_KERNELS_X86
+
+constexpr ColorKernels const SCALAR_KERNELS{KernelIsa::SCALAR, blendScalar,
+                                            gammaScalar, hsvScalar};
+#ifdef COLOR_KERNELS_X86
+constexpr ColorKernels const SSE2_KERNELS{KernelIsa::SSE2, blendSse2,
+                                          gammaSse2, hsvSse2};
+constexpr ColorKernels const AVX2_KERNELS{KernelIsa::AVX2, blendAvx2,
+                                          gammaAvx2, hsvAvx2};
+#endif
+
+}  // namespace
+
+auto kernelsSupported(KernelIsa isa) -> bool {
+    switch (isa) {
+        case KernelIsa::SCALAR:
+            return true;
+#ifdef COLOR_KERNELS_X86
+        case KernelIsa::SSE2:
+            return true;
+        case KernelIsa::AVX2:
+            // Benchmarks ask from static initializers, before the CPU model
+            // may have been read
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") != 0;
+#endif
+        default:
+            return false;
+    }
+}
+
+auto colorKernels(KernelIsa isa) -> ColorKernels const& {
+    if (!kernelsSupported(isa)) {
+        throw std::runtime_error("Color kernels not supported by this CPU");
+    }
+    switch (isa) {
+#ifdef COLOR_KERNELS_X86
+        case KernelIsa::SSE2:
+            return SSE2_KERNELS;
+        case KernelIsa::AVX2:
+            return AVX2_KERNELS;
+#endif
+        default:
+            return SCALAR_KERNELS;
+    }
+}
+
+auto colorKernels() -> ColorKernels const& {
+    static ColorKernels const& best = []() -> ColorKernels const& {
+        for (auto isa : {KernelIsa::AVX2, KernelIsa::SSE2}) {
+            if (kernelsSupported(isa)) {
+                return colorKernels(isa);
+            }
+        }
+        return colorKernels(KernelIsa::SCALAR);
+    }();
+    return best;
+}
+
+}  // namespace core
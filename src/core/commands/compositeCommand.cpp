@@ -12,7 +12,7 @@ void CompositeCommand::addCommand(std::unique_ptr<EffectCommand> effect) {
 
 auto CompositeCommand::execute(std::chrono::steady_clock::duration interval)
     -> std::array<uint8_t, 3> {
-    core::Logger::log(core::LogLevel::INFO)
+    LOG_INFO(core::LogModule::CORE)
         << "CompositeCommand executed" << std::endl;
 
     if (effects.empty()) return {0, 0, 0};
@@ -20,7 +20,7 @@ auto CompositeCommand::execute(std::chrono::steady_clock::duration interval)
     if (current_idx < effects.size()) {
         std::array<uint8_t, 3> result = effects[current_idx]->execute(interval);
         if (effects[current_idx]->isFinished()) {
-            core::Logger::log(core::LogLevel::INFO)
+            LOG_INFO(core::LogModule::CORE)
                 << "Command at index " << current_idx
                 << " finished, moving to next command" << std::endl;
             current_idx++;
@@ -32,6 +32,20 @@ auto CompositeCommand::execute(std::chrono::steady_clock::duration interval)
     return {0, 0, 0};
 }
 
+// The running part renders itself, so a per-LED effect stays per-LED
+void CompositeCommand::render(std::chrono::steady_clock::duration interval,
+                              sys::ColorBuffer& frame) {
+    if (current_idx >= effects.size()) {
+        EffectCommand::render(interval, frame);
+        return;
+    }
+
+    effects[current_idx]->render(interval, frame);
+    if (effects[current_idx]->isFinished()) {
+        current_idx++;
+    }
+}
+
 auto CompositeCommand::isFinished() const -> bool {
     return current_idx >= effects.size();
 }
@@ -46,4 +60,11 @@ auto CompositeCommand::clone() -> std::unique_ptr<EffectCommand> {
     return composite;
 }
 
+void CompositeCommand::reset() {
+    for (auto const& e : effects) {
+        e->reset();
+    }
+    current_idx = 0;
+}
+
 }  // namespace core
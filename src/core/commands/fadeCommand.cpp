@@ -2,6 +2,7 @@
 
 #include <memory>
 
+#include "core/colorKernels.hpp"
 #include "core/effectCommand.hpp"
 
 namespace core {
@@ -11,14 +12,8 @@ auto FadeCommand::execute(Duration interval) -> Color {
         finished = true;
         current_color = end_color;
     } else {
-        double progress = std::chrono::duration<double>(elapsed).count() /
-                          std::chrono::duration<double>(duration).count();
-        current_color[0] = static_cast<uint8_t>(
-            start_color[0] + progress * (end_color[0] - start_color[0]));
-        current_color[1] = static_cast<uint8_t>(
-            start_color[1] + progress * (end_color[1] - start_color[1]));
-        current_color[2] = static_cast<uint8_t>(
-            start_color[2] + progress * (end_color[2] - start_color[2]));
+        auto weight = static_cast<uint16_t>(elapsed * BLEND_ONE / duration);
+        current_color = blendColor(start_color, end_color, weight);
     }
 
     elapsed += interval;
@@ -30,9 +25,15 @@ auto FadeCommand::clone() -> std::unique_ptr<EffectCommand> {
     return std::make_unique<FadeCommand>(*this);
 }
 
-auto FadeCommand::makeNew(EffectParams const& params)
-    -> std::unique_ptr<EffectCommand> {
-    return clone();
+void FadeCommand::reset() {
+    current_color = start_color;
+    elapsed = Duration::zero();
+    finished = false;
+}
+
+void FadeCommand::configure(EffectParams const& params) {
+    duration = params.duration;
+    reset();
 }
 
 }  // namespace core
@@ -10,17 +10,17 @@ namespace core {
 
 auto RainbowColorCommand::execute(std::chrono::steady_clock::duration interval)
     -> Color {
-    core::Logger::log(core::LogLevel::INFO)
+    LOG_INFO(core::LogModule::CORE)
         << "RainbowColorCommand executed" << std::endl;
     if (sequence.empty()) {
         return {MIN_CHANNEL_VALUE, MIN_CHANNEL_VALUE, MIN_CHANNEL_VALUE};
     }
 
     auto& cmd = sequence[current_command_idx];
-    auto result = cmd->execute(interval);
+    auto result = cmd.execute(interval);
 
-    if (cmd->isFinished()) {
-        sequence[current_command_idx] = prototype[current_command_idx]->clone();
+    if (cmd.isFinished()) {
+        cmd.reset();
         current_command_idx = (current_command_idx + 1) % sequence.size();
     }
 
@@ -31,19 +31,27 @@ auto RainbowColorCommand::clone() -> std::unique_ptr<EffectCommand> {
     return std::make_unique<RainbowColorCommand>(fade_duration);
 }
 
-auto RainbowColorCommand::makeNew(EffectParams const& params)
-    -> std::unique_ptr<EffectCommand> {
-    return std::make_unique<RainbowColorCommand>(params.duration);
+void RainbowColorCommand::reset() {
+    for (auto& fade : sequence) {
+        fade.reset();
+    }
+    current_command_idx = 0;
+}
+
+void RainbowColorCommand::configure(EffectParams const& params) {
+    fade_duration = params.duration;
+    for (auto& fade : sequence) {
+        fade.configure(params);
+    }
+    current_command_idx = 0;
 }
 
 void RainbowColorCommand::buildSequense() {
     sequence.clear();
     for (std::size_t i = 0; i < rainbow_colors.size(); i++) {
         std::size_t next = (i + 1) % rainbow_colors.size();
-        sequence.push_back(std::make_unique<FadeCommand>(
-            rainbow_colors[i], rainbow_colors[next], fade_duration));
-        prototype.push_back(std::make_unique<FadeCommand>(
-            rainbow_colors[i], rainbow_colors[next], fade_duration));
+        sequence.emplace_back(rainbow_colors[i], rainbow_colors[next],
+                              fade_duration);
     }
 }
 
@@ -8,17 +8,17 @@ namespace core {
 
 auto RainbowColorFadeCommand::execute(
     std::chrono::steady_clock::duration interval) -> Color {
-    core::Logger::log(core::LogLevel::INFO)
+    LOG_INFO(core::LogModule::CORE)
         << "RainbowColorCommand executed" << std::endl;
     if (sequence.empty()) {
         return {MIN_CHANNEL_VALUE, MIN_CHANNEL_VALUE, MIN_CHANNEL_VALUE};
     }
 
     auto& cmd = sequence[current_command_idx];
-    auto result = cmd->execute(interval);
+    auto result = cmd.execute(interval);
 
-    if (cmd->isFinished()) {
-        sequence[current_command_idx] = prototype[current_command_idx]->clone();
+    if (cmd.isFinished()) {
+        cmd.reset();
         current_command_idx = (current_command_idx + 1) % sequence.size();
     }
 
@@ -29,23 +29,29 @@ auto RainbowColorFadeCommand::clone() -> std::unique_ptr<EffectCommand> {
     return std::make_unique<RainbowColorFadeCommand>(fade_duration);
 }
 
-auto RainbowColorFadeCommand::makeNew(EffectParams const& params)
-    -> std::unique_ptr<EffectCommand> {
-    return std::make_unique<RainbowColorFadeCommand>(params.duration);
+void RainbowColorFadeCommand::reset() {
+    for (auto& fade : sequence) {
+        fade.reset();
+    }
+    current_command_idx = 0;
+}
+
+void RainbowColorFadeCommand::configure(EffectParams const& params) {
+    fade_duration = params.duration;
+    for (auto& fade : sequence) {
+        fade.configure(params);
+    }
+    current_command_idx = 0;
 }
 
 void RainbowColorFadeCommand::buildSequense() {
     sequence.clear();
+    // FadeIn/FadeOut only preset one of the colors, the plain fade they
+    // slice down to keeps both
     for (std::size_t i = 0; i < rainbow_colors.size(); i++) {
         std::size_t next = (i + 1) % rainbow_colors.size();
-        sequence.push_back(
-            std::make_unique<FadeOutCommand>(rainbow_colors[i], fade_duration));
-        sequence.push_back(std::make_unique<FadeInCommand>(rainbow_colors[next],
-                                                           fade_duration));
-        prototype.push_back(
-            std::make_unique<FadeOutCommand>(rainbow_colors[i], fade_duration));
-        prototype.push_back(std::make_unique<FadeInCommand>(
-            rainbow_colors[next], fade_duration));
+        sequence.push_back(FadeOutCommand(rainbow_colors[i], fade_duration));
+        sequence.push_back(FadeInCommand(rainbow_colors[next], fade_duration));
     }
 }
 
@@ -0,0 +1,59 @@
+#include "core/commands/rainbowSpinCommand.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/colorKernels.hpp"
+
+namespace core {
+
+auto hueToGrb(double hue) -> sys::LedColor {
+    // A hue of exactly one turn wraps to zero in the 16 bit cast
+    auto turn = static_cast<uint32_t>((hue - std::floor(hue)) * HUE_TURN);
+    return hsvToGrb(static_cast<uint16_t>(turn), MAX_CHANNEL_VALUE,
+                    MAX_CHANNEL_VALUE);
+}
+
+auto RainbowSpinCommand::advance(Duration interval) -> double {
+    double current = phase;
+    phase += std::chrono::duration<double>(interval).count() /
+             std::chrono::duration<double>(period).count();
+    phase -= std::floor(phase);
+    return current;
+}
+
+auto RainbowSpinCommand::execute(Duration interval) -> Color {
+    return hueToGrb(advance(interval));
+}
+
+void RainbowSpinCommand::render(Duration interval, sys::ColorBuffer& frame) {
+    double hue = advance(interval);
+    std::size_t fan_leds = frame.ledsNum();
+    if (frame.all().empty()) {
+        return;
+    }
+
+    hues.resize(fan_leds);
+    auto first = static_cast<uint32_t>(hue * HUE_TURN);
+    for (std::size_t led = 0; led < fan_leds; led++) {
+        hues[led] = static_cast<uint16_t>(first + led * HUE_TURN / fan_leds);
+    }
+    auto ring = frame.fan(0, 0);
+    colorKernels().hsvToGrb(hues, MAX_CHANNEL_VALUE, MAX_CHANNEL_VALUE, ring);
+    // Fans follow each other in the frame, the ring repeats across it
+    auto leds = frame.all();
+    for (std::size_t next = fan_leds; next < leds.size(); next += fan_leds) {
+        std::ranges::copy(ring, leds.begin() + next);
+    }
+}
+
+auto RainbowSpinCommand::clone() -> std::unique_ptr<EffectCommand> {
+    return std::make_unique<RainbowSpinCommand>(period);
+}
+
+void RainbowSpinCommand::configure(EffectParams const& params) {
+    period = params.duration;
+    reset();
+}
+
+}  // namespace core
@@ -5,10 +5,10 @@ namespace core {
 
 auto StaticColorCommand::execute(std::chrono::steady_clock::duration interval)
     -> Color {
-    core::Logger::log(core::LogLevel::INFO)
+    LOG_INFO(core::LogModule::CORE)
         << "StaticColorCommand executed" << std::endl;
     elapsed += interval;
-    core::Logger::log(core::LogLevel::INFO)
+    LOG_INFO(core::LogModule::CORE)
         << "Result:" << r << " " << g << " " << b << std::endl;
     return {r, g, b};
 }
@@ -17,10 +17,12 @@ auto StaticColorCommand::clone() -> std::unique_ptr<EffectCommand> {
     return std::make_unique<StaticColorCommand>(r, g, b, duration);
 }
 
-auto StaticColorCommand::makeNew(EffectParams const& params)
-    -> std::unique_ptr<EffectCommand> {
-    return std::make_unique<StaticColorCommand>(params.r, params.g, params.b,
-                                                params.duration);
+void StaticColorCommand::configure(EffectParams const& params) {
+    r = params.r;
+    g = params.g;
+    b = params.b;
+    duration = params.duration;
+    reset();
 }
 
 auto StaticColorCommand::makeStaticColorCommand(
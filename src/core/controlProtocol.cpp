@@ -0,0 +1,228 @@
+#include "core/controlProtocol.hpp"
+
+#include <cctype>
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+class Parser {
+   public:
+    explicit Parser(std::string_view text) : text(text) {}
+
+    core::JsonObject object() {
+        core::JsonObject result;
+        expect('{');
+        if (consume('}')) {
+            return finish(std::move(result));
+        }
+        do {
+            std::string key = string();
+            expect(':');
+            result.set(std::move(key), value());
+        } while (consume(','));
+        expect('}');
+        return finish(std::move(result));
+    }
+
+   private:
+    core::JsonObject finish(core::JsonObject&& result) {
+        skipSpace();
+        if (pos != text.size()) {
+            fail("trailing characters");
+        }
+        return std::move(result);
+    }
+
+    core::JsonValue value() {
+        skipSpace();
+        if (pos >= text.size()) {
+            fail("unexpected end");
+        }
+        char c = text[pos];
+        if (c == '"') {
+            return string();
+        }
+        if (c == '[') {
+            return array();
+        }
+        if (literal("true")) {
+            return true;
+        }
+        if (literal("false")) {
+            return false;
+        }
+        if (literal("null")) {
+            return std::monostate{};
+        }
+        return number();
+    }
+
+    std::vector<double> array() {
+        std::vector<double> result;
+        expect('[');
+        if (consume(']')) {
+            return result;
+        }
+        do {
+            result.push_back(number());
+        } while (consume(','));
+        expect(']');
+        return result;
+    }
+
+    double number() {
+        skipSpace();
+        double result = 0;
+        auto [ptr, ec] = std::from_chars(text.data() + pos,
+                                         text.data() + text.size(), result);
+        if (ec != std::errc()) {
+            fail("number expected");
+        }
+        pos = ptr - text.data();
+        return result;
+    }
+
+    std::string string() {
+        expect('"');
+        std::string result;
+        while (pos < text.size() && text[pos] != '"') {
+            char c = text[pos++];
+            if (c != '\\') {
+                result.push_back(c);
+                continue;
+            }
+            if (pos >= text.size()) {
+                break;
+            }
+            char escaped = text[pos++];
+            switch (escaped) {
+                case 'n':
+                    result.push_back('\n');
+                    break;
+                case 't':
+                    result.push_back('\t');
+                    break;
+                case '"':
+                case '\\':
+                case '/':
+                    result.push_back(escaped);
+                    break;
+                default:
+                    fail("unsupported escape");
+            }
+        }
+        expect('"');
+        return result;
+    }
+
+    bool literal(std::string_view word) {
+        if (text.substr(pos, word.size()) != word) {
+            return false;
+        }
+        pos += word.size();
+        return true;
+    }
+
+    void skipSpace() {
+        while (pos < text.size() &&
+               std::isspace(static_cast<unsigned char>(text[pos])) != 0) {
+            pos++;
+        }
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (pos < text.size() && text[pos] == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) {
+            fail(std::string("'") + c + "' expected");
+        }
+    }
+
+    [[noreturn]] void fail(std::string const& what) const {
+        throw std::runtime_error("Bad request at " + std::to_string(pos) +
+                                 ": " + what);
+    }
+
+    std::string_view text;
+    std::size_t pos = 0;
+};
+
+template <typename T>
+auto get(std::unordered_map<std::string, core::JsonValue> const& fields,
+         std::string const& key, char const* type) -> T const& {
+    auto it = fields.find(key);
+    if (it == fields.end()) {
+        throw std::runtime_error("Missing field \"" + key + "\"");
+    }
+    if (auto const* v = std::get_if<T>(&it->second)) {
+        return *v;
+    }
+    throw std::runtime_error("Field \"" + key + "\" must be " + type);
+}
+
+}  // namespace
+
+namespace core {
+
+auto JsonObject::number(std::string const& key) const -> double {
+    return get<double>(fields, key, "a number");
+}
+
+auto JsonObject::number(std::string const& key, double fallback) const
+    -> double {
+    return contains(key) ? number(key) : fallback;
+}
+
+auto JsonObject::boolean(std::string const& key, bool fallback) const
+    -> bool {
+    return contains(key) ? get<bool>(fields, key, "a boolean") : fallback;
+}
+
+auto JsonObject::string(std::string const& key) const -> std::string const& {
+    return get<std::string>(fields, key, "a string");
+}
+
+auto JsonObject::numbers(std::string const& key) const
+    -> std::vector<double> const& {
+    return get<std::vector<double>>(fields, key, "an array of numbers");
+}
+
+auto parseJsonObject(std::string_view text) -> JsonObject {
+    return Parser(text).object();
+}
+
+auto jsonString(std::string_view text) -> std::string {
+    std::string result = "\"";
+    for (char c : text) {
+        switch (c) {
+            case '"':
+                result += "\\\"";
+                break;
+            case '\\':
+                result += "\\\\";
+                break;
+            case '\n':
+                result += "\\n";
+                break;
+            case '\t':
+                result += "\\t";
+                break;
+            default:
+                result.push_back(c);
+        }
+    }
+    result.push_back('"');
+    return result;
+}
+
+}  // namespace core
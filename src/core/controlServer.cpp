@@ -0,0 +1,500 @@
+#include "core/controlServer.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+#include "core/logger.hpp"
+#include "core/mediators/fanMediator.hpp"
+
+constexpr std::size_t const READ_CHUNK = 1024;
+constexpr std::size_t const BEZIER_COORDS = 8;
+// Speeds are percent, like in the config
+constexpr double const CURVE_MAX_SPEED = 100.0;
+// Bounds for numbers that are cast to integers, a cast of anything outside
+// the target type is undefined. Plenty for indices and durations in seconds.
+constexpr double const MAX_INDEX = 4294967295.0;
+constexpr double const MAX_STREAM_PERIOD_MS = 24.0 * 60 * 60 * 1000;
+
+namespace {
+
+auto sysError(std::string const& what) -> std::runtime_error {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+auto index(core::JsonObject const& request, std::string const& key)
+    -> std::size_t {
+    double value = request.number(key);
+    // NaN fails the comparisons
+    if (!(value >= 0 && value <= MAX_INDEX) || value != std::floor(value)) {
+        throw std::runtime_error("Field \"" + key +
+                                 "\" must be an integer within 0-4294967295");
+    }
+    return static_cast<std::size_t>(value);
+}
+
+auto channel(core::JsonObject const& request, std::string const& key)
+    -> float {
+    return static_cast<float>(std::clamp(request.number(key), 0.0, 1.0));
+}
+
+// NaN fails both comparisons
+auto isSpeed(double value) -> bool {
+    return value >= 0.0 && value <= CURVE_MAX_SPEED;
+}
+
+auto isFinite(double value) -> bool { return std::isfinite(value); }
+
+void appendNumber(std::string& out, double value) {
+    std::array<char, 32> buf{};  // NOLINT
+    auto [ptr, ec] = std::to_chars(buf.data(), buf.data() + buf.size(), value,
+                                   std::chars_format::fixed, 1);
+    out.append(buf.data(), ptr);
+}
+
+void appendNumber(std::string& out, std::size_t value) {
+    std::array<char, 24> buf{};  // NOLINT
+    auto [ptr, ec] = std::to_chars(buf.data(), buf.data() + buf.size(), value);
+    out.append(buf.data(), ptr);
+}
+
+auto errorLine(std::string_view what) -> std::string {
+    return "{\"ok\":false,\"error\":" + core::jsonString(what) + "}";
+}
+
+}  // namespace
+
+namespace core {
+
+class ControlServer::TemperatureObserver : public Observer {
+   public:
+    explicit TemperatureObserver(std::shared_ptr<Temperatures> t)
+        : temperatures(std::move(t)) {}
+    void onEvent(Event const& event) override {
+        auto& target = event.type == EventType::CPU_TEMP_CHANGED
+                           ? temperatures->cpu
+                           : temperatures->gpu;
+        target.store(event.value, std::memory_order_relaxed);
+    }
+
+   private:
+    std::shared_ptr<Temperatures> temperatures;
+};
+
+ControlServer::ControlServer(std::string socket_path,
+                             std::shared_ptr<Mediator> mediator,
+                             std::shared_ptr<sys::FanTelemetry const> telemetry,
+                             std::function<void()> on_curves_changed)
+    : socket_path(std::move(socket_path)),
+      mediator(std::move(mediator)),
+      telemetry(std::move(telemetry)),
+      on_curves_changed(std::move(on_curves_changed)),
+      temperatures(std::make_shared<Temperatures>()) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (this->socket_path.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error("Socket path too long: " + this->socket_path);
+    }
+    std::copy(this->socket_path.begin(), this->socket_path.end(),
+              addr.sun_path);
+    auto* sa = reinterpret_cast<sockaddr*>(&addr);  // NOLINT
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        throw sysError("socket");
+    }
+
+    // A socket nobody accepts on is left over from a crashed instance. Only
+    // a socket is removed, a mistyped --socket must not delete a file.
+    if (connect(listen_fd, sa, sizeof(addr)) == 0) {
+        close(listen_fd);
+        throw std::runtime_error("Control socket already in use: " +
+                                 this->socket_path);
+    }
+    struct stat st {};
+    if (lstat(this->socket_path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            close(listen_fd);
+            throw std::runtime_error("Not a socket, refusing to replace: " +
+                                     this->socket_path);
+        }
+        unlink(this->socket_path.c_str());
+    }
+
+    if (bind(listen_fd, sa, sizeof(addr)) != 0 ||
+        chmod(this->socket_path.c_str(), S_IRUSR | S_IWUSR) != 0 ||
+        listen(listen_fd, SOMAXCONN) != 0) {
+        auto error = sysError("Control socket " + this->socket_path);
+        close(listen_fd);
+        throw error;
+    }
+
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0) {
+        auto error = sysError("eventfd");
+        close(listen_fd);
+        unlink(this->socket_path.c_str());
+        throw error;
+    }
+
+    thread = std::jthread([this](std::stop_token const& stop) { serve(stop); });
+    LOG_INFO(LogModule::CORE)
+        << "Control socket listening on " << this->socket_path << std::endl;
+}
+
+ControlServer::~ControlServer() {
+    thread.request_stop();
+    uint64_t one = 1;
+    (void)write(wake_fd, &one, sizeof(one));
+    if (thread.joinable()) {
+        thread.join();
+    }
+
+    for (auto& c : clients) {
+        close(c.fd);
+    }
+    close(wake_fd);
+    close(listen_fd);
+    unlink(socket_path.c_str());
+}
+
+auto ControlServer::temperatureObserver() -> std::shared_ptr<Observer> {
+    return std::make_shared<TemperatureObserver>(temperatures);
+}
+
+auto ControlServer::defaultSocketPath() -> std::string {
+    char const* runtime_dir = std::getenv("XDG_RUNTIME_DIR");
+    if (runtime_dir != nullptr && *runtime_dir != '\0') {
+        return std::string(runtime_dir) + "/tt_riing_quad_fan_control.sock";
+    }
+    return "/tmp/tt_riing_quad_fan_control-" + std::to_string(getuid()) +
+           ".sock";
+}
+
+void ControlServer::serve(std::stop_token const& stop) {
+    std::vector<pollfd> fds;
+
+    while (!stop.stop_requested()) {
+        fds.clear();
+        fds.push_back({wake_fd, POLLIN, 0});
+        fds.push_back({listen_fd, POLLIN, 0});
+        for (auto const& c : clients) {
+            auto events = static_cast<short>(
+                c.out.empty() ? POLLIN : (POLLIN | POLLOUT));
+            fds.push_back({c.fd, events, 0});
+        }
+
+        if (poll(fds.data(), fds.size(),
+                 pollTimeout(std::chrono::steady_clock::now())) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR(LogModule::CORE)
+                << "Control socket poll failed: " << std::strerror(errno)
+                << std::endl;
+            return;
+        }
+
+        // Clients accepted below are appended, fds still match the rest
+        std::size_t polled = clients.size();
+        if ((fds[1].revents & POLLIN) != 0) {
+            acceptClients();
+        }
+        for (std::size_t i = 0; i < polled; i++) {
+            auto& c = clients[i];
+            bool alive = true;
+            if ((fds[i + 2].revents & (POLLIN | POLLHUP | POLLERR)) != 0) {
+                alive = readClient(c);
+            }
+            if (alive && !c.out.empty()) {
+                alive = writeClient(c);
+            }
+            if (!alive) {
+                close(c.fd);
+                c.fd = -1;
+            }
+        }
+
+        streamTelemetry(std::chrono::steady_clock::now());
+
+        std::erase_if(clients, [](Client const& c) { return c.fd < 0; });
+        clients_num.store(clients.size());
+    }
+}
+
+void ControlServer::acceptClients() {
+    for (;;) {
+        int fd = accept4(listen_fd, nullptr, nullptr,
+                         SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        if (clients.size() >= CONTROL_MAX_CLIENTS) {
+            LOG_WARNING(LogModule::CORE)
+                << "Control socket: too many clients" << std::endl;
+            close(fd);
+            continue;
+        }
+        clients.emplace_back(fd);
+    }
+}
+
+auto ControlServer::readClient(Client& client) -> bool {
+    std::array<char, READ_CHUNK> buf{};
+    for (;;) {
+        ssize_t n = recv(client.fd, buf.data(), buf.size(), 0);
+        if (n > 0) {
+            client.in.append(buf.data(), n);
+            continue;
+        }
+        if (n == 0) {
+            return false;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        return false;
+    }
+
+    std::size_t start = 0;
+    for (std::size_t nl = client.in.find('\n'); nl != std::string::npos;
+         nl = client.in.find('\n', start)) {
+        std::string_view line(client.in.data() + start, nl - start);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (!line.empty()) {
+            client.out += handleLine(client, line);
+            client.out += '\n';
+        }
+        start = nl + 1;
+    }
+    client.in.erase(0, start);
+
+    return client.in.size() <= CONTROL_MAX_LINE;
+}
+
+auto ControlServer::writeClient(Client& client) -> bool {
+    while (!client.out.empty()) {
+        ssize_t n = send(client.fd, client.out.data(), client.out.size(),
+                         MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n > 0) {
+            client.out.erase(0, n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+    return true;
+}
+
+void ControlServer::streamTelemetry(std::chrono::steady_clock::time_point now) {
+    std::string line;
+    for (auto& c : clients) {
+        if (c.fd < 0 || !c.subscribed || now < c.next_frame) {
+            continue;
+        }
+        c.next_frame = now + c.period;
+
+        // Frames for a subscriber that does not read are skipped
+        if (c.out.size() > CONTROL_MAX_PENDING_OUTPUT) {
+            continue;
+        }
+        if (line.empty()) {
+            line = telemetryLine() + '\n';
+        }
+        c.out += line;
+        if (!writeClient(c)) {
+            close(c.fd);
+            c.fd = -1;
+        }
+    }
+}
+
+auto ControlServer::pollTimeout(std::chrono::steady_clock::time_point now) const
+    -> int {
+    int timeout = -1;
+    for (auto const& c : clients) {
+        if (!c.subscribed) {
+            continue;
+        }
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            c.next_frame - now);
+        int ms = static_cast<int>(std::max<int64_t>(left.count(), 0));
+        timeout = timeout < 0 ? ms : std::min(timeout, ms);
+    }
+    return timeout;
+}
+
+auto ControlServer::handleLine(Client& client, std::string_view line)
+    -> std::string {
+    try {
+        return execute(client, parseJsonObject(line));
+    } catch (std::exception const& e) {
+        return errorLine(e.what());
+    }
+}
+
+auto ControlServer::execute(Client& client, JsonObject const& request)
+    -> std::string {
+    std::string const& cmd = request.string("cmd");
+
+    if (cmd == "telemetry") {
+        return telemetryLine();
+    }
+    if (cmd == "subscribe") {
+        double period_ms = request.number(
+            "period_ms", static_cast<double>(DEFAULT_STREAM_PERIOD.count()));
+        if (!(period_ms >= 0 && period_ms <= MAX_STREAM_PERIOD_MS)) {
+            return errorLine("period_ms must be within 0-86400000");
+        }
+        auto period =
+            std::chrono::milliseconds(static_cast<int64_t>(period_ms));
+        client.subscribed = true;
+        client.period = std::max(period, MIN_STREAM_PERIOD);
+        client.next_frame = std::chrono::steady_clock::now();
+        return "{\"ok\":true}";
+    }
+    if (cmd == "unsubscribe") {
+        client.subscribed = false;
+        return "{\"ok\":true}";
+    }
+
+    if (!mediator) {
+        return errorLine("No fan controller attached");
+    }
+
+    if (cmd == "effect") {
+        mediator->notify(
+            EventMessageType::UPDATE_EFFECT,
+            std::make_shared<ColorMessage>(ColorMessage{
+                index(request, "effect"),
+                std::max<std::size_t>(index(request, "duration"), 1),
+                channel(request, "r"), channel(request, "g"),
+                channel(request, "b"), false}));
+        return "{\"ok\":true}";
+    }
+
+    std::size_t c_idx = index(request, "controller");
+    std::size_t f_idx = index(request, "fan");
+    if (telemetry && (c_idx >= telemetry->controllersNum() ||
+                      f_idx >= telemetry->channelsNum())) {
+        return errorLine("No such fan");
+    }
+
+    if (cmd == "color") {
+        mediator->notify(EventMessageType::UPDATE_COLOR,
+                         std::make_shared<ColorMessage>(ColorMessage{
+                             c_idx, f_idx, channel(request, "r"),
+                             channel(request, "g"), channel(request, "b"),
+                             request.boolean("all", false)}));
+    } else if (cmd == "curve") {
+        auto const& temps = request.numbers("temps");
+        auto const& speeds = request.numbers("speeds");
+        if (temps.size() != speeds.size() || temps.size() < 2) {
+            return errorLine("temps and speeds need the same size, at least 2");
+        }
+        // Fan speeds are cast to integers, garbage here would be undefined
+        if (!std::ranges::all_of(temps, isFinite) ||
+            std::ranges::adjacent_find(temps, std::greater_equal<>()) !=
+                temps.end()) {
+            return errorLine("temps must be finite and strictly increasing");
+        }
+        if (!std::ranges::all_of(speeds, isSpeed)) {
+            return errorLine("speeds must be within 0-100");
+        }
+        auto msg = std::make_shared<DataMessage>();
+        msg->c_idx = c_idx;
+        msg->f_idx = f_idx;
+        msg->data = FanData{temps, speeds};
+        mediator->notify(EventMessageType::UPDATE_GRAPH, msg);
+    } else if (cmd == "bezier") {
+        auto const& coords = request.numbers("points");
+        if (coords.size() != BEZIER_COORDS) {
+            return errorLine("points needs 4 x,y pairs");
+        }
+        std::array<std::pair<double, double>, 4> points;
+        for (std::size_t i = 0; i < points.size(); i++) {
+            points[i] = {coords[2 * i], coords[2 * i + 1]};
+            if (!isFinite(points[i].first) || !isSpeed(points[i].second)) {
+                return errorLine("points need finite x and y within 0-100");
+            }
+        }
+        auto msg = std::make_shared<DataMessage>();
+        msg->c_idx = c_idx;
+        msg->f_idx = f_idx;
+        msg->data = points;
+        mediator->notify(EventMessageType::UPDATE_GRAPH, msg);
+    } else if (cmd == "mode") {
+        std::string const& mode = request.string("mode");
+        if (mode != "cpu" && mode != "gpu") {
+            return errorLine("mode must be \"cpu\" or \"gpu\"");
+        }
+        auto msg = std::make_shared<ModeMessage>();
+        msg->c_idx = c_idx;
+        msg->f_idx = f_idx;
+        msg->mode = mode == "cpu" ? 0 : 1;
+        mediator->notify(EventMessageType::UPDATE_MONITORING_MODE_FAN, msg);
+    } else {
+        return errorLine("Unknown command " + cmd);
+    }
+
+    if (cmd != "color" && on_curves_changed) {
+        on_curves_changed();
+    }
+    return "{\"ok\":true}";
+}
+
+auto ControlServer::telemetryLine() const -> std::string {
+    std::string line = "{\"event\":\"telemetry\",\"cpu\":";
+    appendNumber(line, static_cast<double>(
+                           temperatures->cpu.load(std::memory_order_relaxed)));
+    line += ",\"gpu\":";
+    appendNumber(line, static_cast<double>(
+                           temperatures->gpu.load(std::memory_order_relaxed)));
+    line += ",\"fans\":[";
+
+    bool first = true;
+    for (std::size_t c = 0; telemetry && c < telemetry->controllersNum(); c++) {
+        for (std::size_t f = 0; f < telemetry->channelsNum(); f++) {
+            auto sample = telemetry->load(c, f);
+            if (!sample.valid) {
+                continue;
+            }
+            line += first ? "{\"controller\":" : ",{\"controller\":";
+            appendNumber(line, c);
+            line += ",\"fan\":";
+            appendNumber(line, f);
+            line += ",\"speed\":";
+            appendNumber(line, sample.speed);
+            line += ",\"rpm\":";
+            appendNumber(line, sample.rpm);
+            line += '}';
+            first = false;
+        }
+    }
+    line += "]}";
+    return line;
+}
+
+}  // namespace core
@@ -0,0 +1,103 @@
+#include "core/effect.hpp"
+
+#include <chrono>
+#include <utility>
+
+#include "core/colorKernels.hpp"
+
+namespace core {
+
+void StaticEffect::configure(EffectParams const& params) {
+    color = {params.r, params.g, params.b};
+    duration = params.duration;
+    reset();
+}
+
+auto FadeEffect::execute(EffectDuration interval) -> EffectColor {
+    if (elapsed >= duration) {
+        finished = true;
+        current_color = end_color;
+    } else {
+        auto weight = static_cast<uint16_t>(elapsed * BLEND_ONE / duration);
+        current_color = blendColor(start_color, end_color, weight);
+    }
+
+    elapsed += interval;
+
+    return current_color;
+}
+
+void FadeEffect::reset() {
+    current_color = start_color;
+    elapsed = EffectDuration::zero();
+    finished = false;
+}
+
+void FadeEffect::configure(EffectParams const& params) {
+    duration = params.duration;
+    reset();
+}
+
+namespace {
+
+template <std::size_t... I>
+auto rainbowFades(EffectDuration duration, std::index_sequence<I...>)
+    -> std::array<FadeEffect, RAINBOW_COLORS_NUM> {
+    return {FadeEffect(RAINBOW_COLORS[I],
+                       RAINBOW_COLORS[(I + 1) % RAINBOW_COLORS_NUM],
+                       duration)...};
+}
+
+template <std::size_t... I>
+auto rainbowOutInFades(EffectDuration duration, std::index_sequence<I...>)
+    -> std::array<FadeEffect, 2 * RAINBOW_COLORS_NUM> {
+    EffectColor const black{MIN_CHANNEL_VALUE, MIN_CHANNEL_VALUE,
+                            MIN_CHANNEL_VALUE};
+    // Even fades take color I / 2 out, odd ones bring the next one in
+    return {(I % 2 == 0
+                 ? FadeEffect(RAINBOW_COLORS[I / 2], black, duration)
+                 : FadeEffect(black,
+                              RAINBOW_COLORS[(I / 2 + 1) % RAINBOW_COLORS_NUM],
+                              duration))...};
+}
+
+}  // namespace
+
+RainbowEffect::RainbowEffect(EffectDuration fade_duration)
+    : FadeCycle(rainbowFades(fade_duration,
+                             std::make_index_sequence<RAINBOW_COLORS_NUM>())) {
+}
+
+RainbowFadeEffect::RainbowFadeEffect(EffectDuration fade_duration)
+    : FadeCycle(rainbowOutInFades(
+          fade_duration, std::make_index_sequence<2 * RAINBOW_COLORS_NUM>())) {
+}
+
+void CompositeEffect::addEffect(Effect effect) {
+    parts.push_back(std::move(effect));
+}
+
+auto CompositeEffect::execute(EffectDuration interval) -> EffectColor {
+    if (current_idx >= parts.size()) {
+        return {0, 0, 0};
+    }
+
+    auto result = parts[current_idx].execute(interval);
+    if (parts[current_idx].isFinished()) {
+        current_idx++;
+    }
+    return result;
+}
+
+auto CompositeEffect::isFinished() const -> bool {
+    return current_idx >= parts.size();
+}
+
+void CompositeEffect::reset() {
+    for (auto& part : parts) {
+        part.reset();
+    }
+    current_idx = 0;
+}
+
+}  // namespace core
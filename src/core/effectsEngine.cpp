@@ -19,14 +19,14 @@ void EffectsEngine::setActiveEffect(std::size_t index) {
         active_effect = effects.size() - 1;
     }
 
-    core::Logger::log(core::LogLevel::INFO)
+    LOG_INFO(core::LogModule::CORE)
         << "Active effect set to index " << active_effect.value() << std::endl;
 }
 
 void EffectsEngine::setActiveEffect(std::unique_ptr<EffectCommand> effect) {
     if (active_effect.has_value()) {
         effects[active_effect.value()] = std::move(effect);
-        core::Logger::log(core::LogLevel::INFO)
+        LOG_INFO(core::LogModule::CORE)
             << "Active effect set" << std::endl;
     }
 }
@@ -36,8 +36,7 @@ void EffectsEngine::updateActiveEffect(
     std::chrono::steady_clock::duration duration) {
     if (active_effect.has_value()) {
         EffectParams params(color[0], color[1], color[2], duration);
-        effects[active_effect.value()] =
-            std::move(effects[active_effect.value()]->makeNew(params));
+        effects[active_effect.value()]->configure(params);
     }
 }
 
@@ -49,14 +48,14 @@ void EffectsEngine::resetActiveEffect() { active_effect.reset(); }
 
 auto EffectsEngine::update(std::chrono::steady_clock::duration interval)
     -> std::array<uint8_t, 3> {
-    core::Logger::log(core::LogLevel::INFO)
+    LOG_INFO(core::LogModule::CORE)
         << "EffectsEngine update" << std::endl;
     if (active_effect.has_value()) {
         auto& choosen_effect = effects[active_effect.value()];
         if (choosen_effect) {
             std::array<uint8_t, 3> result = choosen_effect->execute(interval);
             if (choosen_effect->isFinished()) {
-                core::Logger::log(core::LogLevel::INFO)
+                LOG_INFO(core::LogModule::CORE)
                     << "Active effect finished" << std::endl;
                 active_effect.reset();
             }
@@ -67,6 +66,22 @@ auto EffectsEngine::update(std::chrono::steady_clock::duration interval)
     return {0, 0, 0};
 }
 
+auto EffectsEngine::render(std::chrono::steady_clock::duration interval,
+                           sys::ColorBuffer& frame) -> bool {
+    if (!active_effect.has_value() || !effects[active_effect.value()]) {
+        return false;
+    }
+
+    auto& choosen_effect = effects[active_effect.value()];
+    choosen_effect->render(interval, frame);
+    if (choosen_effect->isFinished()) {
+        LOG_INFO(core::LogModule::CORE)
+            << "Active effect finished" << std::endl;
+        active_effect.reset();
+    }
+    return true;
+}
+
 auto EffectsEngine::getEffectCount() const -> std::size_t {
     return effects.size();
 }
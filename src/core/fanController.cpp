@@ -2,13 +2,17 @@
 
 #include <math.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <ostream>
 #include <ranges>
+#include <span>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -19,38 +23,127 @@
 
 namespace core {
 
+namespace {
+
+constexpr uint64_t const FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+constexpr uint64_t const FNV_PRIME = 0x100000001b3ULL;
+
+auto frameHash(std::span<sys::LedColor const> frame) -> uint64_t {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (auto const& led : frame) {
+        for (auto byte : led) {
+            hash ^= byte;
+            hash *= FNV_PRIME;
+        }
+    }
+    return hash;
+}
+
+}  // namespace
+
 void FanController::rgbThreadLoop() {
+    std::vector<bool> dirty(frames.front().controllersNum());
+
     while (run.load()) {
-        hid_lock.lock();
-        for (auto&& [i, c] : std::ranges::views::enumerate(color_buffer)) {
-            for (auto&& [j, f] : std::ranges::views::enumerate(c)) {
-                wrapper->setRGB(i, j + 1, color_buffer[i][j]);
+        auto now = std::chrono::steady_clock::now();
+        bool refresh = now - last_refresh >= keep_alive.load();
+        if (refresh) {
+            last_refresh = now;
+        }
+
+        // The newest complete frame, if the effects thread published one
+        frames.update();
+        auto const& frame = frames.front();
+        for (std::size_t i = 0; i < frame.controllersNum(); i++) {
+            dirty[i] = false;
+            for (std::size_t j = 0; j < sent_hashes[i].size(); j++) {
+                // A frame the device never got is not sent yet
+                uint64_t drops = wrapper->colorDrops(i, j + 1);
+                if (drops != seen_drops[i][j]) {
+                    seen_drops[i][j] = drops;
+                    sent_hashes[i][j] = 0;
+                }
+
+                auto f = frame.fan(i, j);
+                uint64_t hash = frameHash(f);
+                if (!refresh && hash == sent_hashes[i][j]) {
+                    skipped_frames++;
+                    continue;
+                }
+                if (wrapper->queueRGB(i, j + 1, f)) {
+                    sent_hashes[i][j] = hash;
+                    dirty[i] = true;
+                }
+            }
+        }
+
+        // Each controller is kicked separately, a slow device only delays
+        // its own frames
+        for (std::size_t i = 0; i < dirty.size(); i++) {
+            if (dirty[i]) {
+                wrapper->flush(i);
             }
         }
-        hid_lock.unlock();
         std::this_thread::sleep_for(std::chrono::milliseconds(interval));
     }
 }
 
 void FanController::effectsThreadLoop() {
+    uint64_t seen_edits = 0;
     while (run.load()) {
-        if (effectsEngine->hasActiveEffect()) {
-            auto result = effectsEngine->update(interval);
-            core::Logger::log(core::LogLevel::INFO)
-                << "Result:" << result[0] << " " << result[1] << " "
-                << result[2] << std::endl;
-            for (auto&& c : tmp_color_buffer) {
-                std::fill(c.begin(), c.end(), result);
-            }
+        // Effects advance by the time that really passed, so a late frame
+        // catches up instead of slowing the animation down
+        auto delta = effects_clock.wait();
+        applyEffectRequest();
+        bool active = effectsEngine->hasActiveEffect();
+        uint64_t edits = color_edits.load(std::memory_order_acquire);
+        if (!active && edits == seen_edits) {
+            continue;
+        }
+        seen_edits = edits;
 
-            hid_lock.lock();
-            std::swap(color_buffer, tmp_color_buffer);
-            hid_lock.unlock();
+        auto& frame = frames.back();
+        if (active) {
+            // Every effect colors every LED of every fan, nothing of the
+            // stale back buffer survives
+            effectsEngine->render(delta, frame);
+            effect_frames.fetch_add(1, std::memory_order_relaxed);
+            if (!effectsEngine->hasActiveEffect()) {
+                // Later edits of single fans start from the last frame
+                std::lock_guard<std::mutex> lock(color_lock);
+                color_buffer = frame;
+            }
+        } else {
+            // Same shape, the copy reuses the storage of the back buffer
+            std::lock_guard<std::mutex> lock(color_lock);
+            frame = color_buffer;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+        frames.publish();
     }
 }
 
+void FanController::applyEffectRequest() {
+    std::optional<EffectRequest> request;
+    {
+        std::lock_guard<std::mutex> lock(effect_lock);
+        request.swap(effect_request);
+    }
+    if (request) {
+        effectsEngine->setActiveEffect(request->effect_pos);
+        effectsEngine->updateActiveEffect(request->color, request->duration);
+    }
+}
+
+void FanController::logEffectStats() const {
+    auto const& lateness = *effects_clock.lateness();
+    LOG_INFO(LogModule::CORE)
+        << "Effects: " << effect_frames.load() << " frames rendered, "
+        << effects_clock.missedFrames() << " missed, " << frames.overwritten()
+        << " dropped before sending | lateness p50 "
+        << lateness.percentile(0.5).count() << "us p99 "
+        << lateness.percentile(0.99).count() << "us" << std::endl;
+}
+
 void FanController::setMediator(std::shared_ptr<Mediator> mediator) {
     this->mediator = std::move(mediator);
 }
@@ -67,29 +160,39 @@ void FanController::updateFanColor(std::size_t controller_idx,
                                    std::size_t fan_idx,
                                    std::array<uint8_t, 3> const& color,
                                    bool to_all) {
-    std::lock_guard<std::mutex> lock(hid_lock);
+    std::lock_guard<std::mutex> lock(color_lock);
     if (!to_all) {
-        color_buffer[controller_idx][fan_idx] = color;
+        std::ranges::fill(color_buffer.fan(controller_idx, fan_idx), color);
     } else {
-        for (auto&& c : color_buffer) {
-            std::for_each(
-                c.begin(), c.end(),
-                [&color](std::array<uint8_t, 3>& col) { col = color; });
-        }
+        std::ranges::fill(color_buffer.all(), color);
     }
+    // Sent with the next frame of the effects thread
+    color_edits.fetch_add(1, std::memory_order_release);
 }
 
 void FanController::updateEffect(std::size_t effect_pos, std::size_t duration_s,
                                  std::array<uint8_t, 3> const& color) {
-    effectsEngine->setActiveEffect(effect_pos);
-    effectsEngine->updateActiveEffect(color, std::chrono::seconds(duration_s));
+    std::lock_guard<std::mutex> lock(effect_lock);
+    effect_request =
+        EffectRequest{effect_pos, std::chrono::seconds(duration_s), color};
+}
+
+void FanController::loadSystem(sys::System const& new_system) {
+    std::lock_guard<std::mutex> lock(system_lock);
+    *system = new_system;
+}
+
+void FanController::editFan(std::size_t controller_idx, std::size_t fan_idx,
+                            std::function<void(sys::Fan&)> const& edit) {
+    std::lock_guard<std::mutex> lock(system_lock);
+    edit(system->getControllers().at(controller_idx).getFans().at(fan_idx));
 }
 
 void FanController::updateFans(sys::MonitoringMode mode, float temp) {
-    Logger::log(LogLevel::INFO) << "Update fans: " << temp << std::endl;
-    std::ostringstream log_str;
-    std::lock_guard<std::mutex> lock(hid_lock);
+    LOG_INFO(LogModule::CORE) << "Update fans: " << temp << std::endl;
+    std::lock_guard<std::mutex> lock(system_lock);
     for (auto&& c : system->getControllers()) {
+        bool queued = false;
         for (auto&& f : c.getFans()) {
             if (f.getMonitoringMode() == mode) {
                 double s = NAN;
@@ -98,25 +201,27 @@ void FanController::updateFans(sys::MonitoringMode mode, float temp) {
                 } else {
                     s = f.getBData().getSpeedForTemp(temp);
                 }
-                auto stats = wrapper->sentToFan(c.getIdx(), f.getIdx() + 1,
-                                                static_cast<uint>(s));
-                log_str << "Mode "
-                        << (mode == sys::MonitoringMode::MONITORING_GPU)
-                        << " Controller " << c.getIdx() << " Fan " << f.getIdx()
-                        << " set speed " << s << " on temp " << temp << '\n';
-                log_str << "Speed: " << stats.first << "RPM: " << stats.second
-                        << std::endl;
-                if (mediator) {
-                    mediator->notify(
-                        EventMessageType::UPDATE_STATS,
-                        std::make_shared<StatsMessage>(
-                            StatsMessage{c.getIdx(), f.getIdx(), stats.first,
-                                         stats.second}));
+                wrapper->queueFanSpeed(c.getIdx(), f.getIdx() + 1,
+                                       static_cast<uint>(s));
+                if (sink) {
+                    sink->publishTarget(c.getIdx(), f.getIdx(),
+                                        static_cast<float>(s));
                 }
+                queued = true;
+                LOG_INFO(LogModule::CORE)
+                    << "Mode " << (mode == sys::MonitoringMode::MONITORING_GPU)
+                    << " Controller " << c.getIdx() << " Fan " << f.getIdx()
+                    << " set speed " << s << " on temp " << temp << std::endl;
             }
         }
+
+        if (!queued) {
+            continue;
+        }
+
+        // All speed writes of the controller leave in one batch
+        wrapper->flush(c.getIdx());
     }
-    Logger::log(LogLevel::INFO) << log_str.str() << std::endl;
 }
 
 };  // namespace core
@@ -0,0 +1,32 @@
+#include "core/frameClock.hpp"
+
+#include <thread>
+
+namespace core {
+
+FrameClock::FrameClock(Clock::duration period)
+    : frame_period(period),
+      deadline(Clock::now() + period),
+      last_frame(Clock::now()),
+      lateness_histogram(std::make_shared<sys::LatencyHistogram>()) {}
+
+auto FrameClock::wait() -> Clock::duration {
+    std::this_thread::sleep_until(deadline);
+    auto now = Clock::now();
+
+    auto late = now - deadline;
+    lateness_histogram->record(late);
+    if (frame_period > Clock::duration::zero() && late >= frame_period) {
+        auto missed = late / frame_period;
+        missed_num.fetch_add(missed, std::memory_order_relaxed);
+        deadline += missed * frame_period;
+    }
+    deadline += frame_period;
+    frames_num.fetch_add(1, std::memory_order_relaxed);
+
+    auto delta = now - last_frame;
+    last_frame = now;
+    return delta;
+}
+
+}  // namespace core
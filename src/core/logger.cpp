@@ -1,5 +1,6 @@
 #include "core/logger.hpp"
 
+#include <algorithm>
 #include <ctime>
 #include <iomanip>
 #include <ios>
@@ -12,22 +13,37 @@ namespace core {
 
 Logger Logger::log;
 
-Logger::Logger() = default;
+Logger::Logger() {
+    for (auto& level : module_levels) {
+        level.store(COMPILED_LOG_LEVEL, std::memory_order_relaxed);
+    }
+}
 
 Logger::~Logger() {
+    disableAsync();
     std::scoped_lock<std::mutex> const LOCK(logMutex);
     if (logFile.is_open()) {
         logFile.close();
     }
 }
 
-std::string Logger::getTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto now_c = std::chrono::system_clock::to_time_t(now);
+auto Logger::line() -> LineBuffer& {
+    thread_local LineBuffer buffer;
+    return buffer;
+}
+
+auto Logger::getTimestamp(std::chrono::system_clock::time_point ts)
+    -> std::string const& {
+    auto now_c = std::chrono::system_clock::to_time_t(ts);
 
-    std::ostringstream oss;
-    oss << std::put_time(std::localtime(&now_c), "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+    // Lines mostly arrive in bursts within the same second
+    if (now_c != cached_second || cached_timestamp.empty()) {
+        std::ostringstream oss;
+        oss << std::put_time(std::localtime(&now_c), "%Y-%m-%d %H:%M:%S");
+        cached_timestamp = oss.str();
+        cached_second = now_c;
+    }
+    return cached_timestamp;
 }
 
 auto Logger::getColorCode(LogLevel level) const -> std::string {
@@ -50,51 +66,192 @@ auto Logger::resetColor() const -> std::string {
     return useColor ? "\033[0m" : "";
 }
 
-auto Logger::shouldLog(LogLevel level) -> bool {
-    if constexpr (!INFO_LOGS_ENABLE) {
-        return level != LogLevel::INFO;
+auto Logger::operator()(LogLevel level, LogModule module) -> Logger& {
+    LineBuffer& l = line();
+
+    // A line left without std::endl is still written
+    if (l.active && !l.text.empty()) {
+        commit(l);
+    }
+
+    l.active = enabled(module, level);
+    if (l.active) {
+        l.level = level;
+        l.ts = std::chrono::system_clock::now();
+        l.text.clear();
+    }
+    return *this;
+}
+
+auto Logger::operator<<(std::ostream& (*manip)(std::ostream&)) -> Logger& {
+    LineBuffer& l = line();
+    if (!l.active) {
+        return *this;
+    }
+
+    if (manip == static_cast<std::ostream& (*)(std::ostream&)>(std::endl)) {
+        commit(l);
+    }
+    return *this;
+}
+
+void Logger::commit(LineBuffer& l) {
+    l.active = false;
+
+    // Records have a fixed size, a longer line is written synchronously
+    // instead of being cut off
+    bool fits = l.text.size() <= LOG_RECORD_TEXT_SIZE;
+    if (fits && async_enabled.load(std::memory_order_acquire) && push(l)) {
+        // disableAsync() may have drained for the last time just before the
+        // push, the record is then written from here. Pairs with the fence
+        // in disableAsync().
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!async_enabled.load(std::memory_order_relaxed)) {
+            std::scoped_lock const LOCK(logMutex);
+            drainLocked();
+        }
+        l.text.clear();
+        return;
+    }
+
+    // Queued lines first, the order of lines is kept
+    std::scoped_lock const LOCK(logMutex);
+    drainLocked();
+    writeLine(l.level, l.ts, l.text);
+    flushOutputs();
+    l.text.clear();
+}
+
+auto Logger::push(LineBuffer const& l) -> bool {
+    LogRecord record{};
+    record.level = l.level;
+    record.ts = l.ts;
+    record.len = static_cast<uint16_t>(
+        std::min(l.text.size(), LOG_RECORD_TEXT_SIZE));
+    std::copy_n(l.text.data(), record.len, record.text.data());
+
+    while (!ring->tryPush(record)) {
+        if (overflow_policy == LogOverflowPolicy::DROP) {
+            dropped_records++;
+            return true;
+        }
+        if (!async_enabled.load(std::memory_order_acquire)) {
+            return false;
+        }
+        pending.fetch_add(1, std::memory_order_release);
+        pending.notify_one();
+        std::this_thread::yield();
     }
+
+    pending.fetch_add(1, std::memory_order_release);
+    pending.notify_one();
     return true;
 }
 
-auto Logger::operator()(LogLevel level) -> Logger& {
+void Logger::writerLoop(std::stop_token const& stop) {
+    for (;;) {
+        uint32_t seen = pending.load(std::memory_order_acquire);
+        drain();
+        if (stop.stop_requested()) {
+            drain();
+            return;
+        }
+        pending.wait(seen, std::memory_order_acquire);
+    }
+}
+
+void Logger::drain() {
     std::scoped_lock const LOCK(logMutex);
+    drainLocked();
+}
 
-    if (!shouldLog(level)) {
-        return *this;
+void Logger::drainLocked() {
+    if (!ring) {
+        return;
     }
 
-    currentLevel = level;
-    logBuffer.str("");
-    logBuffer.clear();
-    logBuffer << getTimestamp() << " " << "["
-              << (level == LogLevel::INFO      ? "INFO"
-                  : level == LogLevel::WARNING ? "WARNING"
-                                               : "ERROR")
-              << "] ";
-    flush(logBuffer.str());
-    return *this;
+    LogRecord record{};
+    bool written = false;
+    while (ring->tryPop(record)) {
+        writeLine(record.level, record.ts,
+                  std::string_view(record.text.data(), record.len));
+        written = true;
+    }
+    if (written) {
+        flushOutputs();
+    }
 }
 
-auto Logger::operator<<(std::ostream& (*manip)(std::ostream&)) -> Logger& {
+void Logger::writeLine(LogLevel level, std::chrono::system_clock::time_point ts,
+                       std::string_view text) {
+    std::string_view level_name = level == LogLevel::INFO      ? "INFO"
+                                  : level == LogLevel::WARNING ? "WARNING"
+                                                               : "ERROR";
+    std::string const& timestamp = getTimestamp(ts);
+    while (!text.empty() && text.back() == '\n') {
+        text.remove_suffix(1);
+    }
+
+    if (logToConsole) {
+        std::cout << getColorCode(level) << timestamp << " [" << level_name
+                  << "] " << text << resetColor() << '\n';
+    }
+
+    if (logFile.is_open()) {
+        logFile << timestamp << " [" << level_name << "] " << text << '\n';
+    }
+}
+
+void Logger::flushOutputs() {
+    if (logToConsole) {
+        std::cout.flush();
+    }
+    if (logFile.is_open()) {
+        logFile.flush();
+    }
+}
+
+void Logger::enableAsync(std::size_t ring_size, LogOverflowPolicy policy) {
     std::scoped_lock const LOCK(logMutex);
+    if (async_enabled.load()) {
+        return;
+    }
 
-    if (!shouldLog(currentLevel)) {
-        return *this;
+    if (!ring) {
+        ring = std::make_unique<RingBuffer<LogRecord>>(ring_size);
     }
+    overflow_policy = policy;
+    writer = std::jthread(
+        [this](std::stop_token const& stop) { writerLoop(stop); });
+    async_enabled.store(true, std::memory_order_release);
+}
 
-    if (manip == static_cast<std::ostream& (*)(std::ostream&)>(std::endl)) {
-        logBuffer.clear();
-        currentLevel = LogLevel::INFO;
-        flush("\n", true);
+void Logger::disableAsync() {
+    if (!async_enabled.exchange(false)) {
+        return;
     }
-    return *this;
+
+    writer.request_stop();
+    pending.fetch_add(1, std::memory_order_release);
+    pending.notify_one();
+    if (writer.joinable()) {
+        writer.join();
+    }
+
+    // Producers that raced with the switch may have left a few records,
+    // any pushed after this drain are written by their producer
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    drain();
 }
 
 void Logger::setLogFile(std::string const& filename) {
     std::scoped_lock const LOCK(logMutex);
-    flush(logBuffer.str(), true);
-    logFile.open(filename, std::ios::app);
+    if (logFile.is_open()) {
+        logFile.close();
+    }
+    if (!filename.empty()) {
+        logFile.open(filename, std::ios::app);
+    }
 }
 
 void Logger::enableConsoleLogging(bool enable) {
@@ -18,10 +18,6 @@ uint8_t FanMediator::convertChannel(float val) {
 void FanMediator::dispatch(EventMessageType event_type,
                            std::shared_ptr<Message> msg) {
     switch (event_type) {
-        case EventMessageType::UPDATE_STATS:
-            handleUpdateStats(std::static_pointer_cast<StatsMessage>(msg));
-            break;
-
         case EventMessageType::UPDATE_COLOR:
             handleUpdateColor(std::static_pointer_cast<ColorMessage>(msg));
             break;
@@ -29,24 +25,20 @@ void FanMediator::dispatch(EventMessageType event_type,
         case EventMessageType::UPDATE_EFFECT:
             handleUpdateEffect(std::static_pointer_cast<ColorMessage>(msg));
             break;
+
+        case EventMessageType::UPDATE_GRAPH:
+            handleUpdateGraph(std::static_pointer_cast<DataMessage>(msg));
+            break;
+
+        case EventMessageType::UPDATE_MONITORING_MODE_FAN:
+            handleUpdateMode(std::static_pointer_cast<ModeMessage>(msg));
+            break;
         default:
             std::cerr << "Unhandled event type\n";
             break;
     }
 }
 
-void FanMediator::handleUpdateStats(std::shared_ptr<StatsMessage> msg) {
-    if (guiManager) {
-        guiManager->updateCurrentFanStats(msg->c_idx, msg->f_idx,
-                                          msg->cur_speed, msg->cur_rpm);
-        Logger::log(LogLevel::INFO) << "Stats updated from FanController for "
-                                       "controller"
-                                    << msg->c_idx << " fan " << msg->f_idx
-                                    << " | Speed: " << msg->cur_speed
-                                    << "RPM: " << msg->cur_rpm << std::endl;
-    }
-}
-
 void FanMediator::handleUpdateColor(std::shared_ptr<ColorMessage> msg) {
     if (fanController) {
         fanController->updateFanColor(
@@ -56,7 +48,7 @@ void FanMediator::handleUpdateColor(std::shared_ptr<ColorMessage> msg) {
                                    convertChannel(msg->b)},
             msg->to_all);
 
-        Logger::log(LogLevel::INFO)
+        LOG_INFO(LogModule::CORE)
             << "Color updated from FanController for "
                "controller"
             << msg->c_idx << " fan " << msg->f_idx << "Colors:" << msg->g << " "
@@ -74,4 +66,33 @@ void FanMediator::handleUpdateEffect(std::shared_ptr<ColorMessage> msg) {
     }
 }
 
+void FanMediator::handleUpdateGraph(std::shared_ptr<DataMessage> msg) {
+    if (!fanController) {
+        return;
+    }
+
+    // at() so that a bad index from a client throws instead of corrupting,
+    // the edit itself waits for updateFans on the monitoring thread
+    fanController->editFan(msg->c_idx, msg->f_idx, [&msg](sys::Fan& fan) {
+        if (auto* points = std::get_if<FanData>(&msg->data)) {
+            fan.getData().updateData(points->t, points->s);
+        } else {
+            fan.getBData().setData(
+                std::get<std::array<std::pair<double, double>, 4>>(msg->data));
+        }
+    });
+}
+
+void FanMediator::handleUpdateMode(std::shared_ptr<ModeMessage> msg) {
+    if (!fanController) {
+        return;
+    }
+
+    auto mode = msg->mode == 0 ? sys::MonitoringMode::MONITORING_CPU
+                               : sys::MonitoringMode::MONITORING_GPU;
+    fanController->editFan(msg->c_idx, msg->f_idx, [mode](sys::Fan& fan) {
+        fan.setMonitoringMode(mode);
+    });
+}
+
 }  // namespace core
@@ -4,6 +4,7 @@
 #include <array>
 
 #include "core/logger.hpp"
+#include "core/mediators/fanMediator.hpp"
 #include "implot.h"
 #include "system/controllerData.hpp"
 
@@ -36,7 +37,7 @@ namespace core {
 void BezierCurvePlotStrategy::plot(
     std::size_t i, std::size_t j,
     std::variant<FanData, std::array<std::pair<double, double>, 4>> data,
-    std::shared_ptr<sys::System> system) {
+    std::shared_ptr<Mediator> mediator) {
     auto cp = std::get<std::array<std::pair<double, double>, 4>>(data);
     if (ImPlot::BeginPlot("Fan Control (Bezier Curve) ", ImVec2(-1, -1),
                           ImPlotFlags_NoLegend | ImPlotFlags_NoMenus)) {
@@ -63,7 +64,7 @@ void BezierCurvePlotStrategy::plot(
                     std::clamp(cp[idx].first, 0.0, 100.0);  // NOLINT
                 cp[idx].second =
                     std::clamp(cp[idx].second, 0.0, 100.0);  // NOLINT
-                if (system) {
+                if (mediator) {
                     std::ostringstream log_str;
 
                     log_str << "Control points: [ ";
@@ -73,10 +74,15 @@ void BezierCurvePlotStrategy::plot(
                     log_str << "]" << std::endl;
 
                     // Логируем
-                    Logger::log(LogLevel::INFO) << log_str.str() << std::endl;
-
-                    system->getControllers()[i].getFans()[j].getBData().setData(
-                        cp);
+                    LOG_INFO(LogModule::GUI) << log_str.str() << std::endl;
+
+                    // The monitoring thread reads the curve, only the fan
+                    // controller may change it
+                    auto msg = std::make_shared<DataMessage>();
+                    msg->c_idx = i;
+                    msg->f_idx = j;
+                    msg->data = cp;
+                    mediator->notify(EventMessageType::UPDATE_GRAPH, msg);
                 }
             }
         }
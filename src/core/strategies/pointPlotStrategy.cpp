@@ -17,7 +17,7 @@ namespace core {
 void PointPlotStrategy::plot(
     std::size_t i, std::size_t j,
     std::variant<FanData, std::array<std::pair<double, double>, 4>> data,
-    std::shared_ptr<sys::System> system) {
+    std::shared_ptr<Mediator> mediator) {
     auto d = std::get<FanData>(data);
     auto temperatures = d.t;
     auto speeds = d.s;
@@ -36,7 +36,7 @@ void PointPlotStrategy::plot(
                                   ImPlotDragToolFlags_DisableX)) {
                 temperatures[idx] = std::clamp(temperatures[idx], 0.0, 100.0);
                 speeds[idx] = std::clamp(speeds[idx], 0.0, 100.0);
-                if (system) {
+                if (mediator) {
                     std::ostringstream log_str;
                     log_str << "Temperatures: [ ";
                     for (auto&& t : temperatures) {
@@ -51,12 +51,15 @@ void PointPlotStrategy::plot(
                     log_str << "]\n";
 
                     // Логируем
-                    Logger::log(LogLevel::INFO) << log_str.str() << std::endl;
+                    LOG_INFO(LogModule::GUI) << log_str.str() << std::endl;
 
-                    system->getControllers()[i]
-                        .getFans()[j]
-                        .getData()
-                        .updateData(temperatures, speeds);
+                    // The monitoring thread reads the curve, only the fan
+                    // controller may change it
+                    auto msg = std::make_shared<DataMessage>();
+                    msg->c_idx = i;
+                    msg->f_idx = j;
+                    msg->data = FanData{temperatures, speeds};
+                    mediator->notify(EventMessageType::UPDATE_GRAPH, msg);
                 }
             }
         }
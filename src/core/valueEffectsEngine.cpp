@@ -0,0 +1,63 @@
+#include "core/valueEffectsEngine.hpp"
+
+#include <utility>
+
+#include "core/logger.hpp"
+
+namespace core {
+
+void ValueEffectsEngine::addEffect(Effect effect) {
+    effects.push_back(std::move(effect));
+}
+
+void ValueEffectsEngine::setActiveEffect(std::size_t index) {
+    if (effects.empty()) {
+        return;
+    }
+    active_effect = index < effects.size() ? index : effects.size() - 1;
+
+    LOG_INFO(core::LogModule::CORE)
+        << "Active effect set to index " << active_effect.value() << std::endl;
+}
+
+void ValueEffectsEngine::setActiveEffect(Effect effect) {
+    if (active_effect.has_value()) {
+        effects[active_effect.value()] = std::move(effect);
+        LOG_INFO(core::LogModule::CORE) << "Active effect set" << std::endl;
+    }
+}
+
+void ValueEffectsEngine::updateActiveEffect(EffectColor color,
+                                            EffectDuration duration) {
+    if (active_effect.has_value()) {
+        effects[active_effect.value()].configure(
+            EffectParams(color[0], color[1], color[2], duration));
+    }
+}
+
+auto ValueEffectsEngine::hasActiveEffect() const -> bool {
+    return active_effect.has_value();
+}
+
+void ValueEffectsEngine::resetActiveEffect() { active_effect.reset(); }
+
+auto ValueEffectsEngine::update(EffectDuration interval) -> EffectColor {
+    if (!active_effect.has_value()) {
+        return {0, 0, 0};
+    }
+
+    auto& effect = effects[active_effect.value()];
+    EffectColor result = effect.execute(interval);
+    if (effect.isFinished()) {
+        LOG_INFO(core::LogModule::CORE)
+            << "Active effect finished" << std::endl;
+        active_effect.reset();
+    }
+    return result;
+}
+
+auto ValueEffectsEngine::getEffectCount() const -> std::size_t {
+    return effects.size();
+}
+
+}  // namespace core
@@ -0,0 +1,130 @@
+#include "gui/framePacer.hpp"
+
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <utility>
+
+#include "GLFW/glfw3.h"
+#include "core/logger.hpp"
+
+constexpr double const PERCENT = 100.0;
+
+namespace {
+
+auto processCpuTime() -> std::chrono::nanoseconds {
+    timespec ts{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return std::chrono::seconds(ts.tv_sec) +
+           std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+auto toSeconds(std::chrono::milliseconds ms) -> double {
+    return std::chrono::duration<double>(ms).count();
+}
+
+}  // namespace
+
+namespace gui {
+
+FramePacer::FramePacer(FramePolicy policy)
+    : policy(policy),
+      report_start(std::chrono::steady_clock::now()),
+      report_cpu_start(processCpuTime()) {}
+
+void FramePacer::markDirty() {
+    dirty.store(true);
+    glfwPostEmptyEvent();
+}
+
+void FramePacer::watch(GenerationSource source) {
+    uint64_t current = source();
+    sources.emplace_back(std::move(source), current);
+}
+
+auto FramePacer::sourcesChanged() -> bool {
+    bool changed = false;
+    for (auto& [source, seen] : sources) {
+        uint64_t current = source();
+        if (current != seen) {
+            seen = current;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+auto FramePacer::waitForFrame(bool hidden) -> bool {
+    sampleCpu();
+
+    if (hidden) {
+        // Whatever changed meanwhile is drawn once the window is shown
+        glfwWaitEventsTimeout(toSeconds(policy.hidden_wait));
+        frames_left = 0;
+        return false;
+    }
+
+    if (policy.max_fps > 0) {
+        std::this_thread::sleep_until(
+            last_frame + std::chrono::duration_cast<
+                             std::chrono::steady_clock::duration>(
+                             std::chrono::duration<double>(
+                                 1.0 / policy.max_fps)));
+    }
+
+    if (!frameDue()) {
+        return false;
+    }
+
+    last_frame = std::chrono::steady_clock::now();
+    frames_left = std::max(frames_left - 1, 0);
+    rendered_frames++;
+    report_frames++;
+    return true;
+}
+
+auto FramePacer::frameDue() -> bool {
+    if (frames_left > 0 || dirty.exchange(false) || sourcesChanged()) {
+        glfwPollEvents();
+        return true;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    glfwWaitEventsTimeout(toSeconds(policy.idle_wait));
+
+    // Returning before the timeout means input or an empty event arrived
+    if (std::chrono::steady_clock::now() - start < policy.idle_wait) {
+        frames_left = policy.frames_after_input;
+        dirty.store(false);
+        return true;
+    }
+    return dirty.exchange(false) || sourcesChanged();
+}
+
+void FramePacer::sampleCpu() {
+    auto now = std::chrono::steady_clock::now();
+    if (now - report_start < CPU_REPORT_PERIOD) {
+        return;
+    }
+
+    auto cpu = processCpuTime();
+    double usage = std::chrono::duration<double>(cpu - report_cpu_start) /
+                   std::chrono::duration<double>(now - report_start);
+    cpu_usage.store(usage);
+
+    LOG_INFO(core::LogModule::GUI)
+        << (report_frames == 0 ? "Idle" : "Active")
+        << " CPU usage: " << usage * PERCENT << "% with " << report_frames
+        << " frames in the last "
+        << std::chrono::duration_cast<std::chrono::seconds>(now - report_start)
+               .count()
+        << " s" << std::endl;
+
+    report_start = now;
+    report_cpu_start = cpu;
+    report_frames = 0;
+}
+
+}  // namespace gui
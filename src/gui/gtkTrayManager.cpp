@@ -140,7 +140,7 @@ void GTKTrayManager::openFileChooserDialog(char const* title,
                        FileDialogCallback>(  // NOLINT
             title, action, std::move(callback)));
 
-    core::Logger::log(core::LogLevel::INFO)
+    LOG_INFO(core::LogModule::GUI)
         << title << " dialog requested." << std::endl;
 }
 
@@ -24,6 +24,7 @@ constexpr int const SHIFT = 10;
 constexpr double const SCALE = 1.4F;
 constexpr int const TABLE_COLUMNS = 5;
 constexpr int const FAN_BUTTON_SIZE = 120;
+constexpr double const PERCENT = 100.0;
 
 namespace gui {
 auto GuiManager::extensions() -> std::shared_ptr<ImVector<char const*>> {
@@ -43,12 +44,6 @@ void GuiManager::setMediator(std::shared_ptr<core::Mediator> mediator) {
     this->mediator = std::move(mediator);
 }
 
-void GuiManager::updateCurrentFanStats(std::size_t controller_idx,
-                                       std::size_t fan_idx, std::size_t speed,
-                                       std::size_t rpm) {
-    stats[controller_idx * SHIFT + fan_idx] = {speed, rpm};
-}
-
 GuiManager::GuiManager(std::shared_ptr<GLFWwindow> const& window,
                        std::shared_ptr<sys::System> system)
     : system(system) {
@@ -73,7 +68,7 @@ void GuiManager::renderMenuBar() {
     if (ImGui::BeginMenuBar()) {
         if (ImGui::BeginMenu("File")) {
             if (ImGui::MenuItem("Open")) {
-                core::Logger::log(core::LogLevel::INFO) << "Open" << std::endl;
+                LOG_INFO(core::LogModule::GUI) << "Open" << std::endl;
                 if (fileDialogCallbacks.contains("onOpenFile") != 0u) {
                     for (auto&& c : fileDialogCallbacks["onOpenFile"]) {
                         c("dummy_open_file");
@@ -81,7 +76,7 @@ void GuiManager::renderMenuBar() {
                 }
             }
             if (ImGui::MenuItem("Save to")) {
-                core::Logger::log(core::LogLevel::INFO) << "Save" << std::endl;
+                LOG_INFO(core::LogModule::GUI) << "Save" << std::endl;
                 if (fileDialogCallbacks.contains("onSaveFile") != 0u) {
                     for (auto&& c : fileDialogCallbacks["onSaveFile"]) {
                         c("dummy_open_file");
@@ -91,7 +86,7 @@ void GuiManager::renderMenuBar() {
             ImGui::EndMenu();
         }
         if (ImGui::MenuItem("Quit")) {
-            core::Logger::log(core::LogLevel::INFO) << "Quit" << std::endl;
+            LOG_INFO(core::LogModule::GUI) << "Quit" << std::endl;
             if (generalCallbacks.contains("onQuit") != 0u) {
                 for (auto&& c : generalCallbacks["onQuit"]) {
                     c();
@@ -136,13 +131,15 @@ void GuiManager::renderTable() {
                 ImGui::PushID(static_cast<int>(i * 4 + j));
                 if (ImGui::Button("Fan speed curve settings",
                                   ImVec2(FAN_BUTTON_SIZE, FAN_BUTTON_SIZE))) {
-                    core::Logger::log(core::LogLevel::INFO)
+                    LOG_INFO(core::LogModule::GUI)
                         << "Button" << std::endl;
                     ImGui::OpenPopup("fctl", ImGuiPopupFlags_AnyPopupLevel);
                 }
 
-                ImGui::Text("Speed: %d", stats[i * SHIFT + j].first);  // NOLINT
-                ImGui::Text("Rpm: %d", stats[i * SHIFT + j].second);   // NOLINT
+                auto sample = telemetry ? telemetry->load(i, j)
+                                        : sys::FanSample{0, 0, false};
+                ImGui::Text("Speed: %zu", sample.speed);  // NOLINT
+                ImGui::Text("Rpm: %zu", sample.rpm);      // NOLINT
 
                 ImGui::SetNextWindowSize(
                     ImVec2(static_cast<float>(size.first / 2),
@@ -163,13 +160,13 @@ void GuiManager::renderTable() {
                             if (ImGui::Selectable(items_span[n].data(),
                                                   is_selected)) {
                                 current_item = items_span[n];
-                                system->getControllers()[i]
-                                    .getFans()[j]
-                                    .setMonitoringMode(
-                                        n == 0 ? sys::MonitoringMode::
-                                                     MONITORING_CPU
-                                               : sys::MonitoringMode::
-                                                     MONITORING_GPU);
+                                if (mediator) {
+                                    mediator->notify(
+                                        EventMessageType::
+                                            UPDATE_MONITORING_MODE_FAN,
+                                        std::make_shared<ModeMessage>(
+                                            ModeMessage{i, j, n}));
+                                }
                             }
                             if (is_selected) ImGui::SetItemDefaultFocus();
                         }
@@ -219,6 +216,20 @@ void GuiManager::renderMonitoring() {
     ImGui::Text("%s temp:", gpu_name.c_str());  // NOLINT
 
     ImGui::Text("%d °C", static_cast<int>(current_gpu_temp));  // NOLINT
+
+    if (pacer) {
+        ImGui::Text("Fan control CPU: %.1f %%",  // NOLINT
+                    pacer->cpuUsage() * PERCENT);
+    }
+}
+
+void GuiManager::updateTemp(float& current, float temp) {
+    // Only whole degrees are shown
+    bool shown_changed = static_cast<int>(current) != static_cast<int>(temp);
+    current = temp;
+    if (shown_changed && pacer) {
+        pacer->markDirty();
+    }
 }
 
 void GuiManager::renderColorForAll() {
@@ -237,12 +248,13 @@ void GuiManager::renderColorForAll() {
         }
     }
 
-    char const* items[] = {"Rainbow", "Rainbow Fade", "Static", "Custom"};
+    char const* items[] = {"Rainbow", "Rainbow Fade", "Static", "Custom",
+                           "Rainbow Spin"};
     static char const* current = items[0];
     static int e = 0;
     static int d = 2;
     if (ImGui::BeginCombo("Effect", current)) {
-        for (int n = 0; n < 4; n++) {
+        for (int n = 0; n < static_cast<int>(std::size(items)); n++) {
             bool is_selected = (current == items[n]);
             if (ImGui::Selectable(items[n], is_selected)) {
                 current = items[n];
@@ -323,7 +335,8 @@ void GuiManager::printPlot(std::size_t i, std::size_t j) {
     auto temperatures = data.first;
     auto speeds = data.second;
 
-    core::PlotDrawVisitor visitor(i, j, bdata, temperatures, speeds, system);
+    core::PlotDrawVisitor visitor(i, j, bdata, temperatures, speeds,
+                                  mediator);
 
     plot_stategy->accept(visitor);
 }
@@ -37,7 +37,7 @@ WindowManager::WindowManager(char const* title, int width, int height) {
 
     glfwSetWindowCloseCallback(
         window.get(), +[](GLFWwindow* window) {
-            core::Logger::log(core::LogLevel::INFO)
+            LOG_INFO(core::LogModule::GUI)
                 << "Close Callback" << std::endl;
             glfwSetWindowShouldClose(window, false);
             auto* manager =
@@ -58,7 +58,7 @@ void WindowManager::closeWindow() { glfwSetWindowShouldClose(window.get(), 1); }
 void WindowManager::hideWindow() {
     if (window) {
         glfwHideWindow(window.get());
-        core::Logger::log(core::LogLevel::INFO)
+        LOG_INFO(core::LogModule::GUI)
             << "GLFW window hidden." << std::endl;
     }
 }
@@ -84,7 +84,7 @@ void WindowManager::showWindow() {
     if (window) {
         glfwShowWindow(window.get());
         glfwFocusWindow(window.get());
-        core::Logger::log(core::LogLevel::INFO)
+        LOG_INFO(core::LogModule::GUI)
             << "GLFW window shown." << std::endl;
     }
 }
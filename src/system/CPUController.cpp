@@ -20,22 +20,12 @@ CPUController::CPUController() {
     cpuInfoCpuName();
 }
 
-CPUController::~CPUController() {
-    if (cpu_file.is_open()) cpu_file.close();
-}
+CPUController::~CPUController() = default;
 
 auto CPUController::readCpuTempFile(int& temp) -> bool {
-    if (!cpu_file.is_open()) {
-        return false;
-    }
-    cpu_file.clear();
-    cpu_file.seekg(0, std::ios::beg);
-
-    int ctemp = 0;
-    cpu_file >> ctemp;
-
-    if (cpu_file.fail()) {
-        core::Logger::log(core::LogLevel::INFO)
+    long ctemp = 0;
+    if (!cpu_file.readInt(ctemp)) {
+        LOG_INFO(core::LogModule::MONITORING)
             << "Cannot read cpu temp" << std::endl;
         return false;
     }
@@ -47,7 +37,7 @@ auto CPUController::readCpuTempFile(int& temp) -> bool {
 auto CPUController::getCPUName() -> std::string { return cpu_name; }
 
 bool CPUController::getCPUFile() {
-    if (cpu_file.is_open()) {
+    if (cpu_file.isOpen()) {
         return true;
     }
 
@@ -60,7 +50,7 @@ bool CPUController::getCPUFile() {
     for (auto& dir : dirs) {
         path = HWMON + dir;
         name = readLine(path + "/name");
-        core::Logger::log(core::LogLevel::INFO)
+        LOG_INFO(core::LogModule::MONITORING)
             << std::format("hwmon: sensor name: {}", name) << '\n';
 
         if (name == "coretemp") {
@@ -91,15 +81,13 @@ bool CPUController::getCPUFile() {
     }
     if (path.empty() ||
         (!fileExists(input) && !findFallbackInput(path, "temp", input))) {
-        core::Logger::log(core::LogLevel::WARNING)
+        LOG_WARNING(core::LogModule::MONITORING)
             << std::format("Could not find cpu temp sensor location") << '\n';
         return false;
     }
-    core::Logger::log(core::LogLevel::INFO)
+    LOG_INFO(core::LogModule::MONITORING)
         << std::format("hwmon: using input: {}", input) << std::endl;
-    cpu_file.open(input.c_str());
-
-    return true;
+    return cpu_file.open(input);
 }
 
 void CPUController::cpuInfoCpuName() {
@@ -25,7 +25,7 @@ GPUController::GPUController() {
                         std::string vendor_id;
                         fin >> vendor_id;  // например, "0x10de"
                         if (vendor_id == "0x10de") {
-                            core::Logger::log(core::LogLevel::INFO)
+                            LOG_INFO(core::LogModule::MONITORING)
                                 << entry.path().filename().string()
                                 << " -> NVIDIA\n";
                             gpu = std::make_unique<Nvidia>();
@@ -37,18 +37,18 @@ GPUController::GPUController() {
                             gpu = std::make_unique<AMD>(
                                 entry.path().filename().string());
                         } else if (vendor_id == "0x8086") {
-                            core::Logger::log(core::LogLevel::WARNING)
+                            LOG_WARNING(core::LogModule::MONITORING)
                                 << entry.path().filename().string()
                                 << " -> Intel\n";
-                            core::Logger::log(core::LogLevel::WARNING)
+                            LOG_WARNING(core::LogModule::MONITORING)
                                 << "Intel GPU not supported. Set dummy GPU"
                                 << std::endl;
                             gpu = std::make_unique<DummyGPU>();
                         } else {
-                            core::Logger::log(core::LogLevel::WARNING)
+                            LOG_WARNING(core::LogModule::MONITORING)
                                 << entry.path().filename().string()
                                 << " -> Unknown vendor: " << vendor_id << "\n";
-                            core::Logger::log(core::LogLevel::WARNING)
+                            LOG_WARNING(core::LogModule::MONITORING)
                                 << "Unknown GPU. Set dummy GPU" << std::endl;
                             gpu = std::make_unique<DummyGPU>();
                         }
@@ -57,7 +57,7 @@ GPUController::GPUController() {
             }
         }
     } catch (std::exception const& e) {
-        core::Logger::log(core::LogLevel::INFO)
+        LOG_INFO(core::LogModule::MONITORING)
             << "Failed initialize GPU: " << e.what() << std::endl;
     }
 }
@@ -0,0 +1,110 @@
+#include "system/bezierSolver.hpp"
+
+#include <cmath>
+#include <cstddef>
+
+constexpr double const BISECT_EPSILON = 0.001;
+constexpr std::size_t const BISECT_MAX_ITERATIONS = 10000;
+
+namespace {
+
+auto cubic(double p0, double p1, double p2, double p3, double t) -> double {
+    double u = 1.0 - t;
+    return u * u * u * p0 + 3 * u * u * t * p1 + 3 * u * t * t * p2 +
+           t * t * t * p3;
+}
+
+}  // namespace
+
+namespace sys {
+
+BezierSolver::BezierSolver(ControlPoints const& control_points)
+    : cp(control_points) {
+    for (std::size_t k = 0; k <= BEZIER_SEED_SEGMENTS; k++) {
+        seed_x[k] = xAt(static_cast<double>(k) / BEZIER_SEED_SEGMENTS);
+    }
+}
+
+auto BezierSolver::xAt(double t) const -> double {
+    return cubic(cp[0].first, cp[1].first, cp[2].first, cp[3].first, t);
+}
+
+auto BezierSolver::dxAt(double t) const -> double {
+    double u = 1.0 - t;
+    return 3 * u * u * (cp[1].first - cp[0].first) +
+           6 * u * t * (cp[2].first - cp[1].first) +
+           3 * t * t * (cp[3].first - cp[2].first);
+}
+
+auto BezierSolver::pointAt(double t) const -> std::pair<double, double> {
+    return {xAt(t),
+            cubic(cp[0].second, cp[1].second, cp[2].second, cp[3].second, t)};
+}
+
+auto BezierSolver::speedForTemp(double temp) const -> double {
+    if (temp <= seed_x.front()) {
+        return cp[0].second;
+    }
+    if (temp >= seed_x.back()) {
+        return cp[3].second;
+    }
+
+    std::size_t k = 0;
+    while (k + 1 < BEZIER_SEED_SEGMENTS && seed_x[k + 1] < temp) {
+        k++;
+    }
+
+    double t_low = static_cast<double>(k) / BEZIER_SEED_SEGMENTS;
+    double t_high = static_cast<double>(k + 1) / BEZIER_SEED_SEGMENTS;
+    double span = seed_x[k + 1] - seed_x[k];
+    double t = span > 0 ? t_low + (t_high - t_low) * (temp - seed_x[k]) / span
+                        : t_low;
+
+    for (std::size_t i = 0; i < BEZIER_NEWTON_MAX_ITERATIONS; i++) {
+        double f = xAt(t) - temp;
+        if (std::abs(f) < BEZIER_NEWTON_EPSILON) {
+            break;
+        }
+
+        if (f < 0) {
+            t_low = t;
+        } else {
+            t_high = t;
+        }
+
+        // Fall back to a bisection step when Newton leaves the bracket
+        double d = dxAt(t);
+        double next = d > 0 ? t - f / d : t_low - 1.0;
+        t = next > t_low && next < t_high ? next : (t_low + t_high) / 2;
+    }
+
+    return pointAt(t).second;
+}
+
+auto BezierSolver::bisect(ControlPoints const& control_points, double temp)
+    -> double {
+    BezierSolver const solver(control_points);
+    double t_low = 0.0;
+    double t_high = 1.0;
+    double t_mid = NAN;
+    double const HALF = 2.0;
+
+    for (std::size_t i = 0; i < BISECT_MAX_ITERATIONS; ++i) {
+        t_mid = (t_low + t_high) / HALF;
+        auto p = solver.pointAt(t_mid);
+
+        if (std::abs(p.first - temp) < BISECT_EPSILON) {
+            return p.second;
+        }
+
+        if (p.first < temp) {
+            t_low = t_mid;
+        } else {
+            t_high = t_mid;
+        }
+    }
+
+    return solver.pointAt(t_mid).second;
+}
+
+}  // namespace sys
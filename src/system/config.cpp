@@ -44,7 +44,7 @@ void Config::printConfig(std::shared_ptr<sys::System> const& system) {
         }
     }
 
-    core::Logger::log(core::LogLevel::INFO) << log_str.str() << std::endl;
+    LOG_INFO(core::LogModule::CONFIG) << log_str.str() << std::endl;
 }
 
 void Config::updateConf(std::shared_ptr<sys::System> const& system) {
@@ -89,7 +89,7 @@ void Config::writeToFile(std::string_view path) {
     if (path.empty()) {
         home = std::getenv("HOME");
         if (!home) {
-            core::Logger::log(core::LogLevel::WARNING)
+            LOG_WARNING(core::LogModule::CONFIG)
                 << "HOME enviroment variable not set" << std::endl;
             return;
         } else {
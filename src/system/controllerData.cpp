@@ -1,8 +1,9 @@
 #include "system/controllerData.hpp"
 
-#include <cmath>
+#include <algorithm>
+#include <span>
 
-#include "core/logger.hpp"
+#include "system/bezierSolver.hpp"
 
 constexpr int const MIN_TEMP = 0;
 constexpr int const MAX_TEMP = 100;
@@ -14,11 +15,20 @@ constexpr double const END_POINT = 100.0;
 constexpr double const DEFAULT_MIDDLE_FIRST_POINT = 40.0;
 constexpr double const DEFAULT_MIDDLE_SECOND_POINT = 60.0;
 
-constexpr double const EPSILON = 0.001;
-constexpr std::size_t const MAX_ITERATIONS = 10000;
-
 namespace sys {
 
+auto SpeedLut::lookup(double temp) const -> double {
+    double pos = std::clamp(temp, 0.0, LUT_MAX_TEMP) *
+                 static_cast<double>(LUT_STEPS_PER_DEGREE);
+    auto i = static_cast<std::size_t>(pos);
+    if (i + 1 >= table.size()) {
+        return table.back();
+    }
+
+    double frac = pos - static_cast<double>(i);
+    return table[i] + (table[i + 1] - table[i]) * frac;
+}
+
 FanSpeedData::FanSpeedData() {
     for (size_t k = MIN_TEMP; k <= MAX_TEMP; k += TEMP_STEP) {
         addTemp(static_cast<float>(k));
@@ -28,40 +38,60 @@ FanSpeedData::FanSpeedData() {
 
 void FanSpeedData::addSpeed(float s) {
     speeds.push_back(static_cast<double>(s));
+    lut.invalidate();
+}
+void FanSpeedData::addTemp(float t) {
+    temps.push_back(static_cast<double>(t));
+    lut.invalidate();
 }
-void FanSpeedData::addTemp(float t) { temps.push_back(static_cast<double>(t)); }
 
 void FanSpeedData::updateData(std::vector<double> t, std::vector<double> s) {
     temps.clear();
     speeds.clear();
     temps = std::move(t);
     speeds = std::move(s);
+    lut.invalidate();
 }
 
-auto FanSpeedData::getTData() -> std::vector<double>* { return &temps; }
-auto FanSpeedData::getSData() -> std::vector<double>* { return &speeds; }
+// Callers may edit through the returned pointers
+auto FanSpeedData::getTData() -> std::vector<double>* {
+    lut.invalidate();
+    return &temps;
+}
+auto FanSpeedData::getSData() -> std::vector<double>* {
+    lut.invalidate();
+    return &speeds;
+}
 auto FanSpeedData::getData()
     -> std::pair<std::vector<double>, std::vector<double>> {
     return {temps, speeds};
 }
 
 double FanSpeedData::getSpeedForTemp(float const& temp) {
-    using pair = std::pair<double, double>;
+    if (lut.isDirty()) {
+        lut.build([this](double t) { return interpolate(t); });
+    }
 
-    pair p1, p2;
+    return lut.lookup(temp);
+}
+
+auto FanSpeedData::interpolate(double temp) const -> double {
+    if (temps.empty() || speeds.size() < temps.size()) {
+        return 0.0;
+    }
 
     auto it = std::lower_bound(temps.begin(), temps.end(), temp);
     auto n = std::distance(temps.begin(), it);
 
-    if (n == 0) return speeds[n];
-    p1.first = temps[n];
-    p2.first = temps[n - 1];
-    p1.second = speeds[n];
-    p2.second = speeds[n - 1];
+    if (n == 0) {
+        return speeds[0];
+    }
+    if (it == temps.end()) {
+        return speeds[temps.size() - 1];
+    }
 
-    core::Logger::log(core::LogLevel::INFO)
-        << "Points: " << "[" << p1.first << ", " << p1.second << "] ["
-        << p2.first << ", " << p2.second << "]" << std::endl;
+    std::pair<double, double> p1{temps[n], speeds[n]};
+    std::pair<double, double> p2{temps[n - 1], speeds[n - 1]};
 
     return p1.second + ((p2.second - p1.second) / (p2.first - p1.first)) *
                            (temp - p1.first);
@@ -79,58 +109,27 @@ FanBezierData::FanBezierData() {
 void FanBezierData::addControlPoint(std::pair<double, double> const& cp) {
     std::span<std::pair<double, double>> cp_span(controlPoints);
     cp_span[idx++] = std::move(cp);
+    lut.invalidate();
 }
 
-auto FanBezierData::getData() -> std::array<std::pair<double, double>, 4>& {
+auto FanBezierData::getData() const
+    -> std::array<std::pair<double, double>, 4> const& {
     return controlPoints;
 }
 
 void FanBezierData::setData(
     std::array<std::pair<double, double>, 4> const& data) {
     controlPoints = std::move(data);
+    lut.invalidate();
 }
 
 double FanBezierData::getSpeedForTemp(float const& temp) {
-    using pair = std::pair<double, double>;
-    double t_low = 0.0, t_high = 1.0;
-    double t_mid = NAN;
-    double const HALF = 2.0;
-
-    for (int i = 0; i < MAX_ITERATIONS; ++i) {
-        t_mid = (t_low + t_high) / HALF;
-        pair p = computeBezierAtT(t_mid);
-
-        if (std::abs(p.first - temp) < EPSILON) {
-            return p.second;
-        }
-
-        if (p.first < temp) {
-            t_low = t_mid;
-        } else {
-            t_high = t_mid;
-        }
+    if (lut.isDirty()) {
+        BezierSolver const solver(controlPoints);
+        lut.build([&solver](double t) { return solver.speedForTemp(t); });
     }
 
-    return computeBezierAtT(t_mid)
-        .second;
-}
-
-std::pair<double, double> FanBezierData::computeBezierAtT(double t) {
-    double u = 1.0 - t;
-    double tt = t * t;
-    double uu = u * u;
-    double uuu = uu * u;
-    double ttt = tt * t;
-
-    std::pair<double, double> p;
-    p.first =
-        uuu * controlPoints[0].first + 3 * uu * t * controlPoints[1].first +
-        3 * u * tt * controlPoints[2].first + ttt * controlPoints[3].first;
-    p.second =
-        uuu * controlPoints[0].second + 3 * uu * t * controlPoints[1].second +
-        3 * u * tt * controlPoints[2].second + ttt * controlPoints[3].second;
-
-    return p;
+    return lut.lookup(temp);
 }
 
 void Fan::addData(FanSpeedData const& data) { this->data = data; }
@@ -0,0 +1,272 @@
+#include "system/controllers/simulatedRiingQuad.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cwchar>
+#include <string>
+#include <thread>
+
+constexpr std::size_t const SIM_PERCENT = 100;
+constexpr uint8_t const SIM_BYTE_MASK = 0xFF;
+
+namespace sys {
+
+SimulatedRiingQuad::SimulatedRiingQuad(SimulationProfile const& profile)
+    : profile(profile),
+      last_spin(Clock::now()),
+      rng(profile.seed) {}
+
+auto SimulatedRiingQuad::write(unsigned char const* data, std::size_t length)
+    -> int {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (chance(profile.io_error_rate)) {
+            return -1;
+        }
+    }
+
+    // The transfer itself, the device is not involved yet
+    std::this_thread::sleep_for(profile.write_latency);
+
+    std::lock_guard<std::mutex> guard(lock);
+    auto now = Clock::now();
+    spin(now);
+    Response response = execute({data, length});
+
+    std::uniform_int_distribution<int64_t> jitter(
+        -profile.latency_jitter.count(), profile.latency_jitter.count());
+    auto work = std::max(profile.response_latency +
+                             std::chrono::microseconds(jitter(rng)),
+                         std::chrono::microseconds(0));
+    busy_until = std::max(now, busy_until) + work;
+
+    if (!chance(profile.drop_rate)) {
+        if (reports.size() == SIM_REPORT_QUEUE) {
+            reports.pop_front();
+        }
+        reports.push_back({busy_until, response});
+        arrived.notify_all();
+    }
+    return static_cast<int>(length);
+}
+
+auto SimulatedRiingQuad::read(unsigned char* data, std::size_t length,
+                              int timeout_ms) -> int {
+    std::unique_lock<std::mutex> guard(lock);
+    auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    for (;;) {
+        auto now = Clock::now();
+        if (!reports.empty() && reports.front().ready <= now) {
+            break;
+        }
+        if (reports.empty() && timeout_ms < 0) {
+            arrived.wait(guard);
+            continue;
+        }
+        if (timeout_ms >= 0 && now >= deadline) {
+            return 0;
+        }
+
+        auto wake = reports.empty() ? deadline : reports.front().ready;
+        if (timeout_ms >= 0) {
+            wake = std::min(wake, deadline);
+        }
+        arrived.wait_until(guard, wake);
+    }
+
+    auto const& report = reports.front().data;
+    std::memset(data, 0, length);
+    std::copy_n(report.begin(), std::min(length, report.size()), data);
+    reports.pop_front();
+    return static_cast<int>(length);
+}
+
+auto SimulatedRiingQuad::execute(std::span<unsigned char const> packet)
+    -> Response {
+    executed++;
+    Response response{};
+    if (packet.size() < 4) {
+        response[PROTOCOL_STATUS_BYTE] = PROTOCOL_FAIL;
+        return response;
+    }
+
+    // Byte 0 is the report id, hidapi strips it from input reports
+    unsigned char type = packet[1];
+    unsigned char target = packet[2];
+    response[PROTOCOL_TYPE_BYTE] = type;
+    response[PROTOCOL_TARGET_BYTE] = target;
+    response[PROTOCOL_STATUS_BYTE] = PROTOCOL_FAIL;
+
+    if (type == PROTOCOL_INIT) {
+        init_done = true;
+        response[PROTOCOL_STATUS_BYTE] = PROTOCOL_SUCCESS;
+        return response;
+    }
+
+    std::size_t port = packet[3];
+    response[PROTOCOL_PORT_BYTE] = static_cast<unsigned char>(port);
+    if (!init_done || port == 0 || port > fans.size() ||
+        chance(profile.protocol_fail_rate)) {
+        return response;
+    }
+    auto& fan = fans[port - 1];
+
+    if (type == PROTOCOL_SET && target == PROTOCOL_FAN && packet.size() > 5) {
+        fan.speed = static_cast<uint8_t>(
+            std::min<std::size_t>(packet[5], SIM_PERCENT));
+    } else if (type == PROTOCOL_SET && target == PROTOCOL_LIGHT &&
+               packet.size() > 7) {
+        // A short report only sets the first LEDs
+        std::size_t bytes = std::min(packet.size() - 5, 3 * fan.leds.size());
+        std::memcpy(fan.leds.data(), packet.data() + 5, bytes);
+    } else if (type == PROTOCOL_GET && target == PROTOCOL_FAN) {
+        auto rpm = static_cast<std::size_t>(std::lround(fan.rpm));
+        response[PROTOCOL_SPEED] = fan.speed;
+        response[PROTOCOL_RPM_L] = rpm & SIM_BYTE_MASK;
+        response[PROTOCOL_RPM_H] = (rpm >> SHIFT) & SIM_BYTE_MASK;
+    } else {
+        return response;
+    }
+
+    response[PROTOCOL_STATUS_BYTE] = PROTOCOL_SUCCESS;
+    return response;
+}
+
+void SimulatedRiingQuad::spin(Clock::time_point now) {
+    double dt = std::chrono::duration<double>(now - last_spin).count();
+    double tau =
+        std::chrono::duration<double>(profile.spin_time_constant).count();
+    double alpha = tau > 0 ? 1.0 - std::exp(-dt / tau) : 1.0;
+    last_spin = now;
+
+    for (auto& fan : fans) {
+        double target = static_cast<double>(profile.max_rpm * fan.speed) /
+                        static_cast<double>(SIM_PERCENT);
+        fan.rpm += (target - fan.rpm) * alpha;
+    }
+}
+
+auto SimulatedRiingQuad::chance(double rate) -> bool {
+    if (rate <= 0.0) {
+        return false;
+    }
+    return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < rate;
+}
+
+auto SimulatedRiingQuad::rpm(std::size_t fan_idx) -> std::size_t {
+    std::lock_guard<std::mutex> guard(lock);
+    spin(Clock::now());
+    return static_cast<std::size_t>(std::lround(fans.at(fan_idx).rpm));
+}
+
+auto SimulatedRiingQuad::speed(std::size_t fan_idx) -> uint8_t {
+    std::lock_guard<std::mutex> guard(lock);
+    return fans.at(fan_idx).speed;
+}
+
+auto SimulatedRiingQuad::color(std::size_t fan_idx) -> std::array<uint8_t, 3> {
+    std::lock_guard<std::mutex> guard(lock);
+    return fans.at(fan_idx).leds[0];
+}
+
+auto SimulatedRiingQuad::leds(std::size_t fan_idx)
+    -> std::array<LedColor, TT_RIING_QUAD_NUM_LEDS> {
+    std::lock_guard<std::mutex> guard(lock);
+    return fans.at(fan_idx).leds;
+}
+
+auto SimulatedRiingQuad::initialized() -> bool {
+    std::lock_guard<std::mutex> guard(lock);
+    return init_done;
+}
+
+auto SimulatedRiingQuad::commands() -> std::size_t {
+    std::lock_guard<std::mutex> guard(lock);
+    return executed;
+}
+
+SimulatedHidApi::SimulatedHidApi(std::size_t controllers_num,
+                                 SimulationProfile const& profile)
+    : HidApi(NoInit{}) {
+    for (std::size_t i = 0; i < controllers_num; i++) {
+        SimulationProfile p = profile;
+        p.seed += static_cast<uint32_t>(i);
+        devices.push_back(std::make_shared<SimulatedRiingQuad>(p));
+    }
+}
+
+auto SimulatedHidApi::simulated(hid_device* dev) -> SimulatedRiingQuad* {
+    // Only ever handed out by openDevice/openDevicePath below
+    return reinterpret_cast<SimulatedRiingQuad*>(dev);  // NOLINT
+}
+
+auto SimulatedHidApi::openDevice(uint16_t vendor_id, uint16_t product_id,
+                                 wchar_t const* /*serial_number*/)
+    -> hid_device* {
+    if (vendor_id != THERMALTAKE_VENDOR_ID) {
+        return nullptr;
+    }
+    for (std::size_t i = 0; i < devices.size(); i++) {
+        if (TT_RIING_QUAD_PRODUCT_IDS[i % TT_RIING_QUAD_PRODUCT_IDS_NUM] ==
+            product_id) {
+            return reinterpret_cast<hid_device*>(devices[i].get());  // NOLINT
+        }
+    }
+    return nullptr;
+}
+
+auto SimulatedHidApi::openDevicePath(char const* path) -> hid_device* {
+    std::string_view p(path);
+    if (!p.starts_with("sim:")) {
+        return nullptr;
+    }
+    std::size_t idx = std::stoul(std::string(p.substr(4)));
+    if (idx >= devices.size()) {
+        return nullptr;
+    }
+    return reinterpret_cast<hid_device*>(devices[idx].get());  // NOLINT
+}
+
+void SimulatedHidApi::closeDevice(hid_device* /*dev*/) {}
+
+auto SimulatedHidApi::writeReport(hid_device* dev, unsigned char const* data,
+                                  std::size_t length) -> int {
+    return simulated(dev)->write(data, length);
+}
+
+auto SimulatedHidApi::readReport(hid_device* dev, unsigned char* data,
+                                 std::size_t length, int timeout_ms) -> int {
+    return simulated(dev)->read(data, length, timeout_ms);
+}
+
+auto SimulatedHidApi::enumerateDevices(uint16_t vendor_id)
+    -> std::vector<HidDeviceInfo> {
+    std::vector<HidDeviceInfo> result;
+    if (vendor_id != THERMALTAKE_VENDOR_ID) {
+        return result;
+    }
+    for (std::size_t i = 0; i < devices.size(); i++) {
+        result.push_back(
+            {"sim:" + std::to_string(i),
+             TT_RIING_QUAD_PRODUCT_IDS[i % TT_RIING_QUAD_PRODUCT_IDS_NUM]});
+    }
+    return result;
+}
+
+auto SimulatedHidApi::deviceString(hid_device* /*dev*/, HidString kind,
+                                   wchar_t* out, std::size_t length) -> int {
+    wchar_t const* value = kind == HidString::MANUFACTURER
+                               ? L"Thermaltake"
+                               : L"Riing Quad (simulated)";
+    std::wcsncpy(out, value, length - 1);
+    out[length - 1] = L'\0';
+    return 0;
+}
+
+auto SimulatedHidApi::deviceError(hid_device* /*dev*/) -> wchar_t const* {
+    return L"simulated I/O error";
+}
+
+}  // namespace sys
@@ -1,105 +1,316 @@
 #include "system/controllers/ttRiingQuadController.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstdint>
+#include <span>
 #include <stdexcept>
+#include <thread>
 #include <vector>
 
 #include "core/logger.hpp"
 
 namespace sys {
 
-std::pair<std::size_t, std::size_t> TTRiingQuadController::sentToFan(
-    std::size_t controller_idx, std::size_t fan_idx, uint value) {
-    hidapi_wrapper->sendRequest<TT_RIING_QUAD_PACKET_SIZE>(
-        devices[controller_idx], PROTOCOL_START_BYTE, PROTOCOL_SET,
-        PROTOCOL_FAN, fan_idx, PROTOCOL_FAN_MODE_FIXED, value);
+void TTRiingQuadController::queueFanSpeed(std::size_t controller_idx,
+                                          std::size_t fan_idx, uint value) {
+    submit(controller_idx,
+           HidCommand{HidCommandType::SPEED, fan_idx, value, {},
+                      std::chrono::steady_clock::now() + speed_deadline});
+}
 
-    auto ret =
-        hidapi_wrapper
-            ->readResponse<TT_RIING_QUAD_PACKET_SIZE, TT_RIING_QUAD_TIMEOUT>(
-                devices[controller_idx]);
+void TTRiingQuadController::queueFanStatus(std::size_t controller_idx,
+                                           std::size_t fan_idx) {
+    submit(controller_idx,
+           HidCommand{HidCommandType::STATUS, fan_idx, 0, {},
+                      std::chrono::steady_clock::now() + speed_deadline});
+}
+
+auto TTRiingQuadController::queueRGB(std::size_t controller_idx,
+                                     std::size_t fan_idx,
+                                     std::span<LedColor const> colors)
+    -> bool {
+    HidCommand cmd{HidCommandType::RGB, fan_idx, 0, {},
+                   std::chrono::steady_clock::now() + color_deadline};
+    std::size_t leds = std::min(colors.size(), TT_RIING_QUAD_NUM_LEDS);
+    std::copy_n(colors.begin(), leds, cmd.colors.begin());
+    return submit(controller_idx, cmd);
+}
 
-    if (ret[PROTOCOL_STATUS_BYTE] == PROTOCOL_FAIL) {
-        core::Logger::log(core::LogLevel::WARNING)
-            << "Set fan speed failed: Controller " << controller_idx << " Fan "
-            << fan_idx << std::endl;
+auto TTRiingQuadController::colorDrops(std::size_t controller_idx,
+                                       std::size_t fan_idx) -> uint64_t {
+    auto const& drops = workers[controller_idx]->fan_color_drops;
+    return fan_idx - 1 < drops.size() ? drops[fan_idx - 1].load() : 0;
+}
+
+auto TTRiingQuadController::submit(std::size_t controller_idx,
+                                   HidCommand const& cmd) -> bool {
+    auto& worker = *workers[controller_idx];
+
+    // Counted before the push, the worker may pop the command and subtract
+    // it before tryPush even returns
+    worker.depth++;
+    while (!worker.submissions.tryPush(cmd)) {
+        // A stale color frame is not worth waiting for, a speed write is
+        if (cmd.type == HidCommandType::RGB) {
+            worker.depth--;
+            worker.dropped_colors++;
+            return false;
+        }
+        flush(controller_idx);
+        std::this_thread::yield();
     }
+    return true;
+}
 
-    hidapi_wrapper->sendRequest<TT_RIING_QUAD_PACKET_SIZE>(
-        devices[controller_idx], PROTOCOL_START_BYTE, PROTOCOL_GET,
-        PROTOCOL_FAN, fan_idx);
+void TTRiingQuadController::flush(std::size_t controller_idx) {
+    auto& worker = *workers[controller_idx];
+    worker.wakeups.fetch_add(1, std::memory_order_release);
+    worker.wakeups.notify_one();
+}
 
-    auto ret_get =
-        hidapi_wrapper
-            ->readResponse<TT_RIING_QUAD_PACKET_SIZE, TT_RIING_QUAD_TIMEOUT>(
-                devices[controller_idx]);
+auto TTRiingQuadController::queueDepth(std::size_t controller_idx)
+    -> std::size_t {
+    return workers[controller_idx]->depth.load();
+}
 
-    if (ret_get[PROTOCOL_STATUS_BYTE] == PROTOCOL_FAIL) {
-        core::Logger::log(core::LogLevel::WARNING)
-            << "Get fan speed data failed: Controller " << controller_idx
-            << " Fan " << fan_idx << std::endl;
+void TTRiingQuadController::setStatusHandler(StatusHandler handler) {
+    std::lock_guard<std::mutex> lock(handler_lock);
+    status_handler = std::move(handler);
+}
+
+void TTRiingQuadController::setDeadlines(std::chrono::milliseconds speed,
+                                         std::chrono::milliseconds color) {
+    speed_deadline = speed;
+    color_deadline = color;
+}
+
+void TTRiingQuadController::startWorkers() {
+    for (auto& worker : workers) {
+        worker->thread = std::jthread(
+            [this, &w = *worker](std::stop_token const& stop) {
+                workerLoop(stop, w);
+            });
     }
+}
 
-    std::size_t speed = ret_get[PROTOCOL_SPEED];
-    std::size_t rpm =
-        (ret_get[PROTOCOL_RPM_H] << SHIFT) + ret_get[PROTOCOL_RPM_L];
-    core::Logger::log(core::LogLevel::INFO)
-        << "Controller: " << controller_idx << " Fan: " << fan_idx << std::endl;
-    core::Logger::log(core::LogLevel::INFO)
-        << " Speed: " << ret_get[PROTOCOL_SPEED] << std::endl;
-    core::Logger::log(core::LogLevel::INFO)
-        << " RPM: "
-        << (ret_get[PROTOCOL_RPM_H] << SHIFT) + ret_get[PROTOCOL_RPM_L]
-        << std::endl;
+void TTRiingQuadController::stopWorkers() {
+    for (auto& worker : workers) {
+        worker->thread.request_stop();
+        worker->wakeups.fetch_add(1, std::memory_order_release);
+        worker->wakeups.notify_one();
+    }
+    for (auto& worker : workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+void TTRiingQuadController::workerLoop(std::stop_token const& stop,
+                                       DeviceWorker& worker) {
+    uint32_t seen = 0;
+    while (!stop.stop_requested()) {
+        worker.wakeups.wait(seen, std::memory_order_acquire);
+        seen = worker.wakeups.load(std::memory_order_acquire);
+        if (stop.stop_requested()) {
+            break;
+        }
 
-    return {speed, rpm};
+        try {
+            processBatch(worker);
+        } catch (std::exception const& e) {
+            LOG_ERROR(core::LogModule::HID)
+                << "Controller " << worker.idx << " I/O failed: " << e.what()
+                << std::endl;
+        }
+    }
 }
 
-void TTRiingQuadController::setRGB(std::size_t controller_idx,
-                                   std::size_t fan_idx,
-                                   std::array<uint8_t, 3>& colors) {
-    constexpr unsigned int NUM_COLORS = 54;
+void TTRiingQuadController::processBatch(DeviceWorker& worker) {
+    auto& dev = devices[worker.idx];
+
+    HidCommand cmd{};
+    std::size_t drained = 0;
+    while (worker.submissions.tryPop(cmd)) {
+        switch (cmd.type) {
+            case HidCommandType::SPEED:
+                worker.pending.pushSpeed(cmd.fan_idx, cmd.speed, cmd.deadline);
+                break;
+            case HidCommandType::STATUS:
+                worker.pending.pushStatus(cmd.fan_idx, cmd.deadline);
+                break;
+            case HidCommandType::RGB:
+                worker.pending.pushColor(cmd.fan_idx, cmd.colors,
+                                         cmd.deadline);
+                break;
+        }
+        drained++;
+    }
+
+    std::size_t dropped = worker.pending.droppedColors();
+    std::size_t late = worker.pending.lateSpeeds();
+    worker.pending.takeBatch(std::chrono::steady_clock::now(), worker.batch);
+    worker.depth.fetch_sub(drained);
+    worker.dropped_colors += worker.pending.droppedColors() - dropped;
+    worker.late_speeds += worker.pending.lateSpeeds() - late;
+    for (std::size_t fan : worker.pending.droppedFans()) {
+        if (fan - 1 < worker.fan_color_drops.size()) {
+            worker.fan_color_drops[fan - 1]++;
+        }
+    }
 
-    std::array<unsigned char, 3 * NUM_COLORS> color_data{};
-    std::span<unsigned char> colors_span(color_data);
+    // Send a window of commands back to back and only then collect their
+    // responses, so one round-trip is paid per window instead of per packet.
+    // Responses are matched by position, whatever is left over from a
+    // window that went wrong is thrown away before the next one.
+    worker.statuses.clear();
+    std::span<HidCommand const> pending(worker.batch);
+    try {
+        while (!pending.empty()) {
+            std::size_t window =
+                std::min(pending.size(), TT_RIING_QUAD_MAX_IN_FLIGHT);
+            for (std::size_t i = 0; i < window; i++) {
+                writeCommand(dev, pending[i]);
+                worker.sent_at[i] = std::chrono::steady_clock::now();
+            }
 
-    for (unsigned int color = 0; color < NUM_COLORS; color++) {
-        unsigned int color_idx = color * 3;
-        colors_span[color_idx + 0] = colors[0];
-        colors_span[color_idx + 1] = colors[1];
-        colors_span[color_idx + 2] = colors[2];
+            // The round trip of a command also covers reading the responses
+            // of the ones written before it in the same window
+            bool in_step = true;
+            for (std::size_t i = 0; i < window; i++) {
+                Answer answer = readCommandResponse(worker.idx, pending[i],
+                                                    worker.statuses);
+                if (answer == Answer::FAILED) {
+                    hidapi_wrapper->recordProtocolFailure(dev);
+                }
+                in_step = in_step && answer != Answer::UNMATCHED;
+                worker.round_trip.record(std::chrono::steady_clock::now() -
+                                         worker.sent_at[i]);
+            }
+            if (!in_step) {
+                discardResponses(worker.idx);
+            }
+            pending = pending.subspan(window);
+        }
+    } catch (std::exception const&) {
+        discardResponses(worker.idx);
+        throw;
     }
+
+    if (worker.statuses.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(handler_lock);
+    if (status_handler) {
+        for (auto const& status : worker.statuses) {
+            status_handler(worker.idx, status);
+        }
+    }
+}
+
+void TTRiingQuadController::writeCommand(device& dev, HidCommand const& cmd) {
+    if (cmd.type == HidCommandType::SPEED) {
+        hidapi_wrapper->sendRequest<TT_RIING_QUAD_PACKET_SIZE>(
+            dev, PROTOCOL_START_BYTE, PROTOCOL_SET, PROTOCOL_FAN, cmd.fan_idx,
+            PROTOCOL_FAN_MODE_FIXED, cmd.speed);
+        return;
+    }
+
+    if (cmd.type == HidCommandType::STATUS) {
+        hidapi_wrapper->sendRequest<TT_RIING_QUAD_PACKET_SIZE>(
+            dev, PROTOCOL_START_BYTE, PROTOCOL_GET, PROTOCOL_FAN, cmd.fan_idx);
+        return;
+    }
+
+    // The frame goes out as it is, one GRB triple per LED copied straight
+    // into the packet
     hidapi_wrapper->sendRequest<TT_RIING_QUAD_PACKET_SIZE>(
-        devices[controller_idx], PROTOCOL_START_BYTE, PROTOCOL_SET,
-        PROTOCOL_LIGHT, fan_idx, PROTOCOL_PER_LED, color_data);
+        dev, PROTOCOL_START_BYTE, PROTOCOL_SET, PROTOCOL_LIGHT, cmd.fan_idx,
+        PROTOCOL_PER_LED,
+        std::span<LedColor const>(cmd.colors).first(TT_RIING_QUAD_NUM_LEDS));
+}
+
+auto TTRiingQuadController::readCommandResponse(
+    std::size_t controller_idx, HidCommand const& cmd,
+    std::vector<FanStatus>& statuses) -> Answer {
+    auto& dev = devices[controller_idx];
     auto ret =
         hidapi_wrapper
             ->readResponse<TT_RIING_QUAD_PACKET_SIZE, TT_RIING_QUAD_TIMEOUT>(
-                devices[controller_idx]);
+                dev);
 
-    if (ret[PROTOCOL_STATUS_BYTE] == PROTOCOL_FAIL) {
-        core::Logger::log(core::LogLevel::WARNING)
-            << "Set fan color failed: Controller " << controller_idx << " Fan "
-            << fan_idx << std::endl;
+    unsigned char type =
+        cmd.type == HidCommandType::STATUS ? PROTOCOL_GET : PROTOCOL_SET;
+    unsigned char target =
+        cmd.type == HidCommandType::RGB ? PROTOCOL_LIGHT : PROTOCOL_FAN;
+    if (ret[PROTOCOL_TYPE_BYTE] != type ||
+        ret[PROTOCOL_TARGET_BYTE] != target ||
+        ret[PROTOCOL_PORT_BYTE] != cmd.fan_idx) {
+        // A timeout leaves the response all zero, it is counted there
+        if (ret[PROTOCOL_TYPE_BYTE] != 0) {
+            hidapi_wrapper->recordProtocolFailure(dev);
+        }
+        LOG_WARNING(core::LogModule::HID)
+            << "No answer or another command's: Controller " << controller_idx
+            << " Fan " << cmd.fan_idx << std::endl;
+        return Answer::UNMATCHED;
     }
-}
 
-std::vector<std::vector<std::array<uint8_t, 3>>>
-TTRiingQuadController::makeColorBuffer() {
-    std::vector<std::vector<std::array<uint8_t, 3>>> color_buffer;
-    size_t cnum = controllersNum();
+    if (cmd.type == HidCommandType::RGB) {
+        if (ret[PROTOCOL_STATUS_BYTE] != PROTOCOL_SUCCESS) {
+            LOG_WARNING(core::LogModule::HID)
+                << "Set fan color failed: Controller " << controller_idx
+                << " Fan " << cmd.fan_idx << std::endl;
+            return Answer::FAILED;
+        }
+        return Answer::SUCCESS;
+    }
 
-    for (size_t i = 0; i < cnum; i++) {
-        std::vector<std::array<uint8_t, 3>> fan;
-        for (size_t j = 0; j < TT_RIING_QUAD_NUM_CHANNELS; j++) {
-            fan.push_back(std::array<uint8_t, 3>{0x00, 0x00, 0xFF});
+    if (cmd.type == HidCommandType::SPEED) {
+        if (ret[PROTOCOL_STATUS_BYTE] != PROTOCOL_SUCCESS) {
+            LOG_WARNING(core::LogModule::HID)
+                << "Set fan speed failed: Controller " << controller_idx
+                << " Fan " << cmd.fan_idx << std::endl;
+            return Answer::FAILED;
         }
-        color_buffer.push_back(fan);
+        return Answer::SUCCESS;
+    }
+
+    if (ret[PROTOCOL_STATUS_BYTE] != PROTOCOL_SUCCESS) {
+        LOG_WARNING(core::LogModule::HID)
+            << "Get fan speed data failed: Controller " << controller_idx
+            << " Fan " << cmd.fan_idx << std::endl;
+        return Answer::FAILED;
     }
 
-    return color_buffer;
+    std::size_t speed = ret[PROTOCOL_SPEED];
+    std::size_t rpm = (ret[PROTOCOL_RPM_H] << SHIFT) + ret[PROTOCOL_RPM_L];
+    LOG_INFO(core::LogModule::HID)
+        << "Controller: " << controller_idx << " Fan: " << cmd.fan_idx
+        << " Speed: " << speed << " RPM: " << rpm << std::endl;
+
+    statuses.push_back(FanStatus{cmd.fan_idx, speed, rpm});
+    return Answer::SUCCESS;
+}
+
+void TTRiingQuadController::discardResponses(std::size_t controller_idx) {
+    std::size_t discarded =
+        hidapi_wrapper->discardResponses<TT_RIING_QUAD_PACKET_SIZE,
+                                         TT_RIING_QUAD_DRAIN_TIMEOUT>(
+            devices[controller_idx], TT_RIING_QUAD_REPORT_QUEUE);
+    if (discarded != 0) {
+        LOG_WARNING(core::LogModule::HID)
+            << "Controller " << controller_idx << ": dropped " << discarded
+            << " answers to earlier commands" << std::endl;
+    }
+}
+
+auto TTRiingQuadController::makeColorBuffer() -> ColorBuffer {
+    return {controllersNum(), TT_RIING_QUAD_NUM_CHANNELS,
+            TT_RIING_QUAD_NUM_LEDS, LedColor{0x00, 0x00, 0xFF}};
 }
 
 void TTRiingQuadController::initControllers() {
@@ -114,6 +325,10 @@ void TTRiingQuadController::initControllers() {
     for (auto& dev : devices) {
         sendInit(dev);
     }
+
+    for (std::size_t i = 0; i < devices.size(); i++) {
+        workers.push_back(std::make_unique<DeviceWorker>(i));
+    }
 }
 
 void TTRiingQuadController::showControllersInfo() {
@@ -129,11 +344,11 @@ void TTRiingQuadController::sendInit(device& dev) {
                                             TT_RIING_QUAD_TIMEOUT>(dev);
 
     if (ret[PROTOCOL_STATUS_BYTE] != PROTOCOL_SUCCESS) {
-        core::Logger::log(core::LogLevel::ERROR) << "Init failed" << std::endl;
+        LOG_ERROR(core::LogModule::HID) << "Init failed" << std::endl;
         std::runtime_error("Init request failed");
     }
 
-    core::Logger::log(core::LogLevel::INFO) << "Init success" << std::endl;
+    LOG_INFO(core::LogModule::HID) << "Init success" << std::endl;
 }
 
 unsigned int TTRiingQuadController::convertChannel(float val) {
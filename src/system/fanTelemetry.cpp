@@ -0,0 +1,46 @@
+#include "system/fanTelemetry.hpp"
+
+#include <cstdint>
+
+constexpr uint64_t const SPEED_MASK = 0xFFFF;
+constexpr uint64_t const RPM_MASK = 0xFFFFFFFF;
+constexpr unsigned int const RPM_SHIFT = 16;
+constexpr uint64_t const VALID_BIT = 1ULL << 63U;
+
+namespace sys {
+
+FanTelemetry::FanTelemetry(std::size_t controllers_num,
+                           std::size_t channels_num)
+    : controllers_num(controllers_num),
+      channels_num(channels_num),
+      slots(std::make_unique<std::atomic<uint64_t>[]>(controllers_num *
+                                                       channels_num)) {}
+
+void FanTelemetry::store(std::size_t controller_idx, std::size_t fan_idx,
+                         std::size_t speed, std::size_t rpm) {
+    if (controller_idx >= controllers_num || fan_idx >= channels_num) {
+        return;
+    }
+
+    uint64_t packed = VALID_BIT | (speed & SPEED_MASK) |
+                      ((rpm & RPM_MASK) << RPM_SHIFT);
+    uint64_t previous = slots[controller_idx * channels_num + fan_idx].exchange(
+        packed, std::memory_order_acq_rel);
+    if (previous != packed) {
+        generation_counter.fetch_add(1, std::memory_order_release);
+    }
+}
+
+auto FanTelemetry::load(std::size_t controller_idx, std::size_t fan_idx) const
+    -> FanSample {
+    if (controller_idx >= controllers_num || fan_idx >= channels_num) {
+        return {0, 0, false};
+    }
+
+    uint64_t packed = slots[controller_idx * channels_num + fan_idx].load(
+        std::memory_order_acquire);
+    return {packed & SPEED_MASK, (packed >> RPM_SHIFT) & RPM_MASK,
+            (packed & VALID_BIT) != 0};
+}
+
+}  // namespace sys
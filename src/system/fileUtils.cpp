@@ -1,15 +1,16 @@
 #include "system/fileUtils.hpp"
 
 #include <dirent.h>
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <array>
 #include <cerrno>
 #include <climits>
 #include <cstring>
 #include <filesystem>
-#include <fstream>
 #include <iostream>
 #include <vector>
 
@@ -17,14 +18,27 @@
 #define PROCDIR "/proc"
 #endif
 
+constexpr std::size_t const READ_LINE_BUFFER_SIZE = 256;
+
 auto readLine(std::string const& filename) -> std::string {
-    std::string line;
-    std::ifstream file(filename);
-    if (file.fail()) {
-        return line;
+    std::array<char, READ_LINE_BUFFER_SIZE> buffer{};
+    int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return {};
     }
-    std::getline(file, line);
-    return line;
+
+    ssize_t n = 0;
+    do {
+        n = read(fd, buffer.data(), buffer.size());
+    } while (n < 0 && errno == EINTR);
+    close(fd);
+
+    if (n <= 0) {
+        return {};
+    }
+
+    std::string_view content(buffer.data(), static_cast<std::size_t>(n));
+    return std::string(content.substr(0, content.find('\n')));
 }
 
 auto getBasename(std::string const&& path) -> std::string {
@@ -4,6 +4,7 @@
 #include <stdexcept>
 
 #include "core/logger.hpp"
+#include "system/fileUtils.hpp"
 
 namespace sys {
 
@@ -21,16 +22,13 @@ void AMD::findGPUTempFile(std::string const& card) {
         if (entry.is_directory()) {
             auto name_file = entry.path() / "name";
             if (fs::exists(name_file)) {
-                std::ifstream fin(name_file);
-                std::string name;
-                std::getline(fin, name);
+                std::string name = readLine(name_file);
                 if (name == "amdgpu") {
-                    core::Logger::log(core::LogLevel::INFO)
+                    LOG_INFO(core::LogModule::MONITORING)
                         << "Found AMD GPU hwmon: "
                         << entry.path().filename().string() << std::endl;
-                    gpu_temp_file.open(entry.path() / "temp1_input");
 
-                    if (!gpu_temp_file.is_open()) {
+                    if (!gpu_temp_file.open(entry.path() / "temp1_input")) {
                         throw std::runtime_error("Сannot open gpu temp file");
                     }
                 }
@@ -58,13 +56,13 @@ bool AMD::calculateGPUName() {
         std::string line(buffer.data());
         // Просто выведем всё, что нашли
         found = true;
-        core::Logger::log(core::LogLevel::INFO) << "AMD GPU info: " << line;
+        LOG_INFO(core::LogModule::MONITORING) << "AMD GPU info: " << line;
         gpu_name = line;
     }
     pclose(pipe);
 
     if (!found) {
-        core::Logger::log(core::LogLevel::WARNING)
+        LOG_WARNING(core::LogModule::MONITORING)
             << "No AMD GPU device found (or no lspci output).\n";
     }
 
@@ -79,25 +77,16 @@ AMD::AMD(std::string const& card) {
     }
 }
 
-AMD::~AMD() {
-    if (gpu_temp_file.is_open()) {
-        gpu_temp_file.close();
-    }
-}
+AMD::~AMD() = default;
 
 auto AMD::getGPUName() -> std::string { return gpu_name; }
 
 auto AMD::getGPUTemp() -> unsigned int { return gpu_temp; }
 
 auto AMD::readGPUTemp(unsigned int& temp) -> bool {
-    gpu_temp_file.clear();
-    gpu_temp_file.seekg(0, std::ios::beg);
-
-    unsigned int gtemp = 0;
-    gpu_temp_file >> gtemp;
-
-    if (gpu_temp_file.fail()) {
-        core::Logger::log(core::LogLevel::INFO)
+    long gtemp = 0;
+    if (!gpu_temp_file.readInt(gtemp)) {
+        LOG_INFO(core::LogModule::MONITORING)
             << "Cannot read gpu temp" << std::endl;
     }
 
@@ -60,7 +60,7 @@ bool Nvidia::load() {
         return false;
     }
 
-    core::Logger::log(core::LogLevel::INFO)
+    LOG_INFO(core::LogModule::MONITORING)
         << "Opening NVML Success" << std::endl;
 
     return true;
@@ -0,0 +1,68 @@
+#include "system/hidCommandQueue.hpp"
+
+#include <algorithm>
+
+namespace sys {
+
+void HidCommandQueue::coalesce(std::vector<HidCommand>& pending,
+                               HidCommand const& cmd) {
+    auto it = std::find_if(
+        pending.begin(), pending.end(),
+        [&cmd](HidCommand const& c) { return c.fan_idx == cmd.fan_idx; });
+
+    if (it != pending.end()) {
+        *it = cmd;
+    } else {
+        pending.push_back(cmd);
+    }
+}
+
+void HidCommandQueue::pushSpeed(std::size_t fan_idx, unsigned int speed,
+                                Clock::time_point deadline) {
+    coalesce(speeds, HidCommand{HidCommandType::SPEED, fan_idx, speed, {},
+                                deadline});
+}
+
+void HidCommandQueue::pushStatus(std::size_t fan_idx,
+                                 Clock::time_point deadline) {
+    coalesce(statuses,
+             HidCommand{HidCommandType::STATUS, fan_idx, 0, {}, deadline});
+}
+
+void HidCommandQueue::pushColor(std::size_t fan_idx,
+                                FanLedColors const& leds,
+                                Clock::time_point deadline) {
+    coalesce(colors,
+             HidCommand{HidCommandType::RGB, fan_idx, 0, leds, deadline});
+}
+
+void HidCommandQueue::takeBatch(Clock::time_point now,
+                                std::vector<HidCommand>& batch) {
+    batch.clear();
+    dropped_fans.clear();
+
+    for (auto const& cmd : speeds) {
+        if (cmd.deadline < now) {
+            late_speeds++;
+        }
+        batch.push_back(cmd);
+    }
+
+    // A late status read is still the freshest data there is
+    batch.insert(batch.end(), statuses.begin(), statuses.end());
+
+    for (auto const& cmd : colors) {
+        if (cmd.deadline < now) {
+            dropped_colors++;
+            dropped_fans.push_back(cmd.fan_idx);
+            continue;
+        }
+        batch.push_back(cmd);
+    }
+
+    speeds.clear();
+    statuses.clear();
+    colors.clear();
+}
+
+}  // namespace sys
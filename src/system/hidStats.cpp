@@ -0,0 +1,28 @@
+#include "system/hidStats.hpp"
+
+#include <sstream>
+
+namespace {
+
+void describe(std::ostringstream& out, char const* name,
+              sys::LatencyHistogram const& histogram) {
+    out << name << " p50 " << histogram.percentile(0.5).count() << "us p99 "
+        << histogram.percentile(0.99).count() << "us n=" << histogram.count();
+}
+
+}  // namespace
+
+namespace sys {
+
+auto summarize(HidStats const& stats) -> std::string {
+    std::ostringstream out;
+    describe(out, "write", stats.write);
+    out << " | ";
+    describe(out, "read", stats.read);
+    out << " | timeouts " << stats.timeouts.load() << " | protocol failures "
+        << stats.protocol_failures.load() << " | I/O errors "
+        << stats.io_errors.load();
+    return out.str();
+}
+
+}  // namespace sys
@@ -0,0 +1,81 @@
+#include "system/latencyHistogram.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace sys {
+
+auto LatencyHistogram::bucketIndex(uint64_t micros) -> std::size_t {
+    if (micros < HISTOGRAM_SUB_BUCKETS) {
+        return micros;
+    }
+
+    // Values in [2^m, 2^(m+1)) share a magnitude, the bits right below the
+    // top one pick the sub-bucket
+    std::size_t magnitude = std::bit_width(micros) - 1;
+    std::size_t sub = (micros >> (magnitude - HISTOGRAM_SUB_BUCKET_BITS)) &
+                      (HISTOGRAM_SUB_BUCKETS - 1);
+    std::size_t idx =
+        ((magnitude - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKETS) +
+        sub;
+    return std::min(idx, HISTOGRAM_BUCKETS - 1);
+}
+
+auto LatencyHistogram::bucketLimit(std::size_t idx) -> uint64_t {
+    if (idx < HISTOGRAM_SUB_BUCKETS) {
+        return idx + 1;
+    }
+
+    std::size_t shift = (idx / HISTOGRAM_SUB_BUCKETS) - 1;
+    uint64_t sub = idx % HISTOGRAM_SUB_BUCKETS;
+    return (HISTOGRAM_SUB_BUCKETS + sub + 1) << shift;
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds latency) {
+    auto ns = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+    uint64_t micros = (ns + 999) / 1000;  // NOLINT
+    buckets[bucketIndex(micros == 0 ? 0 : micros - 1)].fetch_add(
+        1, std::memory_order_relaxed);
+    sum_ns.fetch_add(ns, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto LatencyHistogram::countAtMost(std::chrono::microseconds bound) const
+    -> uint64_t {
+    uint64_t result = 0;
+    for (std::size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        if (bucketLimit(i) > static_cast<uint64_t>(bound.count())) {
+            break;
+        }
+        result += buckets[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+auto LatencyHistogram::percentile(double q) const
+    -> std::chrono::microseconds {
+    std::array<uint64_t, HISTOGRAM_BUCKETS> counts{};
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        counts[i] = buckets[i].load(std::memory_order_relaxed);
+        seen += counts[i];
+    }
+    if (seen == 0) {
+        return std::chrono::microseconds(0);
+    }
+
+    auto rank = static_cast<uint64_t>(
+        std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(seen)));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t cumulative = 0;
+    for (std::size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        cumulative += counts[i];
+        if (cumulative >= rank) {
+            return std::chrono::microseconds(bucketLimit(i));
+        }
+    }
+    return std::chrono::microseconds(bucketLimit(HISTOGRAM_BUCKETS - 1));
+}
+
+}  // namespace sys
@@ -0,0 +1,392 @@
+#include "system/metricsExporter.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "core/logger.hpp"
+
+// Keeps every value inside METRICS_VALUE_WIDTH at any precision we use
+constexpr double const METRICS_MAX_VALUE = 1e15;
+
+namespace {
+
+auto sysError(std::string const& what) -> std::runtime_error {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+auto seriesName(std::string const& name, std::string const& labels,
+                std::string const& extra = "") -> std::string {
+    if (labels.empty() && extra.empty()) {
+        return name;
+    }
+    std::string sep = labels.empty() || extra.empty() ? "" : ",";
+    return name + "{" + labels + sep + extra + "}";
+}
+
+auto fanLabels(std::size_t controller_idx, std::size_t fan_idx)
+    -> std::string {
+    return "controller=\"" + std::to_string(controller_idx) + "\",fan=\"" +
+           std::to_string(fan_idx) + "\"";
+}
+
+auto leLabel(std::chrono::microseconds bound) -> std::string {
+    std::array<char, 32> buf{};  // NOLINT
+    double seconds = std::chrono::duration<double>(bound).count();
+    auto [ptr, ec] = std::to_chars(buf.data(), buf.data() + buf.size(), seconds);
+    return "le=\"" + std::string(buf.data(), ptr) + "\"";
+}
+
+auto sendAll(int fd, std::string_view data) -> bool {
+    while (!data.empty()) {
+        ssize_t n = send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        data.remove_prefix(static_cast<std::size_t>(n));
+    }
+    return true;
+}
+
+}  // namespace
+
+namespace sys {
+
+MetricsExporter::MetricsExporter(uint16_t port, std::size_t controllers_num,
+                                 std::size_t channels_num)
+    : controllers_num(controllers_num),
+      channels_num(channels_num),
+      targets(std::make_unique<std::atomic<float>[]>(controllers_num *
+                                                     channels_num)),
+      speeds(std::make_unique<std::atomic<uint32_t>[]>(controllers_num *
+                                                       channels_num)),
+      rpms(std::make_unique<std::atomic<uint32_t>[]>(controllers_num *
+                                                     channels_num)) {
+    addGauge("tt_temperature_celsius", "Last sampled temperature",
+             "sensor=\"cpu\"", [this] { return cpu_temp.load(); }, 1);
+    addGauge("tt_temperature_celsius", "Last sampled temperature",
+             "sensor=\"gpu\"", [this] { return gpu_temp.load(); }, 1);
+    for (std::size_t c = 0; c < controllers_num; c++) {
+        for (std::size_t f = 0; f < channels_num; f++) {
+            std::size_t i = fanSlot(c, f);
+            addGauge("tt_fan_target_speed_percent",
+                     "Speed the fan curve asked for", fanLabels(c, f),
+                     [this, i] { return targets[i].load(); }, 1);
+        }
+    }
+    for (std::size_t c = 0; c < controllers_num; c++) {
+        for (std::size_t f = 0; f < channels_num; f++) {
+            std::size_t i = fanSlot(c, f);
+            addGauge("tt_fan_speed_percent", "Speed reported by the controller",
+                     fanLabels(c, f), [this, i] { return speeds[i].load(); });
+        }
+    }
+    for (std::size_t c = 0; c < controllers_num; c++) {
+        for (std::size_t f = 0; f < channels_num; f++) {
+            std::size_t i = fanSlot(c, f);
+            addGauge("tt_fan_rpm", "RPM reported by the controller",
+                     fanLabels(c, f), [this, i] { return rpms[i].load(); });
+        }
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    auto* sa = reinterpret_cast<sockaddr*>(&addr);  // NOLINT
+    socklen_t len = sizeof(addr);
+
+    listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        throw sysError("socket");
+    }
+    int reuse = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (bind(listen_fd, sa, len) != 0 || listen(listen_fd, SOMAXCONN) != 0 ||
+        getsockname(listen_fd, sa, &len) != 0) {
+        auto error = sysError("Metrics port " + std::to_string(port));
+        close(listen_fd);
+        throw error;
+    }
+    bound_port = ntohs(addr.sin_port);
+
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0) {
+        auto error = sysError("eventfd");
+        close(listen_fd);
+        throw error;
+    }
+}
+
+MetricsExporter::~MetricsExporter() {
+    thread.request_stop();
+    uint64_t one = 1;
+    (void)write(wake_fd, &one, sizeof(one));
+    if (thread.joinable()) {
+        thread.join();
+    }
+    close(wake_fd);
+    close(listen_fd);
+}
+
+auto MetricsExporter::family(std::string const& name, std::string const& type,
+                             std::string const& help) -> Family& {
+    auto it = std::find_if(families.begin(), families.end(),
+                           [&name](Family const& f) { return f.name == name; });
+    if (it != families.end()) {
+        return *it;
+    }
+    return families.emplace_back(Family{name, type, help, {}});
+}
+
+void MetricsExporter::addCounter(std::string const& name,
+                                 std::string const& help,
+                                 std::string const& labels,
+                                 MetricSource source) {
+    family(name, "counter", help)
+        .series.push_back({seriesName(name + "_total", labels),
+                           std::move(source), 0});
+}
+
+void MetricsExporter::addGauge(std::string const& name,
+                               std::string const& help,
+                               std::string const& labels, MetricSource source,
+                               int precision) {
+    family(name, "gauge", help)
+        .series.push_back(
+            {seriesName(name, labels), std::move(source), precision});
+}
+
+void MetricsExporter::addHistogram(
+    std::string const& name, std::string const& help,
+    std::string const& labels,
+    std::shared_ptr<LatencyHistogram const> histogram) {
+    auto& f = family(name, "histogram", help);
+    for (std::size_t pow = METRICS_FIRST_BUCKET_POW;
+         pow <= METRICS_LAST_BUCKET_POW; pow++) {
+        auto bound = std::chrono::microseconds(1ULL << pow);
+        f.series.push_back({seriesName(name + "_bucket", labels, leLabel(bound)),
+                            [histogram, bound] {
+                                return static_cast<double>(
+                                    histogram->countAtMost(bound));
+                            },
+                            0});
+    }
+
+    // +Inf and _count add up the buckets too, so they never disagree with
+    // the finite buckets above
+    auto all = [histogram] {
+        return static_cast<double>(
+            histogram->countAtMost(std::chrono::microseconds::max()));
+    };
+    f.series.push_back(
+        {seriesName(name + "_bucket", labels, "le=\"+Inf\""), all, 0});
+    f.series.push_back({seriesName(name + "_count", labels), all, 0});
+    f.series.push_back({seriesName(name + "_sum", labels),
+                        [histogram] {
+                            return std::chrono::duration<double>(
+                                       histogram->sum())
+                                .count();
+                        },
+                        6});
+}
+
+void MetricsExporter::start() {
+    {
+        std::lock_guard<std::mutex> lock(page_lock);
+        layout();
+    }
+    thread = std::jthread([this](std::stop_token const& stop) { serve(stop); });
+    LOG_INFO(core::LogModule::CORE)
+        << "Metrics served on 127.0.0.1:" << bound_port << std::endl;
+}
+
+auto MetricsExporter::render() -> std::string {
+    std::lock_guard<std::mutex> lock(page_lock);
+    if (slots.empty()) {
+        layout();
+    }
+    refresh();
+    return page;
+}
+
+auto MetricsExporter::fanSlot(std::size_t controller_idx,
+                              std::size_t fan_idx) const -> std::size_t {
+    return (controller_idx * channels_num) + fan_idx;
+}
+
+void MetricsExporter::publishTemperatures(float cpu, float gpu) {
+    cpu_temp.store(cpu, std::memory_order_relaxed);
+    gpu_temp.store(gpu, std::memory_order_relaxed);
+}
+
+void MetricsExporter::publishTarget(std::size_t controller_idx,
+                                    std::size_t fan_idx, float speed) {
+    if (controller_idx >= controllers_num || fan_idx >= channels_num) {
+        return;
+    }
+    targets[fanSlot(controller_idx, fan_idx)].store(speed,
+                                                    std::memory_order_relaxed);
+}
+
+void MetricsExporter::publishStatus(std::size_t controller_idx,
+                                    std::size_t fan_idx, std::size_t speed,
+                                    std::size_t rpm) {
+    if (controller_idx >= controllers_num || fan_idx >= channels_num) {
+        return;
+    }
+    std::size_t i = fanSlot(controller_idx, fan_idx);
+    speeds[i].store(static_cast<uint32_t>(speed), std::memory_order_relaxed);
+    rpms[i].store(static_cast<uint32_t>(rpm), std::memory_order_relaxed);
+}
+
+void MetricsExporter::layout() {
+    std::size_t size = 0;
+    std::size_t series = 0;
+    for (auto const& f : families) {
+        size += (2 * f.name.size()) + f.type.size() + f.help.size() + 16;
+        for (auto const& s : f.series) {
+            size += s.sample.size() + METRICS_VALUE_WIDTH + 2;
+        }
+        series += f.series.size();
+    }
+
+    page.clear();
+    page.reserve(size + 8);
+    slots.clear();
+    slots.reserve(series);
+    for (auto const& f : families) {
+        page += "# TYPE " + f.name + " " + f.type + "\n";
+        page += "# HELP " + f.name + " " + f.help + "\n";
+        for (auto const& s : f.series) {
+            page += s.sample + " ";
+            slots.push_back({page.size(), s.source, s.precision, NAN});
+            page.append(METRICS_VALUE_WIDTH, '0');
+            page += '\n';
+        }
+    }
+    page += "# EOF\n";
+
+    for (auto& slot : slots) {
+        slot.value = slot.source();
+        writeValue(slot);
+    }
+}
+
+void MetricsExporter::refresh() {
+    for (auto& slot : slots) {
+        double value = slot.source();
+        if (value != slot.value) {
+            slot.value = value;
+            writeValue(slot);
+        }
+    }
+}
+
+void MetricsExporter::writeValue(Slot const& slot) {
+    double value = std::isfinite(slot.value) ? slot.value : 0.0;
+    value = std::clamp(value, -METRICS_MAX_VALUE, METRICS_MAX_VALUE);
+
+    std::array<char, METRICS_VALUE_WIDTH + 8> buf{};
+    auto [end, ec] =
+        std::to_chars(buf.data(), buf.data() + buf.size(), std::abs(value),
+                      std::chars_format::fixed, slot.precision);
+    auto digits = static_cast<std::size_t>(end - buf.data());
+
+    // -0000042.5 parses like -42.5, the width stays the same
+    char* out = page.data() + slot.offset;
+    std::size_t pad = METRICS_VALUE_WIDTH - digits;
+    std::fill_n(out, pad, '0');
+    if (value < 0) {
+        out[0] = '-';
+    }
+    std::copy_n(buf.data(), digits, out + pad);
+}
+
+void MetricsExporter::serve(std::stop_token const& stop) {
+    std::array<pollfd, 2> fds{};
+    while (!stop.stop_requested()) {
+        fds[0] = {wake_fd, POLLIN, 0};
+        fds[1] = {listen_fd, POLLIN, 0};
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR(core::LogModule::CORE)
+                << "Metrics poll failed: " << std::strerror(errno)
+                << std::endl;
+            return;
+        }
+        if ((fds[1].revents & POLLIN) == 0) {
+            continue;
+        }
+
+        // Scrapes are rare and short, one at a time is plenty
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        answer(fd);
+        close(fd);
+    }
+}
+
+void MetricsExporter::answer(int fd) {
+    timeval tv{0, static_cast<suseconds_t>(
+                      std::chrono::microseconds(METRICS_IO_TIMEOUT).count())};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    std::string request;
+    std::array<char, 1024> chunk{};  // NOLINT
+    while (request.find("\r\n\r\n") == std::string::npos) {
+        ssize_t n = recv(fd, chunk.data(), chunk.size(), 0);
+        if (n <= 0 || request.size() > METRICS_MAX_REQUEST) {
+            return;
+        }
+        request.append(chunk.data(), n);
+    }
+
+    std::string_view line(request.data(), request.find("\r\n"));
+    std::string_view status = "200 OK";
+    if (!line.starts_with("GET ")) {
+        status = "405 Method Not Allowed";
+    } else {
+        std::string_view target = line.substr(4, line.find(' ', 4) - 4);
+        target = target.substr(0, target.find('?'));
+        if (target != "/metrics") {
+            status = "404 Not Found";
+        }
+    }
+
+    if (status != "200 OK") {
+        sendAll(fd, "HTTP/1.1 " + std::string(status) +
+                        "\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(page_lock);
+    refresh();
+    std::string header = "HTTP/1.1 200 OK\r\nContent-Type: ";
+    header += METRICS_CONTENT_TYPE;
+    header += "\r\nContent-Length: " + std::to_string(page.size()) +
+              "\r\nConnection: close\r\n\r\n";
+    if (sendAll(fd, header)) {
+        sendAll(fd, page);
+    }
+}
+
+}  // namespace sys
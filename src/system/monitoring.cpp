@@ -4,6 +4,7 @@
 #include <dirent.h>
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
 #include <memory>
@@ -24,26 +25,65 @@ void Monitoring::start() {
 }
 
 void Monitoring::monitoringLoop() {
-    using namespace std::chrono_literals;
     while (running.load()) {
         update();
-        std::this_thread::sleep_for(interval);
+        std::unique_lock<std::mutex> lock(wait_lock);
+        wake.wait_for(lock, current_interval.load(), [this] {
+            return !running.load() || refresh_requested;
+        });
+        refresh_requested = false;
     }
 }
 
+void Monitoring::refresh() {
+    {
+        std::lock_guard<std::mutex> const LOCK(observer_lock);
+        cpu_notified.reset();
+        gpu_notified.reset();
+    }
+    {
+        std::lock_guard<std::mutex> const LOCK(wait_lock);
+        refresh_requested = true;
+    }
+    wake.notify_all();
+}
+
 void Monitoring::stop() {
-    running.store(false);
+    {
+        std::lock_guard<std::mutex> const LOCK(wait_lock);
+        running.store(false);
+    }
+    wake.notify_all();
     if (monitoring_thread.joinable()) {
         monitoring_thread.join();
     }
 }
 
+void Monitoring::setSamplingPolicy(SamplingPolicy const& p) {
+    std::lock_guard<std::mutex> const LOCK(wait_lock);
+    policy = p;
+}
+
+void Monitoring::setSink(std::shared_ptr<TelemetrySink> s) {
+    std::lock_guard<std::mutex> const LOCK(wait_lock);
+    sink = std::move(s);
+}
+
 void Monitoring::addObserver(std::shared_ptr<core::Observer> const& observer) {
     std::lock_guard<std::mutex> const LOCK(observer_lock);
     observers.push_back(observer);
+
+    // Readings are only sent on change, so hand the current ones over now
+    if (cpu_notified) {
+        observer->onEvent({core::EventType::CPU_TEMP_CHANGED, *cpu_notified});
+    }
+    if (gpu_notified) {
+        observer->onEvent({core::EventType::GPU_TEMP_CHANGED, *gpu_notified});
+    }
 }
 
 void Monitoring::removeObserver(std::shared_ptr<core::Observer> observer) {
+    std::lock_guard<std::mutex> const LOCK(observer_lock);
     std::erase_if(observers,
                   [&observer](std::shared_ptr<core::Observer> const& o) {
                       return o == observer;
@@ -57,19 +97,70 @@ void Monitoring::notifyTempChanged(float temp, core::EventType event) {
     }
 }
 
+void Monitoring::notifyIfChanged(
+    float temp, SamplingPolicy const& p, std::optional<float>& last_notified,
+    std::chrono::steady_clock::time_point& notified_at, core::EventType event) {
+    std::lock_guard<std::mutex> const LOCK(observer_lock);
+    // A reading stuck inside the deadband is still resent now and then, a
+    // lost update can not hold a stale speed forever
+    auto now = std::chrono::steady_clock::now();
+    if (last_notified && std::abs(temp - *last_notified) < p.deadband &&
+        now - notified_at < p.max_age) {
+        return;
+    }
+
+    last_notified = temp;
+    notified_at = now;
+    for (auto&& o : observers) {
+        o->onEvent({event, temp});
+    }
+}
+
+auto Monitoring::nextInterval(float slope, SamplingPolicy const& p) const
+    -> std::chrono::milliseconds {
+    if (slope > p.slope_threshold) {
+        return p.fast_interval;
+    }
+
+    return std::clamp(current_interval.load() * 2, p.fast_interval,
+                      p.idle_interval);
+}
+
 void Monitoring::update() {
     int temp = 0;
     unsigned int gtemp = 0;
     bool ret = cpu->readCpuTempFile(temp);
     ret = gpu->readGPUTemp(gtemp);
 
-    notifyTempChanged(static_cast<float>(temp),
-                      core::EventType::CPU_TEMP_CHANGED);
-    notifyTempChanged(static_cast<float>(gtemp),
-                      core::EventType::GPU_TEMP_CHANGED);
+    SamplingPolicy p;
+    std::shared_ptr<TelemetrySink> out;
+    {
+        std::lock_guard<std::mutex> const LOCK(wait_lock);
+        p = policy;
+        out = sink;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    auto cpu_t = static_cast<float>(temp);
+    auto gpu_t = static_cast<float>(gtemp);
+
+    if (last_sample != std::chrono::steady_clock::time_point{}) {
+        float dt = std::chrono::duration<float>(now - last_sample).count();
+        float delta =
+            std::max(std::abs(cpu_t - cpu_temp), std::abs(gpu_t - gpu_temp));
+        current_interval.store(nextInterval(dt > 0 ? delta / dt : 0.0F, p));
+    }
+    last_sample = now;
+    cpu_temp = cpu_t;
+    gpu_temp = gpu_t;
+    if (out) {
+        out->publishTemperatures(cpu_t, gpu_t);
+    }
 
-    cpu_temp = temp;
-    gpu_temp = static_cast<int>(gtemp);
+    notifyIfChanged(cpu_t, p, cpu_notified, cpu_notified_at,
+                    core::EventType::CPU_TEMP_CHANGED);
+    notifyIfChanged(gpu_t, p, gpu_notified, gpu_notified_at,
+                    core::EventType::GPU_TEMP_CHANGED);
 }
 
 }  // namespace sys
@@ -0,0 +1,66 @@
+#include "system/sensorReader.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <utility>
+
+namespace sys {
+
+SensorReader::SensorReader(std::string const& path) { open(path); }
+
+SensorReader::SensorReader(SensorReader&& other) noexcept
+    : fd(std::exchange(other.fd, -1)) {}
+
+auto SensorReader::operator=(SensorReader&& other) noexcept -> SensorReader& {
+    if (this != &other) {
+        close();
+        fd = std::exchange(other.fd, -1);
+    }
+    return *this;
+}
+
+SensorReader::~SensorReader() { close(); }
+
+auto SensorReader::open(std::string const& path) -> bool {
+    close();
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    return fd >= 0;
+}
+
+void SensorReader::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+auto SensorReader::readInt(long& value) const -> bool {
+    if (fd < 0) {
+        return false;
+    }
+
+    std::array<char, SENSOR_READ_BUFFER_SIZE> buffer{};
+    ssize_t n = 0;
+    do {
+        n = ::pread(fd, buffer.data(), buffer.size(), 0);
+    } while (n < 0 && errno == EINTR);
+
+    if (n <= 0) {
+        return false;
+    }
+
+    char const* begin = buffer.data();
+    char const* end = begin + n;
+    while (begin < end && (*begin == ' ' || *begin == '\t')) {
+        begin++;
+    }
+
+    auto [ptr, ec] = std::from_chars(begin, end, value);
+    return ec == std::errc{} && ptr != begin;
+}
+
+}  // namespace sys
@@ -39,7 +39,7 @@ auto findFallbackInput(std::string const& path, char const* input_prefix,
             continue;
         }
         input = path + "/" + file;
-        core::Logger::log(core::LogLevel::INFO)
+        LOG_INFO(core::LogModule::CONFIG)
             << std::format("fallback cpu {} input: {}", input_prefix, input)
             << '\n';
         return true;
@@ -13,7 +13,7 @@ auto SystemBuilder::buildFromFile(std::string_view path,
     if (path.empty()) {
         home = std::getenv("HOME");
         if (!home) {
-            core::Logger::log(core::LogLevel::WARNING)
+            LOG_WARNING(core::LogModule::CONFIG)
                 << "HOME enviroment variable not set" << std::endl;
             return {};
         } else {
@@ -30,7 +30,7 @@ auto SystemBuilder::buildFromFile(std::string_view path,
             auto* controller_array = controllers_node.as_array();
 
             if (!controller_array) {
-                core::Logger::log(core::LogLevel::WARNING)
+                LOG_WARNING(core::LogModule::CONFIG)
                     << "Controller data must be array of fans" << std::endl;
                 system->addController(initDummyController(controller_idx++));
                 continue;
@@ -41,7 +41,7 @@ auto SystemBuilder::buildFromFile(std::string_view path,
         }
 
     } else {
-        core::Logger::log(core::LogLevel::WARNING)
+        LOG_WARNING(core::LogModule::CONFIG)
             << "Cannot found \"saved\" in config file" << std::endl;
         *system = initDummySystem(CONTROLERS_NUM);
     }
@@ -132,14 +132,14 @@ auto SystemBuilder::parseSpeeds(toml::table const& fan_table)
 
     auto* speeds_node = fan_table.get("Speeds");
     if (!speeds_node || !speeds_node->as_array()) {
-        core::Logger::log(core::LogLevel::WARNING)
+        LOG_WARNING(core::LogModule::CONFIG)
             << "Speeds must be array." << std::endl;
         return initDummySpeeds();
     }
 
     for (auto const& speed_value : *speeds_node->as_array()) {
         if (!speed_value.is_floating_point()) {
-            core::Logger::log(core::LogLevel::WARNING)
+            LOG_WARNING(core::LogModule::CONFIG)
                 << "Speed must be a floating point" << std::endl;
             speeds.push_back(DEFAULT_SPEED);
             continue;
@@ -157,14 +157,14 @@ auto SystemBuilder::parseTemps(toml::table const& fan_table)
 
     auto* temps_node = fan_table.get("Temps");
     if (!temps_node || !temps_node->as_array()) {
-        core::Logger::log(core::LogLevel::WARNING)
+        LOG_WARNING(core::LogModule::CONFIG)
             << "Speeds must be array." << std::endl;
         return initDummyTemps();
     }
 
     for (auto const& temp_value : *temps_node->as_array()) {
         if (!temp_value.is_floating_point()) {
-            core::Logger::log(core::LogLevel::WARNING)
+            LOG_WARNING(core::LogModule::CONFIG)
                 << "Temp must be a floating point" << std::endl;
             continue;
         }
@@ -182,14 +182,14 @@ auto SystemBuilder::parseControlPoints(toml::table const& fan_table)
 
     auto* cp_node = fan_table.get("Control points");
     if (!cp_node || !cp_node->as_array()) {
-        core::Logger::log(core::LogLevel::WARNING)
+        LOG_WARNING(core::LogModule::CONFIG)
             << "Control points must be array" << std::endl;
         return initDummyControlPoints();
     }
     for (auto const& cp : *cp_node->as_array()) {
         auto* cp_table = cp.as_table();
         if (!cp_table) {
-            core::Logger::log(core::LogLevel::WARNING)
+            LOG_WARNING(core::LogModule::CONFIG)
                 << "Incorrect point structure" << std::endl;
             return initDummyControlPoints();
         }
@@ -205,7 +205,7 @@ auto SystemBuilder::parseControlPoints(toml::table const& fan_table)
     }
 
     if (idx != 4) {
-        core::Logger::log(core::LogLevel::WARNING)
+        LOG_WARNING(core::LogModule::CONFIG)
             << "Controll points number must be 4" << std::endl;
         return initDummyControlPoints();
     }
@@ -236,7 +236,7 @@ auto SystemBuilder::parseFan(toml::table const& fan_table,
 
     int mode = getTomlValue<int>(fan_table, "Monitoring", 0);
     if (mode != 0 && mode != 1) {
-        core::Logger::log(core::LogLevel::WARNING)
+        LOG_WARNING(core::LogModule::CONFIG)
             << "Incorrect monitoring mode " << mode << " for fan " << FAN_IDX
             << ". Monitoring mode must be 0(CPU) or 1(GPU)" << std::endl;
         mode = 0;
@@ -260,13 +260,13 @@ auto SystemBuilder::parseController(toml::array const& controller_array,
         auto* fan_table = fans_node.as_table();
 
         if (fan_idx > MAX_FAN) {
-            core::Logger::log(core::LogLevel::WARNING)
+            LOG_WARNING(core::LogModule::CONFIG)
                 << "For one controller only 5 fans" << std::endl;
             break;
         }
 
         if (!fan_table) {
-            core::Logger::log(core::LogLevel::WARNING)
+            LOG_WARNING(core::LogModule::CONFIG)
                 << "Incorrect fan structure: expected table" << std::endl;
             controller.addFan(initDummyFan(fan_idx++));
             continue;
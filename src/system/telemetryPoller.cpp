@@ -0,0 +1,60 @@
+#include "system/telemetryPoller.hpp"
+
+#include <mutex>
+#include <utility>
+
+namespace sys {
+
+TelemetryPoller::TelemetryPoller(std::shared_ptr<DeviceController> device,
+                                 std::shared_ptr<FanTelemetry> telemetry,
+                                 std::chrono::milliseconds interval,
+                                 std::shared_ptr<TelemetrySink> sink)
+    : device(std::move(device)),
+      telemetry(std::move(telemetry)),
+      interval(interval) {
+    // Device protocol numbers fans from 1
+    this->device->setStatusHandler(
+        [t = this->telemetry, sink](std::size_t controller_idx,
+                                    FanStatus const& status) {
+            t->store(controller_idx, status.fan_idx - 1, status.speed,
+                     status.rpm);
+            if (sink) {
+                sink->publishStatus(controller_idx, status.fan_idx - 1,
+                                    status.speed, status.rpm);
+            }
+        });
+    poll_thread = std::jthread(
+        [this](std::stop_token const& stop) { pollLoop(stop); });
+}
+
+TelemetryPoller::~TelemetryPoller() {
+    poll_thread.request_stop();
+    if (poll_thread.joinable()) {
+        poll_thread.join();
+    }
+    device->setStatusHandler(nullptr);
+}
+
+void TelemetryPoller::setInterval(std::chrono::milliseconds period) {
+    std::lock_guard<std::mutex> lock(interval_lock);
+    interval = period;
+    interval_cv.notify_all();
+}
+
+void TelemetryPoller::pollLoop(std::stop_token const& stop) {
+    while (!stop.stop_requested()) {
+        for (std::size_t c = 0; c < telemetry->controllersNum(); c++) {
+            for (std::size_t f = 0; f < telemetry->channelsNum(); f++) {
+                device->queueFanStatus(c, f + 1);
+            }
+            device->flush(c);
+        }
+
+        std::unique_lock<std::mutex> lock(interval_lock);
+        auto period = interval;
+        interval_cv.wait_for(lock, stop, period,
+                             [this, period] { return interval != period; });
+    }
+}
+
+}  // namespace sys
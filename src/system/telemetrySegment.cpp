@@ -0,0 +1,229 @@
+#include "system/telemetrySegment.hpp"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+constexpr int const SHM_READ_ATTEMPTS = 64;
+
+namespace {
+
+auto shmError(std::string const& what, std::string const& name)
+    -> std::runtime_error {
+    return std::runtime_error(what + " " + name + ": " + std::strerror(errno));
+}
+
+auto monotonicNs() -> uint64_t {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL +  // NOLINT
+           static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// A complete segment whose creator no longer runs
+auto isOrphaned(std::string const& name) -> bool {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st {};
+    void* addr = MAP_FAILED;
+    if (fstat(fd, &st) == 0 &&
+        static_cast<std::size_t>(st.st_size) >= sizeof(sys::SharedTelemetry)) {
+        addr = mmap(nullptr, sizeof(sys::SharedTelemetry), PROT_READ,
+                    MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+
+    auto const* shared = static_cast<sys::SharedTelemetry const*>(addr);
+    bool orphaned = shared->magic == sys::SHM_MAGIC &&
+                    kill(static_cast<pid_t>(shared->owner_pid), 0) != 0 &&
+                    errno == ESRCH;
+    munmap(addr, sizeof(sys::SharedTelemetry));
+    return orphaned;
+}
+
+}  // namespace
+
+namespace sys {
+
+TelemetrySegment::TelemetrySegment(std::size_t controllers_num,
+                                   std::size_t channels_num, std::string name)
+    : name(std::move(name)) {
+    int fd = shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST && isOrphaned(this->name)) {
+        shm_unlink(this->name.c_str());
+        fd = shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if (fd < 0 && errno == EEXIST) {
+        throw std::runtime_error("Telemetry segment " + this->name +
+                                 " belongs to another running instance");
+    }
+    if (fd < 0) {
+        throw shmError("shm_open", this->name);
+    }
+    if (ftruncate(fd, sizeof(SharedTelemetry)) != 0) {
+        auto error = shmError("ftruncate", this->name);
+        close(fd);
+        shm_unlink(this->name.c_str());
+        throw error;
+    }
+
+    void* addr = mmap(nullptr, sizeof(SharedTelemetry), PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        auto error = shmError("mmap", this->name);
+        shm_unlink(this->name.c_str());
+        throw error;
+    }
+
+    shared = new (addr) SharedTelemetry{};
+    shared->controllers = static_cast<uint32_t>(
+        std::min(controllers_num, SHM_MAX_CONTROLLERS));
+    shared->channels =
+        static_cast<uint32_t>(std::min(channels_num, SHM_MAX_CHANNELS));
+    shared->version = SHM_VERSION;
+    shared->owner_pid = static_cast<uint32_t>(getpid());
+    std::atomic_thread_fence(std::memory_order_release);
+    shared->magic = SHM_MAGIC;
+}
+
+// O_EXCL made the segment ours, nobody replaces it while this process runs
+TelemetrySegment::~TelemetrySegment() {
+    munmap(shared, sizeof(SharedTelemetry));
+    shm_unlink(name.c_str());
+}
+
+auto TelemetrySegment::fan(std::size_t controller_idx, std::size_t fan_idx)
+    -> SharedFan* {
+    if (controller_idx >= shared->controllers ||
+        fan_idx >= shared->channels) {
+        return nullptr;
+    }
+    return &shared->fans[controller_idx * SHM_MAX_CHANNELS + fan_idx];
+}
+
+void TelemetrySegment::beginWrite() {
+    write_lock.lock();
+    shared->sequence.store(shared->sequence.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void TelemetrySegment::endWrite() {
+    shared->updated_ns.store(monotonicNs(), std::memory_order_relaxed);
+    shared->sequence.store(shared->sequence.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_release);
+    write_lock.unlock();
+}
+
+void TelemetrySegment::publishTemperatures(float cpu_temp, float gpu_temp) {
+    beginWrite();
+    shared->cpu_temp.store(cpu_temp, std::memory_order_relaxed);
+    shared->gpu_temp.store(gpu_temp, std::memory_order_relaxed);
+    endWrite();
+}
+
+void TelemetrySegment::publishTarget(std::size_t controller_idx,
+                                     std::size_t fan_idx, float speed) {
+    SharedFan* f = fan(controller_idx, fan_idx);
+    if (f == nullptr) {
+        return;
+    }
+    beginWrite();
+    f->target_speed.store(speed, std::memory_order_relaxed);
+    endWrite();
+}
+
+void TelemetrySegment::publishStatus(std::size_t controller_idx,
+                                     std::size_t fan_idx, std::size_t speed,
+                                     std::size_t rpm) {
+    SharedFan* f = fan(controller_idx, fan_idx);
+    if (f == nullptr) {
+        return;
+    }
+    beginWrite();
+    f->speed.store(static_cast<uint32_t>(speed), std::memory_order_relaxed);
+    f->rpm.store(static_cast<uint32_t>(rpm), std::memory_order_relaxed);
+    f->valid.store(1, std::memory_order_relaxed);
+    endWrite();
+}
+
+TelemetrySegmentReader::TelemetrySegmentReader(std::string const& name) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw shmError("shm_open", name);
+    }
+    void* addr =
+        mmap(nullptr, sizeof(SharedTelemetry), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        throw shmError("mmap", name);
+    }
+
+    shared = static_cast<SharedTelemetry const*>(addr);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (shared->magic != SHM_MAGIC || shared->version != SHM_VERSION) {
+        munmap(addr, sizeof(SharedTelemetry));
+        throw std::runtime_error("Unsupported telemetry segment " + name);
+    }
+}
+
+TelemetrySegmentReader::~TelemetrySegmentReader() {
+    munmap(const_cast<SharedTelemetry*>(shared),  // NOLINT
+           sizeof(SharedTelemetry));
+}
+
+auto TelemetrySegmentReader::read() const -> std::optional<TelemetrySnapshot> {
+    TelemetrySnapshot snapshot{};
+    snapshot.controllers = shared->controllers;
+    snapshot.channels = shared->channels;
+    snapshot.fans.resize(snapshot.controllers * snapshot.channels);
+
+    for (int attempt = 0; attempt < SHM_READ_ATTEMPTS; attempt++) {
+        uint64_t begin = shared->sequence.load(std::memory_order_acquire);
+        if ((begin & 1U) != 0) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        snapshot.updated_ns =
+            shared->updated_ns.load(std::memory_order_relaxed);
+        snapshot.cpu_temp = shared->cpu_temp.load(std::memory_order_relaxed);
+        snapshot.gpu_temp = shared->gpu_temp.load(std::memory_order_relaxed);
+        for (std::size_t c = 0; c < snapshot.controllers; c++) {
+            for (std::size_t f = 0; f < snapshot.channels; f++) {
+                auto const& src = shared->fans[c * SHM_MAX_CHANNELS + f];
+                snapshot.fans[c * snapshot.channels + f] = {
+                    src.target_speed.load(std::memory_order_relaxed),
+                    src.speed.load(std::memory_order_relaxed),
+                    src.rpm.load(std::memory_order_relaxed),
+                    src.valid.load(std::memory_order_relaxed) != 0};
+            }
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (shared->sequence.load(std::memory_order_relaxed) == begin) {
+            snapshot.sequence = begin;
+            return snapshot;
+        }
+    }
+    return std::nullopt;
+}
+
+}  // namespace sys
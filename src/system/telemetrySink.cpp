@@ -0,0 +1,41 @@
+#include "system/telemetrySink.hpp"
+
+#include <vector>
+#include <utility>
+
+namespace sys {
+
+void TelemetryFanout::publishTemperatures(float cpu_temp, float gpu_temp) {
+    for (auto const& s : sinks) {
+        s->publishTemperatures(cpu_temp, gpu_temp);
+    }
+}
+
+void TelemetryFanout::publishTarget(std::size_t controller_idx,
+                                    std::size_t fan_idx, float speed) {
+    for (auto const& s : sinks) {
+        s->publishTarget(controller_idx, fan_idx, speed);
+    }
+}
+
+void TelemetryFanout::publishStatus(std::size_t controller_idx,
+                                    std::size_t fan_idx, std::size_t speed,
+                                    std::size_t rpm) {
+    for (auto const& s : sinks) {
+        s->publishStatus(controller_idx, fan_idx, speed, rpm);
+    }
+}
+
+auto combineSinks(std::vector<std::shared_ptr<TelemetrySink>> sinks)
+    -> std::shared_ptr<TelemetrySink> {
+    std::erase(sinks, nullptr);
+    if (sinks.empty()) {
+        return nullptr;
+    }
+    if (sinks.size() == 1) {
+        return sinks.front();
+    }
+    return std::make_shared<TelemetryFanout>(std::move(sinks));
+}
+
+}  // namespace sys
@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+#include "system/bezierSolver.hpp"
+
+constexpr double const SOLVER_TOLERANCE = 0.01;
+
+TEST(BezierSolverTest, HitsPointsOfRandomMonotonicCurves) {
+    std::mt19937 rng(42);  // NOLINT
+    std::uniform_real_distribution<double> dist(0.0, 100.0);
+
+    for (int curve = 0; curve < 200; curve++) {
+        std::array<double, 4> xs{0.0, dist(rng), dist(rng), 100.0};
+        std::sort(xs.begin(), xs.end());
+        sys::ControlPoints cp{std::make_pair(xs[0], dist(rng)),
+                              std::make_pair(xs[1], dist(rng)),
+                              std::make_pair(xs[2], dist(rng)),
+                              std::make_pair(xs[3], dist(rng))};
+        sys::BezierSolver const solver(cp);
+
+        for (double t = 0.0; t <= 1.0; t += 0.01) {  // NOLINT
+            auto [temp, speed] = solver.pointAt(t);
+            EXPECT_NEAR(solver.speedForTemp(temp), speed, SOLVER_TOLERANCE)
+                << "curve " << curve << " t " << t;
+        }
+    }
+}
+
+TEST(BezierSolverTest, ClampsOutsideCurve) {
+    sys::ControlPoints cp{std::make_pair(10.0, 20.0),
+                          std::make_pair(40.0, 30.0),
+                          std::make_pair(60.0, 70.0),
+                          std::make_pair(90.0, 80.0)};
+    sys::BezierSolver const solver(cp);
+
+    EXPECT_DOUBLE_EQ(solver.speedForTemp(0.0), 20.0);
+    EXPECT_DOUBLE_EQ(solver.speedForTemp(100.0), 80.0);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "core/colorKernels.hpp"
+
+namespace {
+
+// Sizes around the 16 and 32 byte vectors, so every tail length runs
+constexpr std::size_t const MAX_LEDS = 70;
+
+auto randomLeds(std::mt19937& rng, std::size_t n)
+    -> std::vector<sys::LedColor> {
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::vector<sys::LedColor> leds(n);
+    for (auto& led : leds) {
+        for (auto& channel : led) {
+            channel = static_cast<uint8_t>(dist(rng));
+        }
+    }
+    return leds;
+}
+
+auto supportedIsas() -> std::vector<core::KernelIsa> {
+    std::vector<core::KernelIsa> isas;
+    for (auto isa : {core::KernelIsa::SSE2, core::KernelIsa::AVX2}) {
+        if (core::kernelsSupported(isa)) {
+            isas.push_back(isa);
+        }
+    }
+    return isas;
+}
+
+}  // namespace
+
+TEST(ColorKernelsTest, ScalarMath) {
+    sys::LedColor from{0, 100, 255};
+    sys::LedColor to{255, 0, 55};
+    EXPECT_EQ(core::blendColor(from, to, 0), from);
+    EXPECT_EQ(core::blendColor(from, to, core::BLEND_ONE), to);
+    EXPECT_EQ(core::blendColor(from, to, core::BLEND_ONE / 2),
+              (sys::LedColor{127, 50, 155}));
+
+    std::vector<sys::LedColor> leds{{0, 1, 16}, {128, 254, 255}};
+    core::colorKernels(core::KernelIsa::SCALAR).gamma(leds);
+    EXPECT_EQ(leds[0], (sys::LedColor{0, 0, 1}));
+    EXPECT_EQ(leds[1], (sys::LedColor{64, 253, 255}));
+
+    // Primaries at the sector borders, in GRB
+    EXPECT_EQ(core::hsvToGrb(0, 255, 255), (sys::LedColor{0, 255, 0}));
+    EXPECT_EQ(core::hsvToGrb(core::HUE_TURN / 3, 255, 255),
+              (sys::LedColor{255, 0, 0}));
+    EXPECT_EQ(core::hsvToGrb(core::HUE_TURN * 2 / 3 + 1, 255, 255),
+              (sys::LedColor{0, 0, 255}));
+    EXPECT_EQ(core::hsvToGrb(12345, 0, 200), (sys::LedColor{200, 200, 200}))
+        << "No saturation is grey";
+    EXPECT_EQ(core::hsvToGrb(12345, 255, 0), (sys::LedColor{0, 0, 0}));
+}
+
+TEST(ColorKernelsTest, VectorKernelsMatchScalar) {
+    auto const& scalar = core::colorKernels(core::KernelIsa::SCALAR);
+    std::mt19937 rng(11);  // NOLINT
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<int> hue(0, UINT16_MAX);
+
+    for (auto isa : supportedIsas()) {
+        auto const& kernels = core::colorKernels(isa);
+        ASSERT_EQ(kernels.isa, isa);
+        for (std::size_t n = 0; n <= MAX_LEDS; n++) {
+            auto from = randomLeds(rng, n);
+            auto to = randomLeds(rng, n);
+            auto weight = static_cast<uint16_t>(
+                std::uniform_int_distribution<int>(0, core::BLEND_ONE)(rng));
+            std::vector<sys::LedColor> expected(n);
+            std::vector<sys::LedColor> actual(n);
+            scalar.blend(from, to, weight, expected);
+            kernels.blend(from, to, weight, actual);
+            ASSERT_EQ(actual, expected) << "blend, " << n << " LEDs";
+
+            scalar.gamma(expected);
+            kernels.gamma(actual);
+            ASSERT_EQ(actual, expected) << "gamma, " << n << " LEDs";
+
+            std::vector<uint16_t> hues(n);
+            for (auto& h : hues) {
+                h = static_cast<uint16_t>(hue(rng));
+            }
+            auto sat = static_cast<uint8_t>(byte(rng));
+            auto val = static_cast<uint8_t>(byte(rng));
+            scalar.hsvToGrb(hues, sat, val, expected);
+            kernels.hsvToGrb(hues, sat, val, actual);
+            ASSERT_EQ(actual, expected) << "hsv, " << n << " LEDs";
+        }
+    }
+}
+
+TEST(ColorKernelsTest, HsvCoversEveryHue) {
+    std::vector<uint16_t> hues(core::HUE_TURN);
+    for (uint32_t h = 0; h < core::HUE_TURN; h++) {
+        hues[h] = static_cast<uint16_t>(h);
+    }
+    std::vector<sys::LedColor> expected(hues.size());
+    core::colorKernels(core::KernelIsa::SCALAR)
+        .hsvToGrb(hues, 255, 255, expected);
+
+    for (auto isa : supportedIsas()) {
+        std::vector<sys::LedColor> actual(hues.size());
+        core::colorKernels(isa).hsvToGrb(hues, 255, 255, actual);
+        EXPECT_EQ(actual, expected);
+    }
+    // The best kernels are one of the above
+    EXPECT_TRUE(core::kernelsSupported(core::colorKernels().isa));
+}
@@ -0,0 +1,235 @@
+#include <gtest/gtest.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/controlProtocol.hpp"
+#include "core/controlServer.hpp"
+#include "core/mediators/fanMediator.hpp"
+
+// Records what the server asks the mediator to do
+class RecordingMediator : public core::Mediator {
+   public:
+    void notify(EventMessageType event_type,
+                std::shared_ptr<Message> msg) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        events.emplace_back(event_type, std::move(msg));
+    }
+
+    std::vector<std::pair<EventMessageType, std::shared_ptr<Message>>>
+    received() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return events;
+    }
+
+   private:
+    std::mutex mutex;
+    std::vector<std::pair<EventMessageType, std::shared_ptr<Message>>> events;
+};
+
+class TestClient {
+   public:
+    explicit TestClient(std::string const& path)
+        : fd(socket(AF_UNIX, SOCK_STREAM, 0)) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::copy(path.begin(), path.end(), addr.sun_path);
+        connected = connect(fd, reinterpret_cast<sockaddr*>(&addr),  // NOLINT
+                            sizeof(addr)) == 0;
+    }
+    TestClient(TestClient const&) = delete;
+    TestClient& operator=(TestClient const&) = delete;
+    ~TestClient() { close(fd); }
+
+    void send(std::string const& line) {
+        std::string data = line + '\n';
+        ASSERT_EQ(::send(fd, data.data(), data.size(), 0),
+                  static_cast<ssize_t>(data.size()));
+    }
+
+    // Empty string on timeout
+    std::string readLine() {
+        auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (buffer.find('\n') == std::string::npos) {
+            pollfd p{fd, POLLIN, 0};
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            if (left.count() <= 0 ||
+                poll(&p, 1, static_cast<int>(left.count())) <= 0) {
+                return "";
+            }
+            std::array<char, 512> chunk{};
+            ssize_t n = recv(fd, chunk.data(), chunk.size(), 0);
+            if (n <= 0) {
+                return "";
+            }
+            buffer.append(chunk.data(), n);
+        }
+        auto nl = buffer.find('\n');
+        std::string line = buffer.substr(0, nl);
+        buffer.erase(0, nl + 1);
+        return line;
+    }
+
+    bool connected = false;  // NOLINT
+
+   private:
+    int fd;
+    std::string buffer;
+};
+
+class ControlServerTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        path = (std::filesystem::temp_directory_path() /
+                ("control_test_" + std::to_string(::getpid()) + ".sock"))
+                   .string();
+        mediator = std::make_shared<RecordingMediator>();
+        telemetry = std::make_shared<sys::FanTelemetry>(1, 5);
+        server =
+            std::make_unique<core::ControlServer>(path, mediator, telemetry);
+    }
+    void TearDown() override {
+        server.reset();
+        EXPECT_FALSE(std::filesystem::exists(path));
+    }
+
+    std::string path;  // NOLINT
+    std::shared_ptr<RecordingMediator> mediator;       // NOLINT
+    std::shared_ptr<sys::FanTelemetry> telemetry;      // NOLINT
+    std::unique_ptr<core::ControlServer> server;       // NOLINT
+};
+
+TEST(ControlProtocolTest, ParsesFlatObjects) {
+    auto request = core::parseJsonObject(
+        R"( {"cmd":"curve", "fan":2, "temps":[30, 50.5], "all":true,)"
+        R"( "name":"a\"b", "none":null} )");
+
+    EXPECT_EQ(request.string("cmd"), "curve");
+    EXPECT_EQ(request.number("fan"), 2);
+    EXPECT_EQ(request.numbers("temps"), (std::vector<double>{30, 50.5}));
+    EXPECT_TRUE(request.boolean("all", false));
+    EXPECT_EQ(request.string("name"), "a\"b");
+    EXPECT_EQ(request.number("missing", 7), 7);
+    EXPECT_THROW(request.number("cmd"), std::runtime_error);
+
+    EXPECT_THROW(core::parseJsonObject(R"({"cmd":})"), std::runtime_error);
+    EXPECT_THROW(core::parseJsonObject(R"({"a":1} x)"), std::runtime_error);
+}
+
+TEST_F(ControlServerTest, RoutesCommandsThroughMediator) {
+    TestClient client(path);
+    ASSERT_TRUE(client.connected);
+
+    client.send(R"({"cmd":"color","controller":0,"fan":3,"r":1,"g":0.5,"b":0})");
+    EXPECT_EQ(client.readLine(), R"({"ok":true})");
+    client.send(R"({"cmd":"mode","controller":0,"fan":1,"mode":"gpu"})");
+    EXPECT_EQ(client.readLine(), R"({"ok":true})");
+    client.send(R"({"cmd":"color","controller":1,"fan":0,"r":1,"g":1,"b":1})");
+    EXPECT_EQ(client.readLine(), R"({"ok":false,"error":"No such fan"})");
+    client.send("not json");
+    EXPECT_NE(client.readLine().find(R"("ok":false)"), std::string::npos);
+
+    auto events = mediator->received();
+    ASSERT_EQ(events.size(), 2);
+    EXPECT_EQ(events[0].first, EventMessageType::UPDATE_COLOR);
+    auto color = std::static_pointer_cast<ColorMessage>(events[0].second);
+    EXPECT_EQ(color->f_idx, 3);
+    EXPECT_FLOAT_EQ(color->g, 0.5F);
+    EXPECT_EQ(events[1].first, EventMessageType::UPDATE_MONITORING_MODE_FAN);
+    EXPECT_EQ(std::static_pointer_cast<ModeMessage>(events[1].second)->mode,
+              1);
+}
+
+TEST_F(ControlServerTest, StreamsTelemetryToEverySubscriber) {
+    server->temperatureObserver()->onEvent(
+        {core::EventType::CPU_TEMP_CHANGED, 42.5F});
+    telemetry->store(0, 2, 60, 1500);
+
+    TestClient first(path);
+    TestClient second(path);
+    first.send(R"({"cmd":"subscribe","period_ms":100})");
+    second.send(R"({"cmd":"subscribe","period_ms":100})");
+
+    for (auto* client : {&first, &second}) {
+        EXPECT_EQ(client->readLine(), R"({"ok":true})");
+        std::string frame = client->readLine();
+        EXPECT_EQ(frame,
+                  R"({"event":"telemetry","cpu":42.5,"gpu":0.0,"fans":[)"
+                  R"({"controller":0,"fan":2,"speed":60,"rpm":1500}]})");
+        EXPECT_EQ(client->readLine(), frame) << "Stream keeps going";
+    }
+    EXPECT_EQ(server->clientsNum(), 2);
+}
+
+TEST_F(ControlServerTest, RejectsCurvesThatCanNotDriveFans) {
+    std::atomic<int> changes = 0;
+    server.reset();
+    server = std::make_unique<core::ControlServer>(path, mediator, telemetry,
+                                                   [&changes] { changes++; });
+    TestClient client(path);
+    ASSERT_TRUE(client.connected);
+
+    std::string const curve = R"({"cmd":"curve","controller":0,"fan":0,)";
+    for (std::string const& bad :
+         {curve + R"("temps":[30,nan],"speeds":[10,20]})",
+          curve + R"("temps":[50,50],"speeds":[10,20]})",
+          curve + R"("temps":[30,50],"speeds":[-1,20]})",
+          curve + R"("temps":[30,50],"speeds":[10,inf]})",
+          std::string(R"({"cmd":"bezier","controller":0,"fan":0,)"
+                      R"("points":[0,0,40,101,60,40,100,100]})")}) {
+        client.send(bad);
+        EXPECT_NE(client.readLine().find(R"("ok":false)"), std::string::npos)
+            << bad;
+    }
+    EXPECT_TRUE(mediator->received().empty());
+    EXPECT_EQ(changes.load(), 0);
+
+    client.send(curve + R"("temps":[30,50],"speeds":[0,100]})");
+    EXPECT_EQ(client.readLine(), R"({"ok":true})");
+    EXPECT_EQ(mediator->received().size(), 1);
+    EXPECT_EQ(changes.load(), 1);
+}
+
+TEST_F(ControlServerTest, RejectsNumbersOutsideTheirRange) {
+    TestClient client(path);
+    ASSERT_TRUE(client.connected);
+
+    std::string const rgb = R"("r":1,"g":1,"b":1})";
+    for (std::string const& bad :
+         {R"({"cmd":"color","controller":1e300,"fan":0,)" + rgb,
+          R"({"cmd":"color","controller":0,"fan":-1,)" + rgb,
+          R"({"cmd":"effect","effect":0,"duration":inf,)" + rgb,
+          std::string(R"({"cmd":"subscribe","period_ms":1e300})"),
+          std::string(R"({"cmd":"subscribe","period_ms":-5})"),
+          std::string(R"({"cmd":"subscribe","period_ms":nan})")}) {
+        client.send(bad);
+        EXPECT_NE(client.readLine().find(R"("ok":false)"), std::string::npos)
+            << bad;
+    }
+    EXPECT_TRUE(mediator->received().empty());
+}
+
+TEST(ControlServerPathTest, KeepsFilesThatAreNotSockets) {
+    auto path = std::filesystem::temp_directory_path() /
+                ("control_file_" + std::to_string(::getpid()));
+    { std::ofstream(path) << "keep"; }
+
+    EXPECT_THROW(core::ControlServer(path.string(), nullptr, nullptr),
+                 std::runtime_error);
+    EXPECT_TRUE(std::filesystem::is_regular_file(path));
+    std::filesystem::remove(path);
+}
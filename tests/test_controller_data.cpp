@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <utility>
+#include <vector>
+
+#include "system/controllerData.hpp"
+
+constexpr double const LUT_TOLERANCE = 0.05;
+
+TEST(FanSpeedDataTest, LookupMatchesLinearInterpolation) {
+    sys::FanSpeedData data({0.0, 50.0, 100.0}, {20.0, 40.0, 100.0});
+
+    EXPECT_NEAR(data.getSpeedForTemp(0.0F), 20.0, LUT_TOLERANCE);
+    EXPECT_NEAR(data.getSpeedForTemp(25.0F), 30.0, LUT_TOLERANCE);
+    EXPECT_NEAR(data.getSpeedForTemp(75.05F), 70.06, LUT_TOLERANCE);
+    EXPECT_NEAR(data.getSpeedForTemp(100.0F), 100.0, LUT_TOLERANCE);
+    EXPECT_NEAR(data.getSpeedForTemp(120.0F), 100.0, LUT_TOLERANCE)
+        << "Temperatures above the table must clamp";
+}
+
+TEST(FanSpeedDataTest, TableRebuiltAfterCurveEdit) {
+    sys::FanSpeedData data({0.0, 100.0}, {0.0, 100.0});
+    EXPECT_NEAR(data.getSpeedForTemp(40.0F), 40.0, LUT_TOLERANCE);
+
+    data.updateData({0.0, 100.0}, {50.0, 50.0});
+    EXPECT_NEAR(data.getSpeedForTemp(40.0F), 50.0, LUT_TOLERANCE);
+}
+
+TEST(FanBezierDataTest, LookupFollowsCurveAndEdits) {
+    sys::FanBezierData bdata({std::make_pair(0.0, 0.0),
+                              std::make_pair(30.0, 30.0),
+                              std::make_pair(70.0, 70.0),
+                              std::make_pair(100.0, 100.0)});
+
+    EXPECT_NEAR(bdata.getSpeedForTemp(42.5F), 42.5, LUT_TOLERANCE);
+
+    bdata.setData({std::make_pair(0.0, 60.0), std::make_pair(30.0, 60.0),
+                   std::make_pair(70.0, 60.0), std::make_pair(100.0, 60.0)});
+    EXPECT_NEAR(bdata.getSpeedForTemp(42.5F), 60.0, LUT_TOLERANCE);
+}
+
+TEST(SpeedLutTest, EditDuringBuildKeepsTableDirty) {
+    sys::SpeedLut lut;
+    bool edited = false;
+    lut.build([&](double t) {
+        // What an edit from another thread looks like halfway through
+        if (!edited && t >= LUT_MAX_TEMP / 2) {
+            lut.invalidate();
+            edited = true;
+        }
+        return t;
+    });
+    EXPECT_TRUE(edited);
+    EXPECT_TRUE(lut.isDirty()) << "The edit must trigger another build";
+
+    lut.build([](double t) { return t; });
+    EXPECT_FALSE(lut.isDirty());
+    EXPECT_NEAR(lut.lookup(42.0), 42.0, LUT_TOLERANCE);
+}
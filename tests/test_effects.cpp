@@ -0,0 +1,291 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#include "core/commands/compositeCommand.hpp"
+#include "core/commands/fadeCommand.hpp"
+#include "core/commands/fadeInCommand.hpp"
+#include "core/commands/rainbowColorCommand.hpp"
+#include "core/commands/rainbowColorFadeCommand.hpp"
+#include "core/commands/rainbowSpinCommand.hpp"
+#include "core/commands/staticColorCommand.hpp"
+#include "core/effect.hpp"
+#include "core/effectsEngine.hpp"
+#include "core/logger.hpp"
+#include "core/valueEffectsEngine.hpp"
+
+// Counts operator new per thread, so allocations made by other tests'
+// threads (logger, workers) do not show up here. The aligned forms are
+// replaced too, frames are allocated with them.
+namespace {
+thread_local std::size_t allocations = 0;
+}  // namespace
+
+auto operator new(std::size_t size) -> void* {
+    allocations++;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {  // NOLINT
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }  // NOLINT
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+    std::free(ptr);  // NOLINT
+}
+
+auto operator new(std::size_t size, std::align_val_t align) -> void* {
+    allocations++;
+    auto alignment = static_cast<std::size_t>(align);
+    // aligned_alloc wants a whole number of alignments
+    std::size_t rounded = (size + alignment) / alignment * alignment;
+    if (void* ptr = std::aligned_alloc(alignment, rounded)) {  // NOLINT
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr, std::align_val_t /*align*/) noexcept {
+    std::free(ptr);  // NOLINT
+}
+
+void operator delete(void* ptr, std::size_t /*size*/,
+                     std::align_val_t /*align*/) noexcept {
+    std::free(ptr);  // NOLINT
+}
+
+namespace {
+
+using Color = std::array<uint8_t, 3>;
+constexpr std::chrono::milliseconds const FRAME = std::chrono::milliseconds(10);
+
+// Runs frames on a warmed up engine and returns how many allocations they
+// made
+template <typename Engine>
+auto allocationsDuring(Engine& engine, std::size_t frames) -> std::size_t {
+    std::size_t before = allocations;
+    for (std::size_t i = 0; i < frames; i++) {
+        engine.update(FRAME);
+    }
+    return allocations - before;
+}
+
+class EffectsTest : public ::testing::Test {
+   protected:
+    // Logging formats its message on the heap, the effects thread runs
+    // with INFO off
+    void SetUp() override {
+        core::Logger::log.setModuleLevel(core::LogModule::CORE,
+                                         core::LogLevel::ERROR);
+    }
+    void TearDown() override {
+        core::Logger::log.setModuleLevel(core::LogModule::CORE,
+                                         core::COMPILED_LOG_LEVEL);
+    }
+};
+
+}  // namespace
+
+TEST_F(EffectsTest, PlaybackDoesNotAllocate) {
+    core::EffectsEngine engine;
+    engine.addEffect(std::make_unique<core::RainbowColorCommand>(
+        std::chrono::milliseconds(50)));
+    engine.addEffect(std::make_unique<core::RainbowColorFadeCommand>(
+        std::chrono::milliseconds(50)));
+    auto composite = std::make_unique<core::CompositeCommand>();
+    composite->addCommand(std::make_unique<core::StaticColorCommand>(
+        255, 0, 0, std::chrono::hours(1)));
+    engine.addEffect(std::move(composite));
+
+    // Many times through every fade of the rainbows
+    for (std::size_t idx = 0; idx < engine.getEffectCount(); idx++) {
+        engine.setActiveEffect(idx);
+        engine.update(FRAME);
+        EXPECT_EQ(allocationsDuring(engine, 1000), 0) << "effect " << idx;
+    }
+}
+
+TEST_F(EffectsTest, ReconfigureDoesNotAllocate) {
+    core::EffectsEngine engine;
+    engine.addEffect(std::make_unique<core::RainbowColorFadeCommand>(
+        std::chrono::seconds(2)));
+    engine.addEffect(std::make_unique<core::StaticColorCommand>(
+        0, 0, 0, std::chrono::hours(1)));
+
+    for (std::size_t idx = 0; idx < engine.getEffectCount(); idx++) {
+        engine.setActiveEffect(idx);
+        std::size_t before = allocations;
+        engine.updateActiveEffect({10, 20, 30}, std::chrono::milliseconds(30));
+        EXPECT_EQ(allocations - before, 0) << "effect " << idx;
+    }
+
+    // The static color took the new color in place
+    EXPECT_EQ(engine.update(FRAME), (Color{10, 20, 30}));
+}
+
+TEST_F(EffectsTest, ResetRewindsInPlace) {
+    core::FadeCommand fade({0, 0, 0}, {200, 100, 0},
+                           std::chrono::milliseconds(20));
+    EXPECT_EQ(fade.execute(FRAME), (Color{0, 0, 0}));
+    EXPECT_EQ(fade.execute(FRAME), (Color{100, 50, 0}));
+    EXPECT_EQ(fade.execute(FRAME), (Color{200, 100, 0}));
+    EXPECT_TRUE(fade.isFinished());
+
+    fade.reset();
+    EXPECT_FALSE(fade.isFinished());
+    EXPECT_EQ(fade.execute(FRAME), (Color{0, 0, 0}));
+
+    // A rainbow comes back to red after a full cycle of six fades, each
+    // taking three frames
+    core::RainbowColorCommand rainbow(std::chrono::milliseconds(20));
+    Color first = rainbow.execute(FRAME);
+    EXPECT_EQ(first, (Color{255, 0, 0}));
+    for (int i = 1; i < 6 * 3; i++) {
+        rainbow.execute(FRAME);
+    }
+    EXPECT_EQ(rainbow.execute(FRAME), first);
+
+    rainbow.execute(FRAME);
+    rainbow.reset();
+    EXPECT_EQ(rainbow.execute(FRAME), first);
+}
+
+TEST_F(EffectsTest, ValueEffectsPlayLikeCommands) {
+    auto const fade = std::chrono::milliseconds(70);
+    auto const hold = std::chrono::milliseconds(40);
+    core::EffectsEngine commands;
+    core::ValueEffectsEngine values;
+
+    commands.addEffect(std::make_unique<core::StaticColorCommand>(
+        1, 2, 3, std::chrono::milliseconds(500)));
+    values.addEffect(
+        core::StaticEffect({1, 2, 3}, std::chrono::milliseconds(500)));
+    commands.addEffect(std::make_unique<core::FadeCommand>(
+        Color{9, 200, 40}, Color{250, 0, 90}, fade));
+    values.addEffect(core::FadeEffect({9, 200, 40}, {250, 0, 90}, fade));
+    commands.addEffect(std::make_unique<core::RainbowColorCommand>(fade));
+    values.addEffect(core::RainbowEffect(fade));
+    commands.addEffect(std::make_unique<core::RainbowColorFadeCommand>(fade));
+    values.addEffect(core::RainbowFadeEffect(fade));
+
+    // Composites nest, the inner one plays in the middle
+    auto inner_command = std::make_unique<core::CompositeCommand>();
+    inner_command->addCommand(
+        std::make_unique<core::FadeInCommand>(Color{0, 128, 255}, fade));
+    inner_command->addCommand(
+        std::make_unique<core::StaticColorCommand>(7, 7, 7, hold));
+    auto command = std::make_unique<core::CompositeCommand>();
+    command->addCommand(
+        std::make_unique<core::StaticColorCommand>(255, 0, 0, hold));
+    command->addCommand(std::move(inner_command));
+    command->addCommand(std::make_unique<core::RainbowColorCommand>(fade));
+    commands.addEffect(std::move(command));
+
+    core::CompositeEffect inner;
+    inner.addEffect(core::FadeEffect({0, 0, 0}, {0, 128, 255}, fade));
+    inner.addEffect(core::StaticEffect({7, 7, 7}, hold));
+    core::CompositeEffect value;
+    value.addEffect(core::StaticEffect({255, 0, 0}, hold));
+    value.addEffect(inner);
+    value.addEffect(core::RainbowEffect(fade));
+    values.addEffect(value);
+
+    ASSERT_EQ(values.getEffectCount(), commands.getEffectCount());
+    for (std::size_t idx = 0; idx < values.getEffectCount(); idx++) {
+        commands.setActiveEffect(idx);
+        values.setActiveEffect(idx);
+        for (int frame = 0; frame < 200; frame++) {
+            ASSERT_EQ(values.update(FRAME), commands.update(FRAME))
+                << "effect " << idx << " frame " << frame;
+            ASSERT_EQ(values.hasActiveEffect(), commands.hasActiveEffect());
+        }
+
+        if (!values.hasActiveEffect()) {
+            continue;
+        }
+        commands.updateActiveEffect({4, 5, 6}, fade / 2);
+        values.updateActiveEffect({4, 5, 6}, fade / 2);
+        for (int frame = 0; frame < 50; frame++) {
+            ASSERT_EQ(values.update(FRAME), commands.update(FRAME))
+                << "effect " << idx << " reconfigured, frame " << frame;
+        }
+    }
+}
+
+TEST_F(EffectsTest, ValueEffectsPlaybackDoesNotAllocate) {
+    core::ValueEffectsEngine engine;
+    engine.addEffect(core::RainbowEffect(std::chrono::milliseconds(50)));
+    engine.addEffect(core::RainbowFadeEffect(std::chrono::milliseconds(50)));
+
+    for (std::size_t idx = 0; idx < engine.getEffectCount(); idx++) {
+        engine.setActiveEffect(idx);
+        EXPECT_EQ(allocationsDuring(engine, 1000), 0) << "effect " << idx;
+    }
+}
+
+TEST_F(EffectsTest, SpinRendersEveryLed) {
+    constexpr std::size_t const FAN_LEDS = 6;
+    sys::ColorBuffer frame(2, 3, FAN_LEDS);
+    core::EffectsEngine engine;
+    auto composite = std::make_unique<core::CompositeCommand>();
+    composite->addCommand(
+        std::make_unique<core::RainbowSpinCommand>(std::chrono::seconds(1)));
+    engine.addEffect(std::move(composite));
+    engine.setActiveEffect(0);
+
+    // Inside a composite too, the spin colors each LED of each fan
+    ASSERT_TRUE(engine.render(std::chrono::milliseconds(500), frame));
+    for (std::size_t c = 0; c < frame.controllersNum(); c++) {
+        for (std::size_t f = 0; f < frame.fansNum(); f++) {
+            for (std::size_t led = 0; led < FAN_LEDS; led++) {
+                EXPECT_EQ(frame(c, f, led),
+                          core::hueToGrb(static_cast<double>(led) / FAN_LEDS))
+                    << "Controller " << c << " fan " << f << " LED " << led;
+            }
+        }
+    }
+    EXPECT_EQ(frame(0, 0, 0), (sys::LedColor{0, 255, 0})) << "Red in GRB";
+
+    // Half a turn later the ring has moved by half of the fan
+    engine.render(std::chrono::milliseconds(500), frame);
+    EXPECT_EQ(frame(1, 2, 0), core::hueToGrb(0.5));
+    EXPECT_EQ(frame(1, 2, FAN_LEDS / 2), core::hueToGrb(0.0));
+
+    // Single color effects still fill the whole frame
+    engine.addEffect(std::make_unique<core::StaticColorCommand>(
+        1, 2, 3, std::chrono::hours(1)));
+    engine.setActiveEffect(1);
+    engine.render(FRAME, frame);
+    EXPECT_EQ(frame.all().back(), (sys::LedColor{1, 2, 3}));
+}
+
+TEST_F(EffectsTest, FrameIsOneAlignedBlock) {
+    sys::ColorBuffer frame(2, 5, 54);
+    ASSERT_EQ(frame.all().size(), 2 * 5 * 54);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(frame.all().data()) %  // NOLINT
+                  COLOR_BUFFER_ALIGNMENT,
+              0);
+
+    // Controller after controller, fan after fan
+    frame(1, 2, 3) = {7, 8, 9};
+    EXPECT_EQ(frame.fan(1, 2).data(), frame.all().data() + (5 + 2) * 54);
+    EXPECT_EQ(frame.fan(1, 2)[3], (sys::LedColor{7, 8, 9}));
+    EXPECT_EQ(frame.controller(1)[2 * 54 + 3], (sys::LedColor{7, 8, 9}));
+
+    // Publishing a frame copies into storage of the same shape
+    std::size_t before = allocations;
+    sys::ColorBuffer copy(2, 5, 54);
+    ASSERT_EQ(allocations - before, 1);
+    auto const* storage = copy.all().data();
+    before = allocations;
+    copy = frame;
+    EXPECT_EQ(allocations - before, 0);
+    EXPECT_EQ(copy.all().data(), storage);
+    EXPECT_EQ(copy(1, 2, 3), (sys::LedColor{7, 8, 9}));
+}
@@ -2,7 +2,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -15,7 +17,6 @@ using ::testing::_;
 
 using STATS = std::pair<std::size_t, std::size_t>;
 using COLOR = std::array<float, 3>;
-using COLOR_BUFFER = std::vector<std::vector<std::array<float, 3>>>;
 
 // Минимальные фейковые реализации для тестирования (если они не определены в
 // system/config.hpp) Ниже приведён упрощённый пример; в реальном проекте эти
@@ -24,13 +25,28 @@ using COLOR_BUFFER = std::vector<std::vector<std::array<float, 3>>>;
 class MockHidWrapper : public sys::DeviceController {
    public:
     MOCK_METHOD(STATS, sentToFan,
+                (std::size_t controller_idx, std::size_t fan_idx, uint value));
+    MOCK_METHOD(void, setRGB,
+                (std::size_t controller_idx, std::size_t fan_idx, COLOR& colors));
+    MOCK_METHOD(sys::ColorBuffer, makeColorBuffer, (), (override));
+    MOCK_METHOD(void, queueFanSpeed,
                 (std::size_t controller_idx, std::size_t fan_idx, uint value),
                 (override));
-    MOCK_METHOD(void, setRGB,
-                (std::size_t controller_idx, std::size_t fan_idx, COLOR& colors),
+    MOCK_METHOD(std::size_t, controllersNum, (), (override));
+    MOCK_METHOD(std::size_t, channelsNum, (), (override));
+    MOCK_METHOD(void, queueFanStatus,
+                (std::size_t controller_idx, std::size_t fan_idx), (override));
+    MOCK_METHOD(bool, queueRGB,
+                (std::size_t controller_idx, std::size_t fan_idx,
+                 std::span<sys::LedColor const> colors),
+                (override));
+    MOCK_METHOD(uint64_t, colorDrops,
+                (std::size_t controller_idx, std::size_t fan_idx),
+                (override));
+    MOCK_METHOD(void, flush, (std::size_t controller_idx), (override));
+    MOCK_METHOD(std::size_t, queueDepth, (std::size_t controller_idx),
                 (override));
-    MOCK_METHOD(COLOR_BUFFER, makeColorBuffer,
-                (), (override) );   
+    MOCK_METHOD(void, setStatusHandler, (StatusHandler handler), (override));
 };
 
 class MockFanMediator : public core::Mediator {
@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+
+#include "system/fanTelemetry.hpp"
+
+TEST(FanTelemetryTest, ReturnsLatestSampleOfEachFan) {
+    sys::FanTelemetry telemetry(2, 5);
+
+    EXPECT_FALSE(telemetry.load(1, 4).valid) << "Nothing polled yet";
+
+    telemetry.store(1, 4, 50, 1200);
+    telemetry.store(1, 4, 70, 1650);
+    telemetry.store(0, 0, 100, 2000);
+
+    auto sample = telemetry.load(1, 4);
+    EXPECT_TRUE(sample.valid);
+    EXPECT_EQ(sample.speed, 70);
+    EXPECT_EQ(sample.rpm, 1650);
+    EXPECT_EQ(telemetry.load(0, 0).rpm, 2000);
+    EXPECT_FALSE(telemetry.load(0, 1).valid);
+}
+
+TEST(FanTelemetryTest, IgnoresOutOfRangeFans) {
+    sys::FanTelemetry telemetry(1, 5);
+
+    telemetry.store(1, 0, 50, 1200);
+    telemetry.store(0, 5, 50, 1200);
+
+    EXPECT_FALSE(telemetry.load(1, 0).valid);
+    EXPECT_FALSE(telemetry.load(0, 5).valid);
+}
+
+TEST(FanTelemetryTest, GenerationMovesOnlyOnChange) {
+    sys::FanTelemetry telemetry(1, 5);
+    auto start = telemetry.generation();
+
+    telemetry.store(0, 2, 50, 1200);
+    telemetry.store(0, 2, 50, 1200);
+    EXPECT_EQ(telemetry.generation(), start + 1) << "Same sample twice";
+
+    telemetry.store(0, 2, 50, 1210);
+    EXPECT_EQ(telemetry.generation(), start + 2);
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "core/frameClock.hpp"
+
+namespace {
+
+constexpr std::chrono::milliseconds const PERIOD = std::chrono::milliseconds(10);
+
+}  // namespace
+
+TEST(FrameClockTest, WorkDoesNotDelayDeadlines) {
+    auto start = core::FrameClock::Clock::now();
+    core::FrameClock clock(PERIOD);
+    core::FrameClock::Clock::duration advanced{};
+
+    // Frames that take a third of their period to render
+    for (int i = 0; i < 20; i++) {
+        advanced += clock.wait();
+        std::this_thread::sleep_for(std::chrono::milliseconds(3));
+    }
+    advanced += clock.wait();
+    auto elapsed = core::FrameClock::Clock::now() - start;
+
+    // 21 deadlines one period apart, plus whole periods skipped when the
+    // test was not scheduled. With sleep_for after the work every frame
+    // would have taken 13 ms.
+    auto deadlines = 21 + static_cast<int64_t>(clock.missedFrames());
+    EXPECT_GE(elapsed, deadlines * PERIOD);
+    EXPECT_LT(elapsed, deadlines * (PERIOD + std::chrono::milliseconds(3)));
+    // The deltas add up to the real time from the clock's start to the
+    // last deadline
+    EXPECT_LE(advanced, elapsed);
+    EXPECT_GE(advanced, deadlines * PERIOD);
+    EXPECT_EQ(clock.frames(), 21);
+    EXPECT_EQ(clock.lateness()->count(), 21);
+}
+
+TEST(FrameClockTest, LateFramesSkipMissedDeadlines) {
+    // Long enough that a late wakeup on a busy machine stays well inside
+    // the half period between the stall's end and the next deadline
+    constexpr std::chrono::milliseconds const SLOW_PERIOD =
+        std::chrono::milliseconds(50);
+    core::FrameClock clock(SLOW_PERIOD);
+    clock.wait();
+
+    // A stall of three and a half periods
+    std::this_thread::sleep_for(SLOW_PERIOD * 7 / 2);
+    auto late = clock.wait();
+    EXPECT_GE(late, SLOW_PERIOD * 7 / 2);
+    EXPECT_GE(clock.missedFrames(), 2);
+    EXPECT_GE(clock.lateness()->percentile(1.0),
+              std::chrono::microseconds(2 * SLOW_PERIOD));
+
+    // Back on the grid instead of rushing through the missed frames
+    auto next = clock.wait();
+    EXPECT_GT(next, SLOW_PERIOD / 10);
+    EXPECT_LT(next, SLOW_PERIOD);
+}
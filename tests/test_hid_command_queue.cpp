@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+#include "system/hidCommandQueue.hpp"
+
+using namespace std::chrono_literals;
+
+class HidCommandQueueTest : public ::testing::Test {
+   protected:
+    sys::HidCommandQueue queue;                          // NOLINT
+    std::vector<sys::HidCommand> batch;                  // NOLINT
+    sys::HidCommandQueue::Clock::time_point now =        // NOLINT
+        sys::HidCommandQueue::Clock::now();
+};
+
+TEST_F(HidCommandQueueTest, CoalescesCommandsForSameFan) {
+    queue.pushSpeed(1, 30, now + 1s);
+    queue.pushSpeed(1, 60, now + 1s);
+    queue.pushColor(1, {1, 2, 3}, now + 1s);
+    queue.pushColor(1, {4, 5, 6}, now + 1s);
+
+    EXPECT_EQ(queue.depth(), 2);
+
+    queue.takeBatch(now, batch);
+
+    ASSERT_EQ(batch.size(), 2);
+    EXPECT_EQ(batch[0].speed, 60) << "Newest speed must win";
+    EXPECT_EQ(batch[1].colors[0], (sys::LedColor{4, 5, 6}))
+        << "Newest color must win";
+    EXPECT_EQ(queue.depth(), 0) << "Queue must be empty after batch taken";
+}
+
+TEST_F(HidCommandQueueTest, SpeedsGoBeforeColors) {
+    queue.pushColor(1, {1, 2, 3}, now + 1s);
+    queue.pushColor(2, {1, 2, 3}, now + 1s);
+    queue.pushSpeed(3, 50, now + 1s);
+
+    queue.takeBatch(now, batch);
+
+    ASSERT_EQ(batch.size(), 3);
+    EXPECT_EQ(batch[0].type, sys::HidCommandType::SPEED);
+    EXPECT_EQ(batch[1].type, sys::HidCommandType::RGB);
+    EXPECT_EQ(batch[2].type, sys::HidCommandType::RGB);
+}
+
+TEST_F(HidCommandQueueTest, StatusReadsGoBetweenSpeedsAndColors) {
+    queue.pushColor(1, {1, 2, 3}, now + 1s);
+    queue.pushStatus(2, now + 1s);
+    queue.pushStatus(2, now + 1s);
+    queue.pushSpeed(3, 50, now + 1s);
+
+    EXPECT_EQ(queue.statusDepth(), 1) << "Status reads must be coalesced";
+
+    queue.takeBatch(now, batch);
+
+    ASSERT_EQ(batch.size(), 3);
+    EXPECT_EQ(batch[0].type, sys::HidCommandType::SPEED);
+    EXPECT_EQ(batch[1].type, sys::HidCommandType::STATUS);
+    EXPECT_EQ(batch[2].type, sys::HidCommandType::RGB);
+}
+
+TEST_F(HidCommandQueueTest, ExpiredColorsDroppedAndLateSpeedsKept) {
+    queue.pushColor(1, {1, 2, 3}, now - 1ms);
+    queue.pushColor(2, {1, 2, 3}, now + 1s);
+    queue.pushSpeed(1, 50, now - 1ms);
+
+    queue.takeBatch(now, batch);
+
+    ASSERT_EQ(batch.size(), 2);
+    EXPECT_EQ(batch[0].type, sys::HidCommandType::SPEED);
+    EXPECT_EQ(batch[1].fan_idx, 2);
+    EXPECT_EQ(queue.droppedColors(), 1);
+    EXPECT_EQ(queue.droppedFans(), std::vector<std::size_t>{1});
+    EXPECT_EQ(queue.lateSpeeds(), 1);
+}
@@ -0,0 +1,21 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+
+#include "system/hidStats.hpp"
+
+TEST(HidStatsTest, SummaryReportsEveryCounter) {
+    sys::HidStats stats;
+    for (int i = 0; i < 99; i++) {
+        stats.write.record(std::chrono::microseconds(60));
+    }
+    stats.write.record(std::chrono::milliseconds(3));
+    stats.read.record(std::chrono::milliseconds(250));
+    stats.timeouts++;
+    stats.protocol_failures += 2;
+
+    EXPECT_EQ(sys::summarize(stats),
+              "write p50 64us p99 64us n=100 | read p50 262144us p99 262144us "
+              "n=1 | timeouts 1 | protocol failures 2 | I/O errors 0");
+}
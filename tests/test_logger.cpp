@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/logger.hpp"
+
+class LoggerTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        path = std::filesystem::temp_directory_path() /
+               ("logger_test_" + std::to_string(::getpid()));
+        core::Logger::log.enableConsoleLogging(false);
+        core::Logger::log.setLogFile(path);
+    }
+    void TearDown() override {
+        core::Logger::log.disableAsync();
+        core::Logger::log.setLogFile("");
+        core::Logger::log.enableConsoleLogging(true);
+        std::filesystem::remove(path);
+    }
+
+    std::vector<std::string> lines() const {
+        std::ifstream in(path);
+        std::vector<std::string> result;
+        for (std::string l; std::getline(in, l);) {
+            result.push_back(l);
+        }
+        return result;
+    }
+
+    std::filesystem::path path;  // NOLINT
+};
+
+TEST_F(LoggerTest, AsyncWriterKeepsWholeLinesFromAllThreads) {
+    constexpr int const THREADS = 4;
+    constexpr int const LINES = 200;
+
+    core::Logger::log.enableAsync(4096, core::LogOverflowPolicy::BLOCK);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < THREADS; t++) {
+        producers.emplace_back([t]() {
+            for (int i = 0; i < LINES; i++) {
+                core::Logger::log(core::LogLevel::WARNING)
+                    << "thread " << t << " line " << i << std::endl;
+            }
+        });
+    }
+    for (auto& p : producers) {
+        p.join();
+    }
+    core::Logger::log.disableAsync();
+
+    auto written = lines();
+    ASSERT_EQ(written.size(), THREADS * LINES);
+    for (auto const& l : written) {
+        EXPECT_NE(l.find("[WARNING] thread "), std::string::npos) << l;
+    }
+}
+
+TEST_F(LoggerTest, DropPolicyCountsLostRecords) {
+    constexpr int const LINES = 2000;
+    std::size_t dropped_before = core::Logger::log.droppedRecords();
+
+    core::Logger::log.enableAsync(2, core::LogOverflowPolicy::DROP);
+    for (int i = 0; i < LINES; i++) {
+        core::Logger::log(core::LogLevel::ERROR) << "burst " << i << std::endl;
+    }
+    core::Logger::log.disableAsync();
+
+    std::size_t dropped = core::Logger::log.droppedRecords() - dropped_before;
+    EXPECT_EQ(lines().size() + dropped, LINES);
+}
+
+TEST_F(LoggerTest, SyncModeWritesFormattedLine) {
+    core::Logger::log(core::LogLevel::ERROR)
+        << "value " << 42 << ' ' << 1.5 << std::endl;
+
+    auto written = lines();
+    ASSERT_EQ(written.size(), 1);
+    EXPECT_NE(written[0].find("[ERROR] value 42 1.5"), std::string::npos)
+        << written[0];
+}
+
+TEST_F(LoggerTest, DisabledStatementsDoNotEvaluateArguments) {
+    int evaluated = 0;
+    auto count = [&evaluated]() { return ++evaluated; };
+
+    core::Logger::log.setModuleLevel(core::LogModule::HID,
+                                     core::LogLevel::ERROR);
+    LOG_WARNING(core::LogModule::HID) << "hid " << count() << std::endl;
+    LOG_INFO(core::LogModule::CORE) << "core " << count() << std::endl;
+    LOG_WARNING(core::LogModule::CORE) << "core " << count() << std::endl;
+    core::Logger::log.setModuleLevel(core::LogModule::HID,
+                                     core::COMPILED_LOG_LEVEL);
+
+    int expected = core::compiledIn(core::LogLevel::INFO) ? 2 : 1;
+    EXPECT_EQ(evaluated, expected);
+    EXPECT_EQ(lines().size(), expected);
+}
+
+TEST_F(LoggerTest, LongLinesAreWrittenWhole) {
+    std::string const long_text(core::LOG_RECORD_TEXT_SIZE * 2, 'x');
+
+    core::Logger::log.enableAsync(64, core::LogOverflowPolicy::BLOCK);
+    core::Logger::log(core::LogLevel::ERROR) << "before" << std::endl;
+    core::Logger::log(core::LogLevel::ERROR) << long_text << std::endl;
+    core::Logger::log(core::LogLevel::ERROR) << "after" << std::endl;
+    core::Logger::log.disableAsync();
+
+    auto written = lines();
+    ASSERT_EQ(written.size(), 3);
+    EXPECT_NE(written[0].find("before"), std::string::npos);
+    EXPECT_NE(written[1].find(long_text), std::string::npos);
+    EXPECT_NE(written[2].find("after"), std::string::npos);
+}
+
+TEST_F(LoggerTest, LinesRacingWithDisableAreNotLost) {
+    constexpr int const THREADS = 4;
+    constexpr int const LINES = 2000;
+
+    core::Logger::log.enableAsync(4096, core::LogOverflowPolicy::BLOCK);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < THREADS; t++) {
+        producers.emplace_back([t]() {
+            for (int i = 0; i < LINES; i++) {
+                core::Logger::log(core::LogLevel::WARNING)
+                    << "thread " << t << " line " << i << std::endl;
+            }
+        });
+    }
+    core::Logger::log.disableAsync();
+    for (auto& p : producers) {
+        p.join();
+    }
+
+    EXPECT_EQ(lines().size(), THREADS * LINES);
+}
@@ -0,0 +1,173 @@
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "system/latencyHistogram.hpp"
+#include "system/metricsExporter.hpp"
+#include "system/telemetrySink.hpp"
+
+namespace {
+
+auto scrape(uint16_t port, std::string const& path) -> std::string {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr),  // NOLINT
+                sizeof(addr)) != 0) {
+        close(fd);
+        return "";
+    }
+
+    std::string request =
+        "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    send(fd, request.data(), request.size(), 0);
+    std::string response;
+    std::array<char, 4096> chunk{};
+    ssize_t n = 0;
+    while ((n = recv(fd, chunk.data(), chunk.size(), 0)) > 0) {
+        response.append(chunk.data(), n);
+    }
+    close(fd);
+    return response;
+}
+
+auto line(std::string const& page, std::string const& series) -> std::string {
+    auto pos = page.find("\n" + series + " ");
+    if (pos == std::string::npos) {
+        return "";
+    }
+    return page.substr(pos + 1, page.find('\n', pos + 1) - pos - 1);
+}
+
+auto value(std::string const& page, std::string const& series) -> double {
+    std::string l = line(page, series);
+    return l.empty() ? -1 : std::stod(l.substr(series.size() + 1));
+}
+
+}  // namespace
+
+TEST(LatencyHistogramTest, BucketsAreLogLinear) {
+    EXPECT_EQ(sys::LatencyHistogram::bucketIndex(0), 0);
+    EXPECT_EQ(sys::LatencyHistogram::bucketIndex(3), 3);
+    EXPECT_EQ(sys::LatencyHistogram::bucketIndex(4), 4);
+    EXPECT_EQ(sys::LatencyHistogram::bucketIndex(9), 8);
+    EXPECT_EQ(sys::LatencyHistogram::bucketIndex(15), 11);
+    EXPECT_EQ(sys::LatencyHistogram::bucketIndex(16), 12);
+    EXPECT_EQ(sys::LatencyHistogram::bucketIndex(UINT64_MAX),
+              HISTOGRAM_BUCKETS - 1);
+
+    // Every value lies below the limit of its bucket and at or above the
+    // limit of the previous one
+    for (uint64_t us = 1; us < 100000; us += 7) {
+        auto idx = sys::LatencyHistogram::bucketIndex(us);
+        EXPECT_LT(us, sys::LatencyHistogram::bucketLimit(idx));
+        EXPECT_GE(us, sys::LatencyHistogram::bucketLimit(idx - 1));
+    }
+}
+
+TEST(LatencyHistogramTest, CountsAndPercentiles) {
+    sys::LatencyHistogram histogram;
+    for (int i = 0; i < 90; i++) {
+        histogram.record(std::chrono::microseconds(100));
+    }
+    for (int i = 0; i < 10; i++) {
+        histogram.record(std::chrono::milliseconds(5));
+    }
+
+    EXPECT_EQ(histogram.count(), 100);
+    EXPECT_EQ(histogram.sum(), std::chrono::microseconds(90 * 100 + 10 * 5000));
+    EXPECT_EQ(histogram.countAtMost(std::chrono::microseconds(128)), 90);
+    EXPECT_EQ(histogram.countAtMost(std::chrono::microseconds(8192)), 100);
+    EXPECT_EQ(histogram.percentile(0.5), std::chrono::microseconds(112));
+    EXPECT_EQ(histogram.percentile(0.99), std::chrono::microseconds(5120));
+}
+
+TEST(LatencyHistogramTest, BoundIsInclusive) {
+    sys::LatencyHistogram histogram;
+    histogram.record(std::chrono::microseconds(128));
+    histogram.record(std::chrono::microseconds(128) +
+                     std::chrono::nanoseconds(1));
+
+    EXPECT_EQ(histogram.countAtMost(std::chrono::microseconds(127)), 0);
+    EXPECT_EQ(histogram.countAtMost(std::chrono::microseconds(128)), 1);
+    EXPECT_EQ(histogram.countAtMost(std::chrono::microseconds(256)), 2);
+}
+
+TEST(MetricsExporterTest, UpdatesValuesInPlace) {
+    sys::MetricsExporter exporter(0, 1, 2);
+    auto histogram = std::make_shared<sys::LatencyHistogram>();
+    double errors = 0;
+    exporter.addHistogram("tt_hid_roundtrip_seconds", "Round trip",
+                          "controller=\"0\"", histogram);
+    exporter.addCounter("tt_hid_errors", "Errors", "controller=\"0\"",
+                        [&errors] { return errors; });
+
+    std::string before = exporter.render();
+    EXPECT_TRUE(before.starts_with("# TYPE tt_temperature_celsius gauge\n"));
+    EXPECT_TRUE(before.ends_with("# EOF\n"));
+    EXPECT_NE(before.find("# TYPE tt_hid_errors counter\n"), std::string::npos);
+
+    exporter.publishTemperatures(42.5F, 61.0F);
+    exporter.publishTarget(0, 1, 70.0F);
+    exporter.publishStatus(0, 1, 68, 1650);
+    exporter.publishStatus(3, 0, 1, 1);
+    histogram->record(std::chrono::microseconds(100));
+    errors = 3;
+
+    std::string after = exporter.render();
+    EXPECT_EQ(after.size(), before.size());
+    EXPECT_EQ(line(after, "tt_temperature_celsius{sensor=\"cpu\"}"),
+              "tt_temperature_celsius{sensor=\"cpu\"} "
+              "0000000000000000000042.5");
+    EXPECT_EQ(value(after, "tt_fan_target_speed_percent{controller=\"0\","
+                           "fan=\"1\"}"),
+              70);
+    EXPECT_EQ(value(after, "tt_fan_rpm{controller=\"0\",fan=\"1\"}"), 1650);
+    EXPECT_EQ(value(after, "tt_hid_errors_total{controller=\"0\"}"), 3);
+    EXPECT_EQ(value(after, "tt_hid_roundtrip_seconds_bucket{controller=\"0\","
+                           "le=\"6.4e-05\"}"),
+              0);
+    EXPECT_EQ(value(after, "tt_hid_roundtrip_seconds_bucket{controller=\"0\","
+                           "le=\"0.000128\"}"),
+              1);
+    EXPECT_EQ(value(after, "tt_hid_roundtrip_seconds_count{controller=\"0\"}"),
+              1);
+}
+
+TEST(MetricsExporterTest, ServesMetricsOverHttp) {
+    sys::MetricsExporter exporter(0, 1, 5);
+    exporter.start();
+    ASSERT_NE(exporter.port(), 0);
+
+    std::string response = scrape(exporter.port(), "/metrics");
+    EXPECT_TRUE(response.starts_with("HTTP/1.1 200 OK\r\n"));
+    EXPECT_NE(response.find(METRICS_CONTENT_TYPE), std::string::npos);
+    EXPECT_TRUE(response.ends_with("# EOF\n"));
+
+    EXPECT_TRUE(scrape(exporter.port(), "/").starts_with("HTTP/1.1 404"));
+}
+
+TEST(TelemetrySinkTest, FanoutReachesEverySink) {
+    auto first = std::make_shared<sys::MetricsExporter>(0, 1, 1);
+    auto second = std::make_shared<sys::MetricsExporter>(0, 1, 1);
+    EXPECT_EQ(sys::combineSinks({nullptr, nullptr}), nullptr);
+    EXPECT_EQ(sys::combineSinks({nullptr, first}), first);
+
+    auto sink = sys::combineSinks({first, second});
+    sink->publishTemperatures(50.0F, 0.0F);
+    for (auto const& exporter : {first, second}) {
+        EXPECT_NE(exporter->render().find(
+                      "tt_temperature_celsius{sensor=\"cpu\"} "
+                      "0000000000000000000050.0"),
+                  std::string::npos);
+    }
+}
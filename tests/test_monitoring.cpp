@@ -1,6 +1,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <thread>
@@ -92,3 +93,130 @@ TEST(MonitoringTest, ReturnsCorrectNames) {
 
     monitoring.reset();
 }
+
+// Контроллер, температуру которого тест меняет во время работы.
+class ControlledCPUController : public sys::ICPUController {
+   public:
+    explicit ControlledCPUController(std::shared_ptr<std::atomic<int>> temp)
+        : temp(std::move(temp)) {}
+    bool readCpuTempFile(int& t) override {
+        t = temp->load();
+        return true;
+    }
+    std::string getCPUName() override { return "Controlled CPU"; }
+
+   private:
+    std::shared_ptr<std::atomic<int>> temp;
+};
+
+TEST(MonitoringTest, NotifiesOnlyOutsideDeadband) {
+    using namespace std::chrono_literals;
+    using ::testing::AllOf;
+    using ::testing::Field;
+
+    auto temp = std::make_shared<std::atomic<int>>(50);
+    auto observer = std::make_shared<MockObserver>();
+    auto cpu_event = [](float value) {
+        return AllOf(
+            Field(&core::Event::type, core::EventType::CPU_TEMP_CHANGED),
+            Field(&core::Event::value, value));
+    };
+
+    EXPECT_CALL(*observer,
+                onEvent(Field(&core::Event::type,
+                              core::EventType::GPU_TEMP_CHANGED)))
+        .Times(::testing::AnyNumber());
+    EXPECT_CALL(*observer, onEvent(cpu_event(50.0F))).Times(1);
+    EXPECT_CALL(*observer, onEvent(cpu_event(51.0F))).Times(0);
+    EXPECT_CALL(*observer, onEvent(cpu_event(53.0F))).Times(1);
+
+    sys::SamplingPolicy policy{10ms, 20ms, 0.5F, 2.0F};
+    auto monitoring = std::make_unique<sys::Monitoring>(
+        std::make_unique<ControlledCPUController>(temp),
+        std::make_unique<FakeGPUController>(60), 10ms, policy);
+    monitoring->addObserver(observer);
+
+    temp->store(51);
+    std::this_thread::sleep_for(100ms);
+    temp->store(53);
+    std::this_thread::sleep_for(100ms);
+
+    monitoring.reset();
+}
+
+TEST(MonitoringTest, RefreshNotifiesInsideDeadband) {
+    using namespace std::chrono_literals;
+    using ::testing::Field;
+
+    auto observer = std::make_shared<MockObserver>();
+    EXPECT_CALL(*observer,
+                onEvent(Field(&core::Event::type,
+                              core::EventType::GPU_TEMP_CHANGED)))
+        .Times(::testing::AnyNumber());
+    EXPECT_CALL(*observer,
+                onEvent(Field(&core::Event::type,
+                              core::EventType::CPU_TEMP_CHANGED)))
+        .Times(2);
+
+    // Idle sampling far beyond the test, only refresh() takes the sample
+    sys::SamplingPolicy policy{10s, 10s, 0.5F, 2.0F};
+    auto monitoring = std::make_unique<sys::Monitoring>(
+        std::make_unique<FakeCPUController>(50),
+        std::make_unique<FakeGPUController>(60), 10s, policy);
+    monitoring->addObserver(observer);
+
+    monitoring->refresh();
+    std::this_thread::sleep_for(100ms);
+
+    monitoring.reset();
+}
+
+TEST(MonitoringTest, ResendsStableReadingAfterMaxAge) {
+    using namespace std::chrono_literals;
+    using ::testing::Field;
+
+    auto observer = std::make_shared<MockObserver>();
+    EXPECT_CALL(*observer,
+                onEvent(Field(&core::Event::type,
+                              core::EventType::GPU_TEMP_CHANGED)))
+        .Times(::testing::AnyNumber());
+    EXPECT_CALL(*observer,
+                onEvent(Field(&core::Event::type,
+                              core::EventType::CPU_TEMP_CHANGED)))
+        .Times(::testing::AtLeast(3));
+
+    sys::SamplingPolicy policy{10ms, 10ms, 0.5F, 2.0F, 30ms};
+    auto monitoring = std::make_unique<sys::Monitoring>(
+        std::make_unique<FakeCPUController>(50),
+        std::make_unique<FakeGPUController>(60), 10ms, policy);
+    monitoring->addObserver(observer);
+
+    std::this_thread::sleep_for(300ms);
+
+    monitoring.reset();
+}
+
+TEST(MonitoringTest, BacksOffWhenStableAndSpeedsUpOnSpike) {
+    using namespace std::chrono_literals;
+
+    auto temp = std::make_shared<std::atomic<int>>(50);
+    sys::SamplingPolicy policy{20ms, 160ms, 0.5F, 1.0F};
+    auto monitoring = std::make_unique<sys::Monitoring>(
+        std::make_unique<ControlledCPUController>(temp),
+        std::make_unique<FakeGPUController>(60), 20ms, policy);
+
+    std::this_thread::sleep_for(500ms);
+    EXPECT_EQ(monitoring->currentInterval(), 160ms)
+        << "Stable readings must back off to the idle interval";
+
+    temp->store(80);
+    bool fast = false;
+    auto deadline = std::chrono::steady_clock::now() + 500ms;
+    while (!fast && std::chrono::steady_clock::now() < deadline) {
+        fast = monitoring->currentInterval() == 20ms;
+        std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_TRUE(fast) << "A temperature spike must switch to fast sampling";
+
+    monitoring.reset();
+}
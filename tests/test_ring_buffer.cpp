@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "core/ringBuffer.hpp"
+
+TEST(RingBufferTest, KeepsFifoOrderAndRejectsWhenFull) {
+    core::RingBuffer<int> ring(3);
+
+    ASSERT_EQ(ring.capacity(), 4) << "Capacity is rounded up to power of two";
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(ring.tryPush(i));
+    }
+    EXPECT_FALSE(ring.tryPush(4));
+
+    int value = -1;
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(ring.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(ring.tryPop(value));
+}
+
+TEST(RingBufferTest, DeliversEveryItemFromConcurrentProducers) {
+    constexpr int const PRODUCERS = 4;
+    constexpr int const ITEMS = 10000;
+    core::RingBuffer<int> ring(64);
+    std::vector<std::thread> producers;
+
+    for (int p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&ring, p]() {
+            for (int i = 0; i < ITEMS; i++) {
+                while (!ring.tryPush(p * ITEMS + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<bool> seen(PRODUCERS * ITEMS, false);
+    std::vector<int> last(PRODUCERS, -1);
+    int value = 0;
+    for (int received = 0; received < PRODUCERS * ITEMS;) {
+        if (!ring.tryPop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        EXPECT_FALSE(seen[value]);
+        seen[value] = true;
+        EXPECT_GT(value % ITEMS, last[value / ITEMS])
+            << "Items of one producer must stay in order";
+        last[value / ITEMS] = value % ITEMS;
+        received++;
+    }
+
+    for (auto& t : producers) {
+        t.join();
+    }
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "system/fileUtils.hpp"
+#include "system/sensorReader.hpp"
+
+class SensorReaderTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        path = std::filesystem::temp_directory_path() /
+               ("sensor_reader_test_" + std::to_string(::getpid()));
+    }
+    void TearDown() override { std::filesystem::remove(path); }
+
+    void write(std::string const& content) const {
+        std::ofstream out(path, std::ios::trunc);
+        out << content;
+    }
+
+    std::filesystem::path path;  // NOLINT
+};
+
+TEST_F(SensorReaderTest, RereadsValueFromOpenDescriptor) {
+    write("45000\n");
+    sys::SensorReader reader(path);
+    ASSERT_TRUE(reader.isOpen());
+
+    long value = 0;
+    ASSERT_TRUE(reader.readInt(value));
+    EXPECT_EQ(value, 45000);
+
+    write("51250\n");
+    ASSERT_TRUE(reader.readInt(value));
+    EXPECT_EQ(value, 51250) << "Every read must start from offset 0";
+}
+
+TEST_F(SensorReaderTest, FailsOnMissingOrGarbageInput) {
+    sys::SensorReader missing(path.string() + "_missing");
+    long value = 0;
+    EXPECT_FALSE(missing.isOpen());
+    EXPECT_FALSE(missing.readInt(value));
+
+    write("n/a\n");
+    sys::SensorReader garbage(path);
+    EXPECT_FALSE(garbage.readInt(value));
+}
+
+TEST_F(SensorReaderTest, ReadLineReturnsFirstLine) {
+    write("amdgpu\nsecond\n");
+    EXPECT_EQ(readLine(path), "amdgpu");
+    EXPECT_EQ(readLine(path.string() + "_missing"), "");
+}
@@ -0,0 +1,251 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/commands/rainbowSpinCommand.hpp"
+#include "core/commands/staticColorCommand.hpp"
+#include "core/effectsEngine.hpp"
+#include "core/fanController.hpp"
+#include "system/controllers/simulatedRiingQuad.hpp"
+#include "system/controllers/ttRiingQuadController.hpp"
+
+namespace {
+
+auto fastProfile() -> sys::SimulationProfile {
+    sys::SimulationProfile profile;
+    profile.write_latency = std::chrono::microseconds(0);
+    profile.response_latency = std::chrono::microseconds(100);
+    profile.latency_jitter = std::chrono::microseconds(0);
+    profile.spin_time_constant = std::chrono::milliseconds(50);
+    return profile;
+}
+
+auto eventually(std::function<bool()> const& condition) -> bool {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (condition()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return condition();
+}
+
+}  // namespace
+
+TEST(SimulatedRiingQuadTest, AnswersTheProtocol) {
+    sys::SimulatedRiingQuad device(fastProfile());
+    std::array<unsigned char, TT_RIING_QUAD_PACKET_SIZE> out{};
+    std::array<unsigned char, TT_RIING_QUAD_PACKET_SIZE> in{};
+
+    // Commands before init are refused
+    out = {0x00, sys::PROTOCOL_SET, sys::PROTOCOL_FAN, 1, 0x01, 50};
+    ASSERT_EQ(device.write(out.data(), out.size()), out.size());
+    ASSERT_EQ(device.read(in.data(), in.size(), 100), in.size());
+    EXPECT_EQ(in[sys::PROTOCOL_STATUS_BYTE], sys::PROTOCOL_FAIL);
+
+    out = {0x00, sys::PROTOCOL_INIT, sys::PROTOCOL_GET};
+    device.write(out.data(), out.size());
+    device.read(in.data(), in.size(), 100);
+    EXPECT_EQ(in[sys::PROTOCOL_STATUS_BYTE], sys::PROTOCOL_SUCCESS);
+
+    out = {0x00, sys::PROTOCOL_SET, sys::PROTOCOL_FAN, 2, 0x01, 120};
+    device.write(out.data(), out.size());
+    device.read(in.data(), in.size(), 100);
+    EXPECT_EQ(in[sys::PROTOCOL_STATUS_BYTE], sys::PROTOCOL_SUCCESS);
+    EXPECT_EQ(device.speed(1), 100) << "Speed is clamped to percent";
+
+    out = {0x00, sys::PROTOCOL_SET, sys::PROTOCOL_LIGHT, 3, 0x24, 1, 2, 3};
+    device.write(out.data(), out.size());
+    device.read(in.data(), in.size(), 100);
+    EXPECT_EQ(device.color(2), (std::array<uint8_t, 3>{1, 2, 3}));
+
+    // Nothing written, nothing to read
+    EXPECT_EQ(device.read(in.data(), in.size(), 10), 0);
+    EXPECT_EQ(device.commands(), 4);
+}
+
+TEST(SimulatedRiingQuadTest, ControllerDrivesSimulatedFans) {
+    auto hidapi = std::make_unique<sys::SimulatedHidApi>(2, fastProfile());
+    auto second = hidapi->device(1);
+    sys::TTRiingQuadController controller(std::move(hidapi));
+    ASSERT_EQ(controller.controllersNum(), 2);
+    EXPECT_TRUE(second->initialized());
+
+    std::mutex lock;
+    std::vector<sys::FanStatus> statuses;
+    controller.setStatusHandler(
+        [&](std::size_t controller_idx, sys::FanStatus const& status) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (controller_idx == 1) {
+                statuses.push_back(status);
+            }
+        });
+
+    controller.queueFanSpeed(1, 3, 80);
+    controller.flush(1);
+    ASSERT_TRUE(eventually([&] { return second->speed(2) == 80; }));
+
+    // The fan spins up towards 80% of 1500 RPM instead of jumping there
+    ASSERT_TRUE(eventually([&] { return second->rpm(2) > 1100; }));
+    controller.queueFanStatus(1, 3);
+    controller.flush(1);
+    ASSERT_TRUE(eventually([&] {
+        std::lock_guard<std::mutex> guard(lock);
+        return !statuses.empty();
+    }));
+
+    std::lock_guard<std::mutex> guard(lock);
+    EXPECT_EQ(statuses[0].fan_idx, 3);
+    EXPECT_EQ(statuses[0].speed, 80);
+    EXPECT_GT(statuses[0].rpm, 1100);
+    EXPECT_LE(statuses[0].rpm, 1200);
+    EXPECT_GT(controller.hidStats(1).write.count(), 0);
+}
+
+TEST(SimulatedRiingQuadTest, InjectedFailuresShowUpInStatistics) {
+    auto profile = fastProfile();
+    profile.protocol_fail_rate = 1.0;
+    sys::TTRiingQuadController failing(
+        std::make_unique<sys::SimulatedHidApi>(1, profile));
+    failing.queueFanSpeed(0, 1, 50);
+    failing.flush(0);
+    EXPECT_TRUE(eventually(
+        [&] { return failing.hidStats(0).protocol_failures.load() == 1; }));
+
+    profile.protocol_fail_rate = 0.0;
+    profile.drop_rate = 1.0;
+    sys::TTRiingQuadController silent(
+        std::make_unique<sys::SimulatedHidApi>(1, profile));
+    uint64_t after_init = silent.hidStats(0).timeouts.load();
+    EXPECT_EQ(after_init, 1) << "Even the init answer got lost";
+    silent.queueFanStatus(0, 1);
+    silent.flush(0);
+    EXPECT_TRUE(eventually(
+        [&] { return silent.hidStats(0).timeouts.load() == after_init + 1; }));
+}
+
+TEST(SimulatedRiingQuadTest, LateAnswersAreNotTakenForLaterCommands) {
+    auto profile = fastProfile();
+    // Every answer arrives after the read waiting for it gave up
+    profile.response_latency =
+        std::chrono::milliseconds(TT_RIING_QUAD_TIMEOUT + 50);
+    auto hidapi = std::make_unique<sys::SimulatedHidApi>(1, profile);
+    auto device = hidapi->device(0);
+    sys::TTRiingQuadController controller(std::move(hidapi));
+
+    std::mutex lock;
+    std::vector<sys::FanStatus> statuses;
+    controller.setStatusHandler(
+        [&](std::size_t /*controller_idx*/, sys::FanStatus const& status) {
+            std::lock_guard<std::mutex> guard(lock);
+            statuses.push_back(status);
+        });
+
+    controller.queueFanSpeed(0, 1, 80);
+    for (std::size_t fan = 1; fan <= 3; fan++) {
+        controller.queueFanStatus(0, fan);
+    }
+    controller.flush(0);
+    // The init read and one per command
+    ASSERT_TRUE(
+        eventually([&] { return controller.hidStats(0).read.count() == 5; }));
+
+    EXPECT_GT(controller.hidStats(0).protocol_failures.load(), 0);
+    std::lock_guard<std::mutex> guard(lock);
+    for (auto const& status : statuses) {
+        EXPECT_EQ(status.speed, device->speed(status.fan_idx - 1))
+            << "Fan " << status.fan_idx;
+    }
+}
+
+TEST(SimulatedRiingQuadTest, EffectFramesArrivePerLed) {
+    auto hidapi = std::make_unique<sys::SimulatedHidApi>(1, fastProfile());
+    auto device = hidapi->device(0);
+    auto controller =
+        std::make_shared<sys::TTRiingQuadController>(std::move(hidapi));
+    auto engine = std::make_unique<core::EffectsEngine>();
+    engine->addEffect(
+        std::make_unique<core::RainbowSpinCommand>(std::chrono::seconds(60)));
+    engine->setActiveEffect(0);
+    core::FanController fc(std::make_shared<sys::System>(), controller,
+                           std::move(engine), true,
+                           std::chrono::milliseconds(10));
+
+    // Every LED of the last fan gets its own hue, half way round the ring
+    // is the opposite color
+    ASSERT_TRUE(eventually([&] {
+        auto leds = device->leds(TT_RIING_QUAD_NUM_CHANNELS - 1);
+        return leds[0] != leds[TT_RIING_QUAD_NUM_LEDS / 2];
+    }));
+    auto leds = device->leds(TT_RIING_QUAD_NUM_CHANNELS - 1);
+    EXPECT_NE(leds[0], leds[1]);
+    EXPECT_EQ(leds[0][1], core::MAX_CHANNEL_VALUE) << "Red first, in GRB";
+    EXPECT_EQ(leds[TT_RIING_QUAD_NUM_LEDS / 2][1], 0) << "Cyan has no red";
+}
+
+TEST(SimulatedRiingQuadTest, EffectsStartBetweenFrames) {
+    auto hidapi = std::make_unique<sys::SimulatedHidApi>(1, fastProfile());
+    auto device = hidapi->device(0);
+    auto controller =
+        std::make_shared<sys::TTRiingQuadController>(std::move(hidapi));
+    auto engine = std::make_unique<core::EffectsEngine>();
+    engine->addEffect(
+        std::make_unique<core::RainbowSpinCommand>(std::chrono::seconds(60)));
+    engine->addEffect(core::StaticColorCommand::makeStaticColorCommand(
+        0, 0, 0, std::chrono::seconds(0)));
+    engine->setActiveEffect(0);
+    core::FanController fc(std::make_shared<sys::System>(), controller,
+                           std::move(engine), true,
+                           std::chrono::milliseconds(10));
+
+    // Switched from this thread while the rainbow is rendering
+    for (uint8_t i = 1; i <= 50; i++) {
+        fc.updateEffect(i % 2, 60, {i, i, i});
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    fc.updateEffect(1, 60, {10, 20, 30});
+    EXPECT_TRUE(eventually([&] {
+        auto leds = device->leds(TT_RIING_QUAD_NUM_CHANNELS - 1);
+        return leds[0] == sys::LedColor{10, 20, 30} &&
+               leds[TT_RIING_QUAD_NUM_LEDS / 2] == sys::LedColor{10, 20, 30};
+    }));
+}
+
+TEST(SimulatedRiingQuadTest, LateColorsCountAsDroppedForTheirFan) {
+    sys::TTRiingQuadController controller(
+        std::make_unique<sys::SimulatedHidApi>(1, fastProfile()));
+    // Every color frame is past its deadline by the time the worker sees it
+    controller.setDeadlines(std::chrono::seconds(1),
+                            std::chrono::milliseconds(0));
+
+    std::vector<sys::LedColor> frame(TT_RIING_QUAD_NUM_LEDS, {1, 2, 3});
+    EXPECT_TRUE(controller.queueRGB(0, 2, frame));
+    controller.flush(0);
+    EXPECT_TRUE(eventually([&] { return controller.colorDrops(0, 2) == 1; }));
+    EXPECT_EQ(controller.colorDrops(0, 1), 0);
+    EXPECT_EQ(controller.droppedColors(0), 1);
+}
+
+TEST(SimulatedRiingQuadTest, ColorEditsReachTheDevice) {
+    auto hidapi = std::make_unique<sys::SimulatedHidApi>(1, fastProfile());
+    auto device = hidapi->device(0);
+    auto controller =
+        std::make_shared<sys::TTRiingQuadController>(std::move(hidapi));
+    core::FanController fc(std::make_shared<sys::System>(), controller,
+                           std::make_unique<core::EffectsEngine>(), true,
+                           std::chrono::milliseconds(10));
+
+    fc.updateFanColor(0, 2, {10, 20, 30}, false);
+    ASSERT_TRUE(eventually([&] {
+        return device->leds(2)[0] == sys::LedColor{10, 20, 30};
+    }));
+    EXPECT_EQ(device->leds(2)[TT_RIING_QUAD_NUM_LEDS - 1],
+              (sys::LedColor{10, 20, 30}));
+    EXPECT_NE(device->leds(1)[0], (sys::LedColor{10, 20, 30}));
+}
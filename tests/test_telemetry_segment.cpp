@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "system/telemetrySegment.hpp"
+
+namespace {
+
+auto segmentName() -> std::string {
+    return "/tt_riing_test_" + std::to_string(::getpid());
+}
+
+}  // namespace
+
+TEST(TelemetrySegmentTest, ReaderSeesPublishedValues) {
+    sys::TelemetrySegment segment(2, 5, segmentName());
+    segment.publishTemperatures(45.0F, 60.5F);
+    segment.publishTarget(1, 4, 70.0F);
+    segment.publishStatus(1, 4, 68, 1650);
+    segment.publishStatus(9, 0, 1, 1);
+
+    sys::TelemetrySegmentReader reader(segmentName());
+    auto snapshot = reader.read();
+    ASSERT_TRUE(snapshot.has_value());
+    EXPECT_EQ(snapshot->controllers, 2);
+    EXPECT_EQ(snapshot->channels, 5);
+    EXPECT_FLOAT_EQ(snapshot->cpu_temp, 45.0F);
+    EXPECT_FLOAT_EQ(snapshot->gpu_temp, 60.5F);
+    EXPECT_EQ(snapshot->sequence % 2, 0);
+
+    auto const& fan = snapshot->fans[1 * 5 + 4];
+    EXPECT_TRUE(fan.valid);
+    EXPECT_FLOAT_EQ(fan.target_speed, 70.0F);
+    EXPECT_EQ(fan.speed, 68);
+    EXPECT_EQ(fan.rpm, 1650);
+    EXPECT_FALSE(snapshot->fans[0].valid);
+}
+
+TEST(TelemetrySegmentTest, ReaderNeverSeesHalfWrittenUpdate) {
+    sys::TelemetrySegment segment(1, 5, segmentName());
+    sys::TelemetrySegmentReader reader(segmentName());
+    std::atomic<bool> done = false;
+
+    // Both temperatures always move together, a torn read would differ
+    std::thread writer([&]() {
+        for (int i = 0; i < 200000 && !done.load(); i++) {
+            auto t = static_cast<float>(i);
+            segment.publishTemperatures(t, t);
+        }
+        done.store(true);
+    });
+
+    int reads = 0;
+    while (!done.load()) {
+        auto snapshot = reader.read();
+        if (snapshot) {
+            ASSERT_EQ(snapshot->cpu_temp, snapshot->gpu_temp);
+            reads++;
+        }
+    }
+    writer.join();
+    EXPECT_GT(reads, 0);
+}
+
+TEST(TelemetrySegmentTest, SegmentIsRemovedWithItsOwner) {
+    { sys::TelemetrySegment segment(1, 5, segmentName()); }
+    EXPECT_THROW(sys::TelemetrySegmentReader{segmentName()},
+                 std::runtime_error);
+}
+
+TEST(TelemetrySegmentTest, SecondOwnerLeavesLiveSegmentAlone) {
+    sys::TelemetrySegment segment(1, 5, segmentName());
+    segment.publishTemperatures(45.0F, 60.0F);
+
+    EXPECT_THROW(sys::TelemetrySegment(1, 5, segmentName()),
+                 std::runtime_error);
+
+    sys::TelemetrySegmentReader reader(segmentName());
+    auto snapshot = reader.read();
+    ASSERT_TRUE(snapshot.has_value());
+    EXPECT_FLOAT_EQ(snapshot->cpu_temp, 45.0F) << "Segment was truncated";
+}
+
+TEST(TelemetrySegmentTest, SegmentOfDeadOwnerIsReplaced) {
+    // A child creates the segment and exits without cleaning up
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        auto* segment = new sys::TelemetrySegment(1, 5, segmentName());
+        segment->publishTemperatures(1.0F, 1.0F);
+        _exit(0);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+
+    sys::TelemetrySegment segment(2, 5, segmentName());
+    sys::TelemetrySegmentReader reader(segmentName());
+    auto snapshot = reader.read();
+    ASSERT_TRUE(snapshot.has_value());
+    EXPECT_EQ(snapshot->controllers, 2);
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "core/tripleBuffer.hpp"
+
+TEST(TripleBufferTest, ConsumerTakesNewestValue) {
+    core::TripleBuffer<int> buffer(0);
+    EXPECT_FALSE(buffer.update());
+    EXPECT_EQ(buffer.front(), 0);
+
+    buffer.back() = 1;
+    buffer.publish();
+    ASSERT_TRUE(buffer.update());
+    EXPECT_EQ(buffer.front(), 1);
+    EXPECT_FALSE(buffer.update()) << "Nothing new was published";
+    EXPECT_EQ(buffer.front(), 1);
+
+    // Published twice before the consumer looked
+    buffer.back() = 2;
+    buffer.publish();
+    buffer.back() = 3;
+    buffer.publish();
+    ASSERT_TRUE(buffer.update());
+    EXPECT_EQ(buffer.front(), 3);
+    EXPECT_EQ(buffer.overwritten(), 1);
+}
+
+TEST(TripleBufferTest, ConsumerNeverSeesTornFrames) {
+    constexpr std::size_t const FRAME_SIZE = 512;
+    constexpr int const FRAMES = 20000;
+    core::TripleBuffer<std::vector<int>> buffer{std::vector<int>(FRAME_SIZE)};
+
+    std::thread producer([&buffer] {
+        for (int i = 1; i <= FRAMES; i++) {
+            std::ranges::fill(buffer.back(), i);
+            buffer.publish();
+        }
+    });
+
+    int last = 0;
+    std::size_t received = 0;
+    while (last < FRAMES) {
+        if (!buffer.update()) {
+            continue;
+        }
+        auto const& frame = buffer.front();
+        ASSERT_TRUE(std::ranges::all_of(
+            frame, [&frame](int v) { return v == frame.front(); }))
+            << "Frame " << frame.front() << " is torn";
+        ASSERT_GT(frame.front(), last) << "Frames arrive in order";
+        last = frame.front();
+        received++;
+    }
+    producer.join();
+
+    // Every frame was either received or counted as overwritten
+    EXPECT_EQ(received + buffer.overwritten(), FRAMES);
+}